@@ -4,10 +4,64 @@
 
 // Entry point
 
-int main()
+// Usage: OpenGL3DRendering [--headless | --benchmark | --benchmark-lighting] [--frames count] [--size widthxheight] [--output file.png] [--no-output]
+static OpenGLRendering::ApplicationSettings ParseArguments(int argc, char** argv)
+{
+	OpenGLRendering::ApplicationSettings settings;
+	bool frameCountSet = false;
+
+	for (int i = 1; i < argc; i++)
+	{
+		std::string argument = argv[i];
+		bool hasValue = i + 1 < argc;
+
+		if (argument == "--headless")
+			settings.Headless = true;
+		else if (argument == "--benchmark")
+		{
+			settings.Headless = true;
+			settings.Benchmark = OpenGLRendering::BenchmarkType::AntiAliasing;
+		}
+		else if (argument == "--benchmark-lighting")
+		{
+			settings.Headless = true;
+			settings.Benchmark = OpenGLRendering::BenchmarkType::Lighting;
+		}
+		else if (argument == "--frames" && hasValue)
+		{
+			settings.FrameCount = (uint32_t)std::max(std::atoi(argv[++i]), 1);
+			frameCountSet = true;
+		}
+		else if (argument == "--size" && hasValue)
+		{
+			unsigned int width = 0, height = 0;
+			if (sscanf(argv[++i], "%ux%u", &width, &height) == 2 && width && height)
+			{
+				settings.Width = width;
+				settings.Height = height;
+			}
+			else
+				OGL_WARN("Invalid size {0}, expected widthxheight", argv[i]);
+		}
+		else if (argument == "--output" && hasValue)
+			settings.OutputPath = argv[++i];
+		else if (argument == "--no-output")
+			settings.OutputPath.clear();
+		else
+			OGL_WARN("Unknown argument {0}", argument);
+	}
+
+	// A single frame says nothing about throughput
+	if (settings.Benchmark != OpenGLRendering::BenchmarkType::None && !frameCountSet)
+		settings.FrameCount = 300;
+
+	return settings;
+}
+
+int main(int argc, char** argv)
 {
 	OpenGLRendering::Log::Init();
 
-	OpenGLRendering::ApplicationHandler handler;
+	OpenGLRendering::ApplicationHandler handler(ParseArguments(argc, argv));
 	handler.StartLoop();
-}
\ No newline at end of file
+}
@@ -10,13 +10,18 @@
 #include "Renderer/Texture.h"
 #include "Renderer/Cubemap.h"
 #include "Renderer/Renderer.h"
+#include "Core/HeadlessContext.h"
 
 #include "Utilities/MeshBuilder.h"
+#include "Utilities/ImageWriter.h"
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 #include <imgui.h>
 
+#include <chrono>
+#include <iomanip>
+
 
 // Defines for which model to render
 #define PISTOL 1
@@ -26,26 +31,59 @@ namespace OpenGLRendering {
 
 	ApplicationHandler* ApplicationHandler::s_Instance = nullptr;
 
-	ApplicationHandler::ApplicationHandler()
-		: m_Running(false), m_Sleeping(false)
+	ApplicationHandler::ApplicationHandler(const ApplicationSettings& settings)
+		: m_Running(false), m_Sleeping(false), m_Settings(settings)
 	{
 		OGL_ASSERT(!s_Instance, "Application already exists");
 		s_Instance = this;
 
-		WindowSettings settings("OpenGL3DRendering");
-		m_Window = CreateScope<Window>(settings);
-		m_Window->SetEventCallback(BIND_EVENT_FN(ApplicationHandler::OnEvent)); // All event functions get dispatched to ApplicationHandler::OnEvent
-		m_Window->SetVsync(true);
+		if (m_Settings.Headless)
+		{
+			m_HeadlessContext = CreateScope<HeadlessContext>();
+			m_HeadlessContext->Init();
+
+			m_FramebufferSize = { (float)m_Settings.Width, (float)m_Settings.Height };
+		}
+		else
+		{
+			WindowSettings windowSettings("OpenGL3DRendering");
+			m_Window = CreateScope<Window>(windowSettings);
+			m_Window->SetEventCallback(BIND_EVENT_FN(ApplicationHandler::OnEvent)); // All event functions get dispatched to ApplicationHandler::OnEvent
+			m_Window->SetVsync(true);
 
-		m_ImGuiLayer = CreateScope<ImGuiLayer>();
+			m_ImGuiLayer = CreateScope<ImGuiLayer>();
+		}
 
 		RendererAPI::Init();
 	}
 
-	ApplicationHandler::~ApplicationHandler() { }
+	ApplicationHandler::~ApplicationHandler()
+	{
+		// The window (and with it the context) is destroyed after this body, the renderer has to release its resources first
+		Renderer::Shutdown();
+		GPUProfiler::Shutdown();
+	}
 
 	void ApplicationHandler::StartLoop()
 	{
+		if (m_Settings.Benchmark == BenchmarkType::AntiAliasing)
+		{
+			RunAntiAliasingBenchmark();
+			return;
+		}
+
+		if (m_Settings.Benchmark == BenchmarkType::Lighting)
+		{
+			RunLightingBenchmark();
+			return;
+		}
+
+		if (m_Settings.Headless)
+		{
+			RenderHeadless();
+			return;
+		}
+
 		if (!m_Running)
 		{
 			OnStartup();
@@ -59,6 +97,8 @@ namespace OpenGLRendering {
 			m_Running = true;
 			while (m_Running)
 			{
+				OGL_PROFILE_FRAME();
+
 				m_Window->OnUpdate();
 				if (m_Sleeping)
 					continue;
@@ -67,17 +107,240 @@ namespace OpenGLRendering {
 				Timestep step = time - lastTime;
 				lastTime = time;
 
+				GPUProfiler::BeginFrame();
 				OnUpdate(step);
 
 				m_ImGuiLayer->Begin();
 				OnImGuiRender(step);
 				m_ImGuiLayer->End();
+				GPUProfiler::EndFrame();
+			}
+		}
+	}
+
+	// Appends the frame number to the file name if several frames are written
+	static std::string GetFramePath(const std::string& path, uint32_t frame, uint32_t frameCount)
+	{
+		if (frameCount == 1)
+			return path;
+
+		std::stringstream number;
+		number << "_" << std::setw(4) << std::setfill('0') << frame;
+
+		size_t extension = path.find_last_of('.');
+		if (extension == std::string::npos || path.find_first_of("/\\", extension) != std::string::npos)
+			return path + number.str();
+
+		return path.substr(0, extension) + number.str() + path.substr(extension);
+	}
+
+	void ApplicationHandler::RenderHeadless()
+	{
+		OnStartup();
+		Renderer::OnResize(m_Settings.Width, m_Settings.Height);
+
+		OGL_INFO("Rendering {0} frames of {1}x{2} headless", m_Settings.FrameCount, m_Settings.Width, m_Settings.Height);
+
+		// Frames are read back asynchronously and encoded on the capture worker while the next frames render
+		Scope<FrameCapture> capture;
+		if (!m_Settings.OutputPath.empty())
+		{
+			capture = CreateScope<FrameCapture>([this](const CapturedFrame& frame)
+			{
+				ImageWriter::WritePNG(GetFramePath(m_Settings.OutputPath, (uint32_t)frame.Index, m_Settings.FrameCount), frame.Width, frame.Height, frame.Pixels.data(), true);
+			});
+		}
+
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+		// Fixed time step, so every run renders the same frames
+		for (uint32_t frame = 0; frame < m_Settings.FrameCount; frame++)
+		{
+			OGL_PROFILE_FRAME();
+
+			GPUProfiler::BeginFrame();
+			OnUpdate(1.0f / 60.0f);
+			GPUProfiler::EndFrame();
+
+			if (capture)
+				Renderer::CaptureFrame(*capture);
+		}
+
+		RendererAPI::Finish();
+		float renderMilliseconds = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+		if (capture)
+			capture->Flush();
+
+		float totalMilliseconds = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+		float frameMilliseconds = renderMilliseconds / (float)m_Settings.FrameCount;
+
+		OGL_INFO("Rendered {0} frames in {1} ms, {2} ms per frame ({3} FPS)", m_Settings.FrameCount, renderMilliseconds, frameMilliseconds, 1000.0f / frameMilliseconds);
+		if (capture)
+			OGL_INFO("Wrote all frames after {0} ms, the render loop waited {1} times for a readback", totalMilliseconds, capture->GetStalls());
+	}
+
+	void ApplicationHandler::RenderBenchmarkFrames(float& frameMilliseconds, float& gpuMilliseconds)
+	{
+		// Shaders compile on first use, the pool drops the targets of the last configuration and the GPU profiler ring needs a few frames for results
+		const uint32_t warmupFrames = 10;
+
+		gpuMilliseconds = 0.0f;
+		std::chrono::steady_clock::time_point start;
+		for (uint32_t frame = 0; frame < warmupFrames + m_Settings.FrameCount; frame++)
+		{
+			if (frame == warmupFrames)
+			{
+				RendererAPI::Finish();
+				start = std::chrono::steady_clock::now();
+			}
+
+			GPUProfiler::BeginFrame();
+			OnUpdate(1.0f / 60.0f);
+			GPUProfiler::EndFrame();
+
+			if (frame >= warmupFrames)
+				gpuMilliseconds += GPUProfiler::GetFrameTime();
+		}
+
+		RendererAPI::Finish();
+		frameMilliseconds = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count() / (float)m_Settings.FrameCount;
+		gpuMilliseconds /= (float)m_Settings.FrameCount;
+	}
+
+	void ApplicationHandler::RunAntiAliasingBenchmark()
+	{
+		OnStartup();
+		Renderer::OnResize(m_Settings.Width, m_Settings.Height);
+
+		OGL_INFO("Benchmarking anti-aliasing modes with {0} frames of {1}x{2}", m_Settings.FrameCount, m_Settings.Width, m_Settings.Height);
+
+		std::ofstream csv("AntiAliasingBenchmark.csv");
+		csv << "Mode,Frame Time (ms),GPU Time (ms),Render Target Memory (MB)\n";
+
+		AntiAliasingMode previousMode = Renderer::GetAntiAliasingMode();
+		for (uint32_t i = 0; i < (uint32_t)AntiAliasingMode::Count; i++)
+		{
+			AntiAliasingMode mode = (AntiAliasingMode)i;
+			Renderer::SetAntiAliasingMode(mode);
+
+			float frameMilliseconds, gpuMilliseconds;
+			RenderBenchmarkFrames(frameMilliseconds, gpuMilliseconds);
+
+			const RenderGraphStats& stats = Renderer::GetStatistics().Graph;
+			float memory = (float)(stats.PooledMemory + stats.ImportedMemory) / (1024.0f * 1024.0f);
+
+			OGL_INFO("{0}: {1} ms per frame, GPU {2} ms, render targets {3} MB", GetAntiAliasingModeName(mode), frameMilliseconds, gpuMilliseconds, memory);
+			csv << GetAntiAliasingModeName(mode) << "," << frameMilliseconds << "," << gpuMilliseconds << "," << memory << "\n";
+		}
+
+		Renderer::SetAntiAliasingMode(previousMode);
+		OGL_INFO("Wrote benchmark results to AntiAliasingBenchmark.csv");
+	}
+
+	void ApplicationHandler::RunLightingBenchmark()
+	{
+		OnStartup();
+		Renderer::OnResize(m_Settings.Width, m_Settings.Height);
+
+		OGL_INFO("Benchmarking forward and deferred shading with {0} frames of {1}x{2}", m_Settings.FrameCount, m_Settings.Width, m_Settings.Height);
+
+		// MSAA isn't available on the deferred path, both paths run without anti-aliasing so only the shading differs
+		AntiAliasingMode previousMode = Renderer::GetAntiAliasingMode();
+		ShadingPath previousPath = Renderer::GetShadingPath();
+		int previousLightCount = m_LightCount;
+		Renderer::SetAntiAliasingMode(AntiAliasingMode::Off);
+
+		std::ofstream csv("LightingBenchmark.csv");
+		csv << "Lights,Visible Lights,Forward Frame Time (ms),Forward GPU Time (ms),Light Culling (ms),Cluster Assignment (ms),Deferred Frame Time (ms),Deferred GPU Time (ms)\n";
+
+		const uint32_t lightCounts[] = { 0, 16, 64, 256, 1024, 4096, 8192 };
+		uint32_t crossover = 0;
+		bool crossed = false;
+		for (uint32_t lightCount : lightCounts)
+		{
+			m_LightCount = (int)lightCount;
+
+			float forwardFrame, forwardGPU;
+			Renderer::SetShadingPath(ShadingPath::Forward);
+			RenderBenchmarkFrames(forwardFrame, forwardGPU);
+
+			// CPU times of the last forward frame
+			const RendererStats& stats = Renderer::GetStatistics();
+			float cullingTime = stats.LightCullingTime, assignmentTime = stats.LightAssignmentTime;
+
+			float deferredFrame, deferredGPU;
+			Renderer::SetShadingPath(ShadingPath::Deferred);
+			RenderBenchmarkFrames(deferredFrame, deferredGPU);
+
+			uint32_t visibleLights = Renderer::GetStatistics().Lights;
+			OGL_INFO("{0} lights ({1} visible): forward GPU {2} ms (culling {3} ms, cluster assignment {4} ms), deferred GPU {5} ms",
+				lightCount, visibleLights, forwardGPU, cullingTime, assignmentTime, deferredGPU);
+			csv << lightCount << "," << visibleLights << "," << forwardFrame << "," << forwardGPU << "," << cullingTime << "," << assignmentTime << "," << deferredFrame << "," << deferredGPU << "\n";
+
+			if (!crossed && deferredGPU < forwardGPU)
+			{
+				crossover = lightCount;
+				crossed = true;
 			}
 		}
+
+		if (crossed)
+			OGL_INFO("Deferred shading is faster from {0} lights on", crossover);
+		else
+			OGL_INFO("Forward shading was faster for every light count");
+
+		Renderer::SetAntiAliasingMode(previousMode);
+		Renderer::SetShadingPath(previousPath);
+		m_LightCount = previousLightCount;
+		OGL_INFO("Wrote benchmark results to LightingBenchmark.csv");
+	}
+
+	// Deterministic, so benchmark runs are comparable
+	void ApplicationHandler::GenerateLights(uint32_t count)
+	{
+		// Every fourth light is a spot light
+		m_SpotLights.resize(count / 4);
+		m_PointLights.resize(count - count / 4);
+
+		uint32_t state = 1;
+		auto random = [&state]()
+		{
+			state = state * 1664525u + 1013904223u;
+			return (float)(state >> 8) / (float)(1u << 24);
+		};
+
+		// The scene objects lie between (10, 0, 0), (0, 5, 0) and (0, 0, -5) around the model at the origin
+		const glm::vec3 minPosition = { -12.0f, -6.0f, -12.0f };
+		const glm::vec3 maxPosition = { 12.0f, 6.0f, 6.0f };
+		auto randomPosition = [&]() { return minPosition + glm::vec3(random(), random(), random()) * (maxPosition - minPosition); };
+
+		// Saturated colours, a fixed brightness per light
+		auto randomColor = [&]() { return glm::clamp(glm::abs(glm::mod(random() * 6.0f + glm::vec3(0.0f, 4.0f, 2.0f), 6.0f) - 3.0f) - 1.0f, 0.0f, 1.0f) * 2.0f; };
+
+		for (PointLight& light : m_PointLights)
+		{
+			light.Position = randomPosition();
+			light.Radius = 3.0f + random();
+			light.Color = randomColor();
+		}
+
+		// Pointing downwards, tilted by up to 45 degrees
+		for (SpotLight& light : m_SpotLights)
+		{
+			light.Position = randomPosition();
+			light.Radius = 6.0f;
+			light.Color = randomColor() * 2.0f;
+			light.Direction = glm::normalize(glm::vec3(random() * 2.0f - 1.0f, -1.0f, random() * 2.0f - 1.0f));
+			light.InnerAngle = glm::radians(20.0f);
+			light.OuterAngle = glm::radians(35.0f);
+		}
 	}
 
 	void ApplicationHandler::OnStartup()
 	{
+		OGL_PROFILE_FUNCTION();
+
 		Renderer::Init();
 		m_Cubemap = CreateRef<Cubemap>("src/Resources/Assets/textures/cubemap/newport_loft.hdr");
 		
@@ -114,11 +377,23 @@ namespace OpenGLRendering {
 		Ref<Texture2D> metallicSmoothnessTexture = CreateRef<Texture2D>("src/Resources/Assets/textures/Pistol_MetallicSmooth.png");
 		Ref<Texture2D> ambientOcclusionTexture = CreateRef<Texture2D>("src/Resources/Assets/textures/Pistol_Occlusion.png");
 
-		m_Model->GetMeshes()[0].GetMaterial()->SetTextureOfType(TextureType::ALBEDO, diffuseTexture);
-		m_Model->GetMeshes()[0].GetMaterial()->SetTextureOfType(TextureType::NORMAL, normalTexture);
-		m_Model->GetMeshes()[0].GetMaterial()->SetTextureOfType(TextureType::METALLIC_SMOOTHNESS, metallicSmoothnessTexture);
-		m_Model->GetMeshes()[0].GetMaterial()->SetTextureOfType(TextureType::AMBIENT_OCCLUSION, ambientOcclusionTexture);
-		m_Model->GetMeshes()[0].GetMaterial()->UseTextures(true);
+		// The pistol file stores its 5 meshes per LOD without LOD naming
+		if (!m_Model->HasLodGroups())
+			m_Model->SetLodLevels(5);
+
+		// The first mesh of every level is the textured body
+		for (const LodGroup& group : m_Model->GetLodGroups())
+		{
+			for (const LodLevel& level : group.Levels)
+			{
+				Ref<Material>& material = m_Model->GetMeshes()[level.FirstMesh].GetMaterial();
+				material->SetTextureOfType(TextureType::ALBEDO, diffuseTexture);
+				material->SetTextureOfType(TextureType::NORMAL, normalTexture);
+				material->SetTextureOfType(TextureType::METALLIC_SMOOTHNESS, metallicSmoothnessTexture);
+				material->SetTextureOfType(TextureType::AMBIENT_OCCLUSION, ambientOcclusionTexture);
+				material->UseTextures(true);
+			}
+		}
 #endif
 
 
@@ -186,8 +461,10 @@ namespace OpenGLRendering {
 
 	void ApplicationHandler::OnUpdate(Timestep t)
 	{
-		m_CameraController->OnUpdate(t);
-		float time = (float)glfwGetTime();
+		OGL_PROFILE_FUNCTION();
+
+		if (!m_Settings.Headless)
+			m_CameraController->OnUpdate(t);
 
 		// Render to custom framebuffer to render the generated texture in an ImGui Window
 		m_CameraController->GetCamera()->SetAspectRatio((float)m_FramebufferSize.x / (float)m_FramebufferSize.y);
@@ -200,22 +477,47 @@ namespace OpenGLRendering {
 
 		modelCube = glm::rotate(modelCube, 3.14f, { 1.0f, 0.5f, 0.0f });
 
-		LightInfo lightInfo = { m_LightPos, m_LightColor };
+		LightInfo lightInfo = { m_LightPos, m_LightColor, m_SunDirection, m_SunColor };
 		Renderer::BeginScene(m_CameraController->GetCamera(), m_Cubemap, lightInfo);
-		Renderer::Submit(m_Model, 0, 5);
+		Renderer::Submit(m_Model, Mobility::Dynamic); // Can be moved in the model panel
+
 		Renderer::Submit(m_Sphere, modelSphere);
 		Renderer::Submit(m_Cube, modelCube);
 		Renderer::Submit(m_Pyramid, modelPyramid);
+
+		if (m_PointLights.size() + m_SpotLights.size() != (size_t)m_LightCount)
+			GenerateLights((uint32_t)m_LightCount);
+
+		for (const PointLight& light : m_PointLights)
+			Renderer::SubmitLight(light);
+
+		for (const SpotLight& light : m_SpotLights)
+			Renderer::SubmitLight(light);
+
+		// Stress test grid, all cubes share vertex array and material and end up in a single instanced draw
+		// They are submitted as dynamic, the static shadow cache would hash every one of them each frame
+		int gridSize = (int)std::ceil(std::cbrt((float)m_StressTestCubeCount));
+		for (int i = 0; i < m_StressTestCubeCount; i++)
+		{
+			glm::vec3 position = { (float)(i % gridSize), (float)((i / gridSize) % gridSize), (float)(i / (gridSize * gridSize)) };
+			glm::mat4 modelMatrix = glm::translate(glm::mat4(1.0f), glm::vec3(-20.0f, -10.0f, -20.0f) + position * 0.5f);
+			modelMatrix = glm::scale(modelMatrix, { 0.1f, 0.1f, 0.1f });
+
+			Renderer::Submit(m_Cube, modelMatrix, Mobility::Dynamic);
+		}
 		Renderer::EndScene();
 
-		Renderer::InvertColor();
-		Renderer::ColorGrade(m_GradingColor);
+		Renderer::PostProcess(m_PostProcessStack);
+		Renderer::EndFrame();
 
-		RendererAPI::SetViewport(0, 0, m_Window->GetWidth(), m_Window->GetHeight());
+		if (!m_Settings.Headless)
+			RendererAPI::SetViewport(0, 0, m_Window->GetWidth(), m_Window->GetHeight());
 	}
 
 	void ApplicationHandler::OnImGuiRender(Timestep t)
 	{
+		OGL_PROFILE_FUNCTION();
+
 		static bool opt_fullscreen_persistant = true;
 		bool opt_fullscreen = opt_fullscreen_persistant;
 		static ImGuiDockNodeFlags dockspace_flags = ImGuiDockNodeFlags_None;
@@ -317,7 +619,115 @@ namespace OpenGLRendering {
 		ImGui::DragFloat3("Camera Position", (float*)&m_CameraController->GetPosition());
 		ImGui::DragFloat3("Light Position", (float*)&m_LightPos);
 		ImGui::ColorEdit3("Light Color", (float*)&m_LightColor);
-		ImGui::ColorEdit4("Grading Color", (float*)&m_GradingColor);
+		ImGui::DragFloat3("Sun Direction", (float*)&m_SunDirection, 0.01f, -1.0f, 1.0f);
+		ImGui::ColorEdit3("Sun Color", (float*)&m_SunColor, ImGuiColorEditFlags_HDR | ImGuiColorEditFlags_Float);
+
+		ShadowSettings shadows = Renderer::GetShadowSettings();
+		bool shadowsChanged = ImGui::Checkbox("Shadows", &shadows.Enabled);
+		shadowsChanged |= ImGui::Checkbox("Cache Static Shadows", &shadows.Caching);
+		int cascadeCount = (int)shadows.CascadeCount;
+		if (ImGui::SliderInt("Shadow Cascades", &cascadeCount, 1, (int)ShadowSettings::MaxCascades))
+		{
+			shadows.CascadeCount = (uint32_t)cascadeCount;
+			shadowsChanged = true;
+		}
+		shadowsChanged |= ImGui::DragFloat("Shadow Distance", &shadows.Distance, 0.5f, 1.0f, 500.0f);
+		shadowsChanged |= ImGui::DragFloat("Shadow Slope Bias", &shadows.SlopeBias, 0.05f, 0.0f, 10.0f);
+		shadowsChanged |= ImGui::DragFloat("Shadow Normal Bias", &shadows.NormalBias, 0.05f, 0.0f, 10.0f);
+		if (shadowsChanged)
+			Renderer::SetShadowSettings(shadows);
+
+		const char* depthPrePassModes[] = { "Off", "On", "Auto" };
+		int depthPrePassMode = (int)Renderer::GetDepthPrePassMode();
+		if (ImGui::Combo("Depth Pre-Pass", &depthPrePassMode, depthPrePassModes, 3))
+			Renderer::SetDepthPrePassMode((DepthPrePassMode)depthPrePassMode);
+
+		bool frustumCulling = Renderer::IsFrustumCulling();
+		if (ImGui::Checkbox("Frustum Culling", &frustumCulling))
+			Renderer::SetFrustumCulling(frustumCulling);
+
+		bool indirectDrawing = Renderer::IsIndirectDrawing();
+		if (ImGui::Checkbox("Multi Draw Indirect", &indirectDrawing))
+			Renderer::SetIndirectDrawing(indirectDrawing);
+
+		bool automaticLod = Renderer::IsAutomaticLod();
+		if (ImGui::Checkbox("Automatic LOD", &automaticLod))
+			Renderer::SetAutomaticLod(automaticLod);
+
+		float lodBias = Renderer::GetLodBias();
+		if (ImGui::DragFloat("LOD Bias", &lodBias, 0.01f, 0.01f, 10.0f))
+			Renderer::SetLodBias(lodBias);
+
+		const char* shadingPaths[] = { "Forward", "Deferred" };
+		int shadingPath = (int)Renderer::GetShadingPath();
+		if (ImGui::Combo("Shading Path", &shadingPath, shadingPaths, 2))
+			Renderer::SetShadingPath((ShadingPath)shadingPath);
+
+		ImGui::DragInt("Lights", &m_LightCount, 1.0f, 0, 8192);
+
+		const char* antiAliasingModes[(size_t)AntiAliasingMode::Count];
+		for (uint32_t i = 0; i < (uint32_t)AntiAliasingMode::Count; i++)
+			antiAliasingModes[i] = GetAntiAliasingModeName((AntiAliasingMode)i);
+
+		int antiAliasingMode = (int)Renderer::GetAntiAliasingMode();
+		if (ImGui::Combo("Anti-Aliasing", &antiAliasingMode, antiAliasingModes, (int)AntiAliasingMode::Count))
+			Renderer::SetAntiAliasingMode((AntiAliasingMode)antiAliasingMode);
+
+		// Colour formats only, the depth formats follow RGBA16F in the enum
+		const uint32_t sceneColorFormatCount = (uint32_t)RenderTargetFormat::RGBA16F + 1;
+		const char* sceneColorFormats[sceneColorFormatCount];
+		for (uint32_t i = 0; i < sceneColorFormatCount; i++)
+			sceneColorFormats[i] = GetRenderTargetFormatName((RenderTargetFormat)i);
+
+		int sceneColorFormat = (int)Renderer::GetSceneColorFormat();
+		if (ImGui::Combo("Scene Color Format", &sceneColorFormat, sceneColorFormats, (int)sceneColorFormatCount))
+			Renderer::SetSceneColorFormat((RenderTargetFormat)sceneColorFormat);
+
+		float exposure = Renderer::GetExposure();
+		if (ImGui::DragFloat("Exposure", &exposure, 0.01f, 0.0f, 10.0f))
+			Renderer::SetExposure(exposure);
+
+		float gamma = Renderer::GetGamma();
+		if (ImGui::DragFloat("Gamma", &gamma, 0.01f, 0.1f, 5.0f))
+			Renderer::SetGamma(gamma);
+
+		DynamicResolutionSettings dynamicResolution = Renderer::GetDynamicResolution();
+		bool dynamicResolutionChanged = ImGui::Checkbox("Dynamic Resolution", &dynamicResolution.Enabled);
+		dynamicResolutionChanged |= ImGui::DragFloat("Target GPU Time", &dynamicResolution.TargetFrameTime, 0.1f, 1.0f, 100.0f);
+		dynamicResolutionChanged |= ImGui::DragFloat("Min Resolution Scale", &dynamicResolution.MinScale, 0.01f, 0.5f, dynamicResolution.MaxScale);
+		dynamicResolutionChanged |= ImGui::DragFloat("Max Resolution Scale", &dynamicResolution.MaxScale, 0.01f, dynamicResolution.MinScale, 1.0f);
+		dynamicResolutionChanged |= ImGui::DragFloat("Upscale Sharpness", &dynamicResolution.Sharpness, 0.01f, 0.0f, 1.0f);
+		if (dynamicResolutionChanged)
+			Renderer::SetDynamicResolution(dynamicResolution);
+
+		ImGui::Dummy({ 1.0, 10.0 });
+		ImGui::Text("Post Processing");
+		ImGui::Spacing();
+
+		// Effects are applied in declaration order, every combination gets its own fused shader
+		bool effectsChanged = false;
+		std::vector<PostEffect> effects;
+		for (uint32_t i = 0; i < (uint32_t)PostEffect::Count; i++)
+		{
+			PostEffect effect = (PostEffect)i;
+			bool enabled = std::find(m_PostProcessStack.Effects.begin(), m_PostProcessStack.Effects.end(), effect) != m_PostProcessStack.Effects.end();
+			effectsChanged |= ImGui::Checkbox(GetPostEffectName(effect), &enabled);
+
+			if (enabled)
+				effects.push_back(effect);
+		}
+
+		if (effectsChanged)
+			m_PostProcessStack.Effects = effects;
+
+		ImGui::ColorEdit4("Grading Color", (float*)&m_PostProcessStack.GradingColor);
+		ImGui::DragFloat("Vignette Strength", &m_PostProcessStack.VignetteStrength, 0.01f, 0.0f, 1.0f);
+		ImGui::DragFloat("Vignette Radius", &m_PostProcessStack.VignetteRadius, 0.01f, 0.0f, 1.0f);
+
+		ImGui::Dummy({ 1.0, 10.0 });
+		ImGui::Text("Stress Test");
+		ImGui::Spacing();
+		ImGui::DragInt("Cube Count", &m_StressTestCubeCount, 100.0f, 0, 100000);
 		ImGui::End();
 
 		m_Model->SetTranslation(translation);
@@ -331,7 +741,7 @@ namespace OpenGLRendering {
 
 		const RendererStats& stats = Renderer::GetStatistics();
 		std::stringstream ss;
-		ss << "Frametime: " << t.GetMilliseconds() << ", FPS: " << 1000.0f / t.GetMilliseconds();
+		ss << "Frametime: " << t.GetMilliseconds() << ", FPS: " << 1000.0f / t.GetMilliseconds() << ", GPU: " << stats.GPUFrameTime << " ms";
 		ImGui::Text(ss.str().c_str());
 		ss.str(std::string());
 		ss << "Vertex Count: " << stats.VertexCount;
@@ -340,8 +750,66 @@ namespace OpenGLRendering {
 		ss << "Face Count: " << stats.FaceCount;
 		ImGui::Text(ss.str().c_str());
 		ss.str(std::string());
+		ss << "Meshes: " << stats.SubmittedMeshes << " submitted, " << stats.CulledMeshes << " culled, " << stats.DrawnMeshes << " drawn";
+		ImGui::Text(ss.str().c_str());
+		ss.str(std::string());
+		ss << "Bounds Tests: " << stats.BoundsTests;
+		ImGui::Text(ss.str().c_str());
+		ss.str(std::string());
+		ss << "LOD Switches: " << stats.LodSwitches;
+		ImGui::Text(ss.str().c_str());
+		ss.str(std::string());
+		ss << "Depth Pre-Pass: " << (stats.DepthPrePass ? "on" : "off") << ", estimated depth complexity: " << stats.EstimatedDepthComplexity;
+		ImGui::Text(ss.str().c_str());
+		ss.str(std::string());
+		ss << "Shaded Fragments: " << stats.ShadedFragments;
+		if (stats.DepthPrePass && stats.PrePassFragments > stats.ShadedFragments)
+			ss << " (" << stats.PrePassFragments - stats.ShadedFragments << " saved by the pre-pass)";
+		ImGui::Text(ss.str().c_str());
+		ss.str(std::string());
+		ss << "Lights: " << stats.Lights << " of " << stats.SubmittedLights << " visible, " << stats.LightIndices << " cluster entries";
+		ImGui::Text(ss.str().c_str());
+		ss.str(std::string());
+		ss << "Light Culling: " << stats.LightCullingTime << " ms, cluster assignment: " << stats.LightAssignmentTime << " ms";
+		ImGui::Text(ss.str().c_str());
+		ss.str(std::string());
+		ss << "Shadows: " << stats.ShadowViews << " views, " << stats.CachedShadowViews << " with cached static casters, " << stats.ShadowCasters << " caster instances drawn";
+		ImGui::Text(ss.str().c_str());
+		ss.str(std::string());
 		ss << "Draw Calls: " << stats.DrawCalls;
 		ImGui::Text(ss.str().c_str());
+		ss.str(std::string());
+		ss << "State Changes: " << stats.StateChangesIssued << " issued, " << stats.StateChangesFiltered << " filtered";
+		ImGui::Text(ss.str().c_str());
+		ss.str(std::string());
+		ss << "Render Graph: " << stats.Graph.Passes << " passes, " << stats.Graph.CulledPasses << " culled";
+		ImGui::Text(ss.str().c_str());
+		ss.str(std::string());
+		ss << "Render Targets: " << stats.Graph.Textures << " textures in " << stats.Graph.PooledTextures << " allocations, "
+			<< stats.Graph.PooledMemory / (1024 * 1024) << " MB (" << stats.Graph.UnaliasedMemory / (1024 * 1024) << " MB without aliasing)";
+		ImGui::Text(ss.str().c_str());
+		ss.str(std::string());
+		ss << "Render Resolution: " << stats.RenderWidth << "x" << stats.RenderHeight << " (" << (int)(stats.ResolutionScale * 100.0f + 0.5f) << "%) in "
+			<< stats.TargetWidth << "x" << stats.TargetHeight << " targets";
+		ImGui::Text(ss.str().c_str());
+
+#if OGL_PROFILE
+		// Open the trace in chrome://tracing or ui.perfetto.dev
+		if (Profiler::IsCapturing())
+			ImGui::Text("Capturing CPU trace...");
+		else if (ImGui::Button("Capture CPU Trace"))
+			Profiler::BeginCapture("CPUTrace.json", 120);
+#endif
+
+		ImGui::Dummy({ 1.0, 10.0 });
+		ImGui::Text("GPU Time");
+		ImGui::Spacing();
+		for (const GPUPassTiming& timing : stats.GPUPassTimings)
+		{
+			ss.str(std::string());
+			ss << std::string(timing.Depth * 2, ' ') << timing.Name << ": " << timing.Milliseconds << " ms";
+			ImGui::Text(ss.str().c_str());
+		}
 
 		ImGui::End();
 
@@ -351,7 +819,7 @@ namespace OpenGLRendering {
 		ImGui::Begin("Viewport");
 
 		ImVec2 size = ImGui::GetContentRegionAvail();
-		if (m_FramebufferSize.x != size.x || m_FramebufferSize.y != size.y && size.x > 0 && size.y > 0)
+		if ((m_FramebufferSize.x != size.x || m_FramebufferSize.y != size.y) && size.x > 0 && size.y > 0)
 		{
 			Renderer::OnResize((uint32_t)size.x, (uint32_t)size.y);
 
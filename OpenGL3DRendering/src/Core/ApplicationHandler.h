@@ -4,8 +4,9 @@
 #include "Timestep.h"
 #include "Window.h"
 #include "Renderer/Shader.h"
-#include "Renderer/Framebuffer.h"
 #include "Renderer/Cubemap.h"
+#include "Renderer/PostProcess.h"
+#include "Renderer/Renderer.h"
 
 #include "ImGui/ImGuiLayer.h"
 
@@ -17,20 +18,44 @@
 namespace OpenGLRendering {
 
 
+	enum class BenchmarkType : uint8_t
+	{
+		None = 0,
+		AntiAliasing, // Every anti-aliasing mode, compares frame time and render target memory
+		Lighting // Forward against deferred shading with increasing light counts
+	};
+
+	// Startup options, filled from the command line in Application.cpp
+	struct ApplicationSettings
+	{
+		bool Headless = false; // Renders FrameCount frames without window, ImGui or swap and writes them to OutputPath
+		uint32_t FrameCount = 1;
+		uint32_t Width = 1920, Height = 1080; // Frame size in headless mode
+		std::string OutputPath = "render_output.png"; // Frame numbers are appended for several frames, empty to only measure throughput
+		BenchmarkType Benchmark = BenchmarkType::None; // Headless, renders FrameCount frames per measured configuration
+	};
+
 	// Runtime handler of the application (singleton)
 	// Change the OnStartup(), OnUpdate(Timestep t) and OnImGuiRender(Timestep t) methods to change the contents of the application
 	class ApplicationHandler
 	{
 	public:
-		ApplicationHandler();
+		ApplicationHandler(const ApplicationSettings& settings = ApplicationSettings());
 		~ApplicationHandler();
 
 		void StartLoop();
-		const Window& GetWindow() { return *m_Window; }
+		const Window& GetWindow() { return *m_Window; } // Not available in headless mode
+		bool IsHeadless() const { return m_Settings.Headless; }
 		
 		static ApplicationHandler& Get() { return *s_Instance; }
 
 	private:
+		void RenderHeadless();
+		void RunAntiAliasingBenchmark();
+		void RunLightingBenchmark();
+		void RenderBenchmarkFrames(float& frameMilliseconds, float& gpuMilliseconds); // Averages per frame
+		void GenerateLights(uint32_t count);
+
 		void OnStartup();
 		void OnUpdate(Timestep t);
 		void OnImGuiRender(Timestep t);
@@ -43,8 +68,10 @@ namespace OpenGLRendering {
 		bool m_Running;
 		bool m_Sleeping;
 		static ApplicationHandler* s_Instance;
+		ApplicationSettings m_Settings;
 		
 		Scope<Window> m_Window;
+		Scope<OpenGLContext> m_HeadlessContext;
 		Scope<ImGuiLayer> m_ImGuiLayer;
 		Scope<CameraController> m_CameraController;
 		glm::vec2 m_FramebufferSize = { 1920.0f, 1080.0f };
@@ -57,8 +84,15 @@ namespace OpenGLRendering {
 		
 		glm::vec3 m_LightPos = { 0.0f, 0.0f, 4.0f };
 		glm::vec3 m_LightColor = { 1.0f, 1.0f, 1.0f };
+		glm::vec3 m_SunDirection = { -0.4f, -1.0f, -0.3f };
+		glm::vec3 m_SunColor = { 2.0f, 1.9f, 1.7f };
 		glm::vec4 m_ClearColor = { 0.0f, 0.0f, 0.0f, 1.0f };
-		glm::vec4 m_GradingColor = { 1.0f, 1.0f, 1.0f, 1.0f };
+		PostProcessStack m_PostProcessStack = { { PostEffect::Invert, PostEffect::ColorGrading } };
+
+		int m_StressTestCubeCount = 0; // Additional cubes submitted in a grid to stress the renderer
+		int m_LightCount = 0; // Point and spot lights scattered around the scene objects, regenerated when the count changes
+		std::vector<PointLight> m_PointLights;
+		std::vector<SpotLight> m_SpotLights;
 	};
 
 } // namespace OpenGLRendering
\ No newline at end of file
@@ -7,19 +7,63 @@ namespace OpenGLRendering {
 
 
 	// Very basic camera class that provides the renderer with the view matrix
+	// View and projection matrices are cached and only recalculated when a parameter actually changes
 	class Camera
 	{
 	public:
 		Camera(const glm::vec3& position)
-			: m_Position(position), m_Front({ 0.0f, 0.0f, -1.0f }), m_Up({ 0.0f, 1.0f, 0.0f }), m_AspectRatio(16.0f / 9.0f) { }
+			: m_Position(position), m_Front({ 0.0f, 0.0f, -1.0f }), m_Up({ 0.0f, 1.0f, 0.0f }), m_AspectRatio(16.0f / 9.0f), m_NearClip(0.1f), m_FarClip(100.0f)
+		{
+			RecalculateViewMatrix();
+			RecalculateProjectionMatrix();
+		}
 
-		glm::mat4 GetViewMatrix() const { return glm::lookAt(m_Position, m_Position + m_Front, m_Up); }
-		glm::mat4 GetProjectionMatrix() const { return glm::perspective(45.0f, m_AspectRatio, 0.1f, 100.0f); }
+		const glm::mat4& GetViewMatrix() const { return m_ViewMatrix; }
+		const glm::mat4& GetProjectionMatrix() const { return m_ProjectionMatrix; }
+		const glm::mat4& GetViewProjectionMatrix() const { return m_ViewProjectionMatrix; }
 		glm::vec3 GetPosition() const { return m_Position; }
+		float GetNearClip() const { return m_NearClip; }
+		float GetFarClip() const { return m_FarClip; }
 
-		void SetCameraPosition(const glm::vec3& position) { m_Position = position; }
-		void SetCameraFront(const glm::vec3& front) { m_Front = front; }
-		void SetAspectRatio(float aspectRatio) { m_AspectRatio = aspectRatio; }
+		void SetCameraPosition(const glm::vec3& position)
+		{
+			if (position == m_Position)
+				return;
+
+			m_Position = position;
+			RecalculateViewMatrix();
+		}
+
+		void SetCameraFront(const glm::vec3& front)
+		{
+			if (front == m_Front)
+				return;
+
+			m_Front = front;
+			RecalculateViewMatrix();
+		}
+
+		void SetAspectRatio(float aspectRatio)
+		{
+			if (aspectRatio == m_AspectRatio)
+				return;
+
+			m_AspectRatio = aspectRatio;
+			RecalculateProjectionMatrix();
+		}
+
+	private:
+		void RecalculateViewMatrix()
+		{
+			m_ViewMatrix = glm::lookAt(m_Position, m_Position + m_Front, m_Up);
+			m_ViewProjectionMatrix = m_ProjectionMatrix * m_ViewMatrix;
+		}
+
+		void RecalculateProjectionMatrix()
+		{
+			m_ProjectionMatrix = glm::perspective(45.0f, m_AspectRatio, m_NearClip, m_FarClip);
+			m_ViewProjectionMatrix = m_ProjectionMatrix * m_ViewMatrix;
+		}
 
 	private:
 		glm::vec3 m_Position;
@@ -27,6 +71,12 @@ namespace OpenGLRendering {
 		glm::vec3 m_Up;
 
 		float m_AspectRatio;
+		float m_NearClip;
+		float m_FarClip;
+
+		glm::mat4 m_ViewMatrix;
+		glm::mat4 m_ProjectionMatrix;
+		glm::mat4 m_ViewProjectionMatrix;
 	};
 
 }
\ No newline at end of file
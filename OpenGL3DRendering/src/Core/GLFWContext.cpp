@@ -0,0 +1,24 @@
+#include "oglpch.h"
+
+#include "GLFWContext.h"
+
+namespace OpenGLRendering {
+
+	GLFWContext::GLFWContext(GLFWwindow* window)
+		: m_Window(window)
+	{
+
+	}
+
+	void GLFWContext::Init()
+	{
+		glfwMakeContextCurrent(m_Window);
+
+		LoadFunctions((void* (*)(const char*))glfwGetProcAddress);
+	}
+
+	void GLFWContext::SwapBuffers()
+	{
+		glfwSwapBuffers(m_Window);
+	}
+}
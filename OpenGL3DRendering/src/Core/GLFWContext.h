@@ -0,0 +1,23 @@
+#pragma once
+
+#include <GLFW/glfw3.h>
+
+#include "Core/OpenGLContext.h"
+
+namespace OpenGLRendering {
+
+
+	// GLFW OpenGL context wrapper class
+	class GLFWContext : public OpenGLContext
+	{
+	public:
+		GLFWContext(GLFWwindow* window);
+
+		void Init() override;
+		void SwapBuffers() override;
+
+	private:
+		GLFWwindow* m_Window;
+	};
+
+}
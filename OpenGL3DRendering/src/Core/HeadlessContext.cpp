@@ -0,0 +1,137 @@
+#include "oglpch.h"
+
+#include "HeadlessContext.h"
+
+#if __has_include(<EGL/egl.h>)
+	#define OGL_HEADLESS_EGL 1
+	#include <EGL/egl.h>
+	#include <EGL/eglext.h>
+#else
+	#define OGL_HEADLESS_EGL 0
+	#include <GLFW/glfw3.h>
+#endif
+
+namespace OpenGLRendering {
+
+	HeadlessContext::HeadlessContext()
+	{
+
+	}
+
+#if OGL_HEADLESS_EGL
+
+	static bool HasExtension(const char* extensions, const char* name)
+	{
+		if (!extensions)
+			return false;
+
+		size_t length = strlen(name);
+		for (const char* position = strstr(extensions, name); position; position = strstr(position + length, name))
+		{
+			if ((position == extensions || position[-1] == ' ') && (position[length] == ' ' || position[length] == '\0'))
+				return true;
+		}
+
+		return false;
+	}
+
+	static EGLDisplay GetDisplay()
+	{
+		// The surfaceless platform needs neither a display server nor a GPU
+		const char* clientExtensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+		if (HasExtension(clientExtensions, "EGL_MESA_platform_surfaceless"))
+		{
+			PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+			if (getPlatformDisplay)
+				return getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+		}
+
+		return eglGetDisplay(EGL_DEFAULT_DISPLAY);
+	}
+
+	HeadlessContext::~HeadlessContext()
+	{
+		if (!m_Display)
+			return;
+
+		eglMakeCurrent(m_Display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+		if (m_Context)
+			eglDestroyContext(m_Display, m_Context);
+		eglTerminate(m_Display);
+	}
+
+	void HeadlessContext::Init()
+	{
+		EGLDisplay display = GetDisplay();
+		EGLint major, minor;
+		bool success = display != EGL_NO_DISPLAY && eglInitialize(display, &major, &minor);
+		OGL_ASSERT(success, "Couldn't initialize EGL");
+		m_Display = display;
+
+		OGL_INFO("EGL {0}.{1}", major, minor);
+
+		const char* extensions = eglQueryString(display, EGL_EXTENSIONS);
+		OGL_ASSERT(HasExtension(extensions, "EGL_KHR_surfaceless_context"), "EGL_KHR_surfaceless_context is required for headless rendering");
+
+		eglBindAPI(EGL_OPENGL_API);
+
+		// No surface is ever created, so the config only matters if contexts without config are not supported
+		EGLConfig config = EGL_NO_CONFIG_KHR;
+		if (!HasExtension(extensions, "EGL_KHR_no_config_context"))
+		{
+			const EGLint configAttributes[] = { EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT, EGL_SURFACE_TYPE, EGL_PBUFFER_BIT, EGL_NONE };
+			EGLint configCount = 0;
+			eglChooseConfig(display, configAttributes, &config, 1, &configCount);
+			OGL_ASSERT(configCount, "No EGL config for desktop OpenGL");
+		}
+
+		// 4.6 is preferred, software drivers often stop at 4.5 which covers everything the renderer uses
+		const EGLint versions[][2] = { { 4, 6 }, { 4, 5 } };
+		for (const EGLint* version : versions)
+		{
+			const EGLint contextAttributes[] = {
+				EGL_CONTEXT_MAJOR_VERSION, version[0],
+				EGL_CONTEXT_MINOR_VERSION, version[1],
+				EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+				EGL_NONE
+			};
+
+			m_Context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttributes);
+			if (m_Context)
+				break;
+		}
+
+		OGL_ASSERT(m_Context, "Couldn't create a headless OpenGL context");
+
+		eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, m_Context);
+		LoadFunctions((void* (*)(const char*))eglGetProcAddress);
+	}
+
+#else
+
+	HeadlessContext::~HeadlessContext()
+	{
+		if (!m_Context)
+			return;
+
+		glfwDestroyWindow((GLFWwindow*)m_Context);
+		glfwTerminate();
+	}
+
+	void HeadlessContext::Init()
+	{
+		int success = glfwInit();
+		OGL_ASSERT(success, "Couldn't initialize GLFW");
+
+		glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+		GLFWwindow* window = glfwCreateWindow(1, 1, "OpenGLRendering", nullptr, nullptr);
+		OGL_ASSERT(window, "Couldn't create a headless OpenGL context");
+		m_Context = window;
+
+		glfwMakeContextCurrent(window);
+		LoadFunctions((void* (*)(const char*))glfwGetProcAddress);
+	}
+
+#endif
+
+}
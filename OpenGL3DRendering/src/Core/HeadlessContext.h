@@ -0,0 +1,25 @@
+#pragma once
+
+#include "Core/OpenGLContext.h"
+
+namespace OpenGLRendering {
+
+
+	// OpenGL context without a window or default framebuffer, everything is rendered into framebuffer objects
+	// Uses a surfaceless EGL context where EGL is available (works with software drivers like llvmpipe on server nodes),
+	// otherwise an invisible GLFW window
+	class HeadlessContext : public OpenGLContext
+	{
+	public:
+		HeadlessContext();
+		~HeadlessContext();
+
+		void Init() override;
+		void SwapBuffers() override { } // Nothing is presented
+
+	private:
+		void* m_Display = nullptr;
+		void* m_Context = nullptr;
+	};
+
+}
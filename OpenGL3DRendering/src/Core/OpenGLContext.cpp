@@ -6,17 +6,9 @@
 
 namespace OpenGLRendering {
 
-	OpenGLContext::OpenGLContext(GLFWwindow* window)
-		: m_Window(window)
+	void OpenGLContext::LoadFunctions(void* (*loader)(const char* name))
 	{
-
-	}
-
-	void OpenGLContext::Init()
-	{
-		glfwMakeContextCurrent(m_Window);
-
-		int status = gladLoadGLLoader((GLADloadproc)glfwGetProcAddress);
+		int status = gladLoadGLLoader((GLADloadproc)loader);
 
 		OGL_ASSERT(status, "Failed to initialize glad!");
 
@@ -31,9 +23,4 @@ namespace OpenGLRendering {
 		OGL_INFO("Max Texture Slots: {0}", m_MaxTextureSlots);
 		OGL_INFO("Max combined Texture Slots: {0}", m_MaxCombinedTextureSlots);
 	}
-
-	void OpenGLContext::SwapBuffers()
-	{
-		glfwSwapBuffers(m_Window);
-	}
-}
\ No newline at end of file
+}
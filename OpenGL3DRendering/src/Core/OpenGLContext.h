@@ -1,26 +1,28 @@
 #pragma once
-
-#include <GLFW/glfw3.h>
+#include <stdint.h>
 
 namespace OpenGLRendering {
 
 
-	// GLFW OpenGLConetex wrapper class
+	// OpenGL context interface, implemented for GLFW windows (GLFWContext) and for rendering without a window (HeadlessContext)
 	class OpenGLContext
 	{
 	public:
-		OpenGLContext(GLFWwindow* window);
-		void Init();
-		void SwapBuffers();
+		virtual ~OpenGLContext() = default;
+
+		virtual void Init() = 0;
+		virtual void SwapBuffers() = 0;
 
 		uint32_t GetMaxTextureSlots() { return m_MaxTextureSlots; }
 		uint32_t GetMaxCombinedTextureSlots() { return m_MaxCombinedTextureSlots; }
 
-	private:
-		GLFWwindow* m_Window;
+	protected:
+		// Loads the OpenGL functions through the platform loader, the context has to be current
+		void LoadFunctions(void* (*loader)(const char* name));
 
-		int32_t m_MaxTextureSlots;
-		int32_t m_MaxCombinedTextureSlots;
+	private:
+		int32_t m_MaxTextureSlots = 0;
+		int32_t m_MaxCombinedTextureSlots = 0;
 	};
 
 }
@@ -0,0 +1,195 @@
+#include "oglpch.h"
+
+#include "Profiler.h"
+
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <mutex>
+
+namespace OpenGLRendering {
+
+	// Zones per thread and capture, further zones are dropped
+	static const uint32_t s_ThreadBufferCapacity = 1 << 16;
+
+	struct ProfileZone
+	{
+		const char* Name;
+		int64_t Start;
+		int64_t End;
+	};
+
+	// Only the owning thread writes, the count is published after the zone so readers always see complete zones
+	struct ThreadBuffer
+	{
+		uint32_t ThreadId;
+		std::unique_ptr<ProfileZone[]> Zones;
+		std::atomic<uint32_t> Count { 0 };
+		std::atomic<uint32_t> Dropped { 0 };
+		std::atomic<uint32_t> Capture { 0 }; // Capture the zones belong to, the owning thread resets the buffer when a new one starts
+	};
+
+	struct ProfilerData
+	{
+		std::atomic<bool> Capturing { false };
+		std::atomic<uint32_t> Capture { 0 };
+
+		std::string FilePath;
+		uint32_t FramesLeft = 0;
+		int64_t FrameStart = -1;
+
+		std::mutex BuffersMutex; // Only taken when a thread records its first zone and when the capture is written
+		std::vector<std::unique_ptr<ThreadBuffer>> Buffers;
+	};
+
+	static ProfilerData s_ProfilerData;
+	static thread_local ThreadBuffer* s_ThreadBuffer = nullptr;
+
+	static ThreadBuffer& GetThreadBuffer()
+	{
+		if (!s_ThreadBuffer)
+		{
+			std::lock_guard<std::mutex> lock(s_ProfilerData.BuffersMutex);
+
+			std::unique_ptr<ThreadBuffer> buffer = std::make_unique<ThreadBuffer>();
+			buffer->ThreadId = (uint32_t)s_ProfilerData.Buffers.size();
+			buffer->Zones = std::make_unique<ProfileZone[]>(s_ThreadBufferCapacity);
+
+			s_ThreadBuffer = buffer.get();
+			s_ProfilerData.Buffers.push_back(std::move(buffer));
+		}
+
+		return *s_ThreadBuffer;
+	}
+
+	static void WriteJsonString(std::ofstream& stream, const char* string)
+	{
+		stream << '"';
+		for (const char* c = string; *c; c++)
+		{
+			if (*c == '"' || *c == '\\')
+				stream << '\\';
+			stream << *c;
+		}
+		stream << '"';
+	}
+
+	static void WriteTrace()
+	{
+		std::ofstream stream(s_ProfilerData.FilePath);
+		if (!stream)
+		{
+			OGL_WARN("Couldn't write profiler trace to {0}", s_ProfilerData.FilePath);
+			return;
+		}
+
+		std::lock_guard<std::mutex> lock(s_ProfilerData.BuffersMutex);
+		uint32_t capture = s_ProfilerData.Capture.load();
+		uint32_t zoneCount = 0, droppedCount = 0;
+
+		// Complete events in microseconds, nesting is derived from the times by the viewer
+		stream << std::fixed << std::setprecision(3);
+		stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+		bool first = true;
+		for (const std::unique_ptr<ThreadBuffer>& buffer : s_ProfilerData.Buffers)
+		{
+			if (buffer->Capture.load(std::memory_order_acquire) != capture)
+				continue;
+
+			uint32_t count = buffer->Count.load(std::memory_order_acquire);
+			for (uint32_t i = 0; i < count; i++)
+			{
+				const ProfileZone& zone = buffer->Zones[i];
+
+				stream << (first ? "\n" : ",\n") << "{\"ph\":\"X\",\"pid\":0,\"tid\":" << buffer->ThreadId << ",\"name\":";
+				WriteJsonString(stream, zone.Name);
+				stream << ",\"ts\":" << (double)zone.Start / 1000.0 << ",\"dur\":" << (double)(zone.End - zone.Start) / 1000.0 << "}";
+				first = false;
+			}
+
+			zoneCount += count;
+			droppedCount += buffer->Dropped.load();
+		}
+		stream << "\n]}\n";
+
+		OGL_INFO("Wrote profiler trace with {0} zones to {1}", zoneCount, s_ProfilerData.FilePath);
+		if (droppedCount)
+			OGL_WARN("{0} zones did not fit into the profiler buffers", droppedCount);
+	}
+
+	void Profiler::BeginCapture(const std::string& filePath, uint32_t frameCount)
+	{
+		if (IsCapturing())
+			EndCapture();
+
+		s_ProfilerData.FilePath = filePath;
+		s_ProfilerData.FramesLeft = frameCount;
+		s_ProfilerData.FrameStart = -1;
+
+		s_ProfilerData.Capture++;
+		s_ProfilerData.Capturing = true;
+	}
+
+	void Profiler::EndCapture()
+	{
+		if (!IsCapturing())
+			return;
+
+		s_ProfilerData.Capturing = false;
+		WriteTrace();
+	}
+
+	bool Profiler::IsCapturing()
+	{
+		return s_ProfilerData.Capturing.load(std::memory_order_relaxed);
+	}
+
+	void Profiler::MarkFrame()
+	{
+		if (!IsCapturing())
+			return;
+
+		int64_t time = GetTime();
+		if (s_ProfilerData.FrameStart >= 0)
+		{
+			RecordZone("Frame", s_ProfilerData.FrameStart, time);
+
+			if (s_ProfilerData.FramesLeft && --s_ProfilerData.FramesLeft == 0)
+			{
+				EndCapture();
+				return;
+			}
+		}
+
+		s_ProfilerData.FrameStart = time;
+	}
+
+	void Profiler::RecordZone(const char* name, int64_t start, int64_t end)
+	{
+		ThreadBuffer& buffer = GetThreadBuffer();
+
+		uint32_t capture = s_ProfilerData.Capture.load(std::memory_order_relaxed);
+		if (buffer.Capture.load(std::memory_order_relaxed) != capture)
+		{
+			buffer.Count.store(0, std::memory_order_relaxed);
+			buffer.Dropped.store(0, std::memory_order_relaxed);
+			buffer.Capture.store(capture, std::memory_order_release);
+		}
+
+		uint32_t count = buffer.Count.load(std::memory_order_relaxed);
+		if (count == s_ThreadBufferCapacity)
+		{
+			buffer.Dropped.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+
+		buffer.Zones[count] = { name, start, end };
+		buffer.Count.store(count + 1, std::memory_order_release);
+	}
+
+	int64_t Profiler::GetTime()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+}
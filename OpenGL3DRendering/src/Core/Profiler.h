@@ -0,0 +1,69 @@
+#pragma once
+#include <stdint.h>
+#include <string>
+
+// Scoped CPU profiler, zones are recorded into per thread buffers while a capture is running
+// and written as a Chrome trace (chrome://tracing or ui.perfetto.dev) when the capture ends
+// Recording is lock free, every thread only writes to its own buffer
+
+// Usage: ONLY use the macros for zones, they compile to nothing in Dist builds
+
+namespace OpenGLRendering {
+
+	class Profiler
+	{
+	public:
+		// Records the next frameCount frames (0 records until EndCapture) and writes them to filePath
+		static void BeginCapture(const std::string& filePath, uint32_t frameCount = 0);
+		static void EndCapture();
+		static bool IsCapturing();
+
+		static void MarkFrame(); // Called once per frame by the main loop, frames show up as zones of their own
+		static void RecordZone(const char* name, int64_t start, int64_t end);
+
+		static int64_t GetTime(); // Nanoseconds
+	};
+
+	class ProfileScope
+	{
+	public:
+		ProfileScope(const char* name)
+			: m_Name(name), m_Start(Profiler::IsCapturing() ? Profiler::GetTime() : -1) { }
+
+		~ProfileScope()
+		{
+			if (m_Start >= 0)
+				Profiler::RecordZone(m_Name, m_Start, Profiler::GetTime());
+		}
+
+	private:
+		const char* m_Name;
+		int64_t m_Start;
+	};
+
+}
+
+#ifndef OGL_DIST
+	#define OGL_PROFILE 1
+#else
+	#define OGL_PROFILE 0
+#endif
+
+#if OGL_PROFILE
+	#ifdef _MSC_VER
+		#define OGL_FUNCTION_SIGNATURE __FUNCSIG__
+	#else
+		#define OGL_FUNCTION_SIGNATURE __PRETTY_FUNCTION__
+	#endif
+
+	#define OGL_PROFILE_SCOPE_NAME_(line) profileScope##line
+	#define OGL_PROFILE_SCOPE_NAME(line) OGL_PROFILE_SCOPE_NAME_(line)
+
+	#define OGL_PROFILE_SCOPE(name) ::OpenGLRendering::ProfileScope OGL_PROFILE_SCOPE_NAME(__LINE__)(name)
+	#define OGL_PROFILE_FUNCTION() OGL_PROFILE_SCOPE(OGL_FUNCTION_SIGNATURE)
+	#define OGL_PROFILE_FRAME() ::OpenGLRendering::Profiler::MarkFrame()
+#else
+	#define OGL_PROFILE_SCOPE(name)
+	#define OGL_PROFILE_FUNCTION()
+	#define OGL_PROFILE_FRAME()
+#endif
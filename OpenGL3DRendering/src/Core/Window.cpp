@@ -1,6 +1,7 @@
 #include "oglpch.h"
 
 #include "Window.h"
+#include "GLFWContext.h"
 
 namespace OpenGLRendering {
 
@@ -37,7 +38,7 @@ namespace OpenGLRendering {
 		m_Handle = glfwCreateWindow((int)settings.Width, (int)settings.Height, settings.Title.c_str(), nullptr, nullptr);
 		s_WindowCount++;
 
-		m_Context = CreateScope<OpenGLContext>(m_Handle);
+		m_Context = CreateScope<GLFWContext>(m_Handle);
 		m_Context->Init();
 
 		glfwWindowHint(GLFW_SAMPLES, 8);
@@ -92,6 +93,8 @@ namespace OpenGLRendering {
 
 	void Window::OnUpdate()
 	{
+		OGL_PROFILE_FUNCTION();
+
 		glfwPollEvents();
 		m_Context->SwapBuffers();
 	}
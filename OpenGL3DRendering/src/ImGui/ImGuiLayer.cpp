@@ -7,6 +7,7 @@
 #include <examples/imgui_impl_opengl3.h>
 
 #include "Core/ApplicationHandler.h"
+#include "Renderer/GPUProfiler.h"
 
 namespace OpenGLRendering {
 
@@ -52,13 +53,18 @@ namespace OpenGLRendering {
 
 	void ImGuiLayer::End()
 	{
+		OGL_PROFILE_FUNCTION();
+
 		ImGuiIO& io = ImGui::GetIO();
 		ApplicationHandler& app = ApplicationHandler::Get();
 		io.DisplaySize = ImVec2((float)app.GetWindow().GetWidth(), (float)app.GetWindow().GetHeight());
 
 		// Rendering
 		ImGui::Render();
+
+		GPUProfiler::BeginPass("ImGui");
 		ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+		GPUProfiler::EndPass();
 
 		if (io.ConfigFlags & ImGuiConfigFlags_ViewportsEnable)
 		{
@@ -0,0 +1,135 @@
+#include "oglpch.h"
+
+#include "AntiAliasing.h"
+#include "StateCache.h"
+
+#include <glad/glad.h>
+
+namespace OpenGLRendering {
+
+	// Share of the history in the resolved colour, higher values converge smoother but react slower
+	static const float s_HistoryWeight = 0.9f;
+
+	// Length of the jitter sequence, 8 Halton points cover the pixel evenly without visible patterns
+	static const uint32_t s_JitterSamples = 8;
+
+	struct AntiAliasingModeInfo
+	{
+		const char* Name;
+		uint8_t Samples;
+	};
+
+	static const AntiAliasingModeInfo s_AntiAliasingModes[] =
+	{
+		{ "Off", 1 },
+		{ "FXAA", 1 },
+		{ "SMAA 1x", 1 },
+		{ "TAA", 1 },
+		{ "MSAA 2x", 2 },
+		{ "MSAA 4x", 4 },
+		{ "MSAA 8x", 8 },
+	};
+
+	static_assert(sizeof(s_AntiAliasingModes) / sizeof(s_AntiAliasingModes[0]) == (size_t)AntiAliasingMode::Count, "Every anti-aliasing mode needs an entry");
+
+	const char* GetAntiAliasingModeName(AntiAliasingMode mode)
+	{
+		return s_AntiAliasingModes[(uint32_t)mode].Name;
+	}
+
+	uint8_t GetAntiAliasingSamples(AntiAliasingMode mode)
+	{
+		return s_AntiAliasingModes[(uint32_t)mode].Samples;
+	}
+
+	static float Halton(uint32_t index, uint32_t base)
+	{
+		float fraction = 1.0f, result = 0.0f;
+		while (index > 0)
+		{
+			fraction /= (float)base;
+			result += fraction * (float)(index % base);
+			index /= base;
+		}
+
+		return result;
+	}
+
+	TemporalAntiAliasing::~TemporalAntiAliasing()
+	{
+		if (m_Textures[0])
+		{
+			glDeleteTextures(2, m_Textures);
+			StateCache::ForgetTexture(m_Textures[0]);
+			StateCache::ForgetTexture(m_Textures[1]);
+		}
+	}
+
+	void TemporalAntiAliasing::BeginFrame(RenderGraph& graph, const glm::mat4& view, const glm::mat4& projection, uint32_t width, uint32_t height, uint32_t renderWidth, uint32_t renderHeight)
+	{
+		if (width != m_Width || height != m_Height)
+		{
+			if (m_Textures[0])
+			{
+				graph.ForgetTexture(m_Textures[0]);
+				graph.ForgetTexture(m_Textures[1]);
+				glDeleteTextures(2, m_Textures);
+				StateCache::ForgetTexture(m_Textures[0]);
+				StateCache::ForgetTexture(m_Textures[1]);
+			}
+
+			glCreateTextures(GL_TEXTURE_2D, 2, m_Textures);
+			for (uint32_t texture : m_Textures)
+			{
+				glTextureStorage2D(texture, 1, GL_RGBA8, width, height);
+				glTextureParameteri(texture, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+				glTextureParameteri(texture, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+				glTextureParameteri(texture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+				glTextureParameteri(texture, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+				glObjectLabel(GL_TEXTURE, texture, -1, "TAA History");
+			}
+
+			m_Width = width;
+			m_Height = height;
+			m_HistoryValid = false;
+		}
+		else
+		{
+			// The target of the last frame is the history now
+			m_HistoryValid = m_Frame > 0;
+			m_Current ^= 1;
+		}
+
+		// Offset in pixels within [-0.5, 0.5], moved to clip space through the projection so every shader picks it up
+		uint32_t index = m_Frame % s_JitterSamples + 1;
+		glm::vec2 jitter = { Halton(index, 2) - 0.5f, Halton(index, 3) - 0.5f };
+
+		m_JitteredProjection = projection;
+		m_JitteredProjection[2][0] += 2.0f * jitter.x / (float)renderWidth;
+		m_JitteredProjection[2][1] += 2.0f * jitter.y / (float)renderHeight;
+
+		m_PreviousViewProjection = m_ViewProjection;
+		m_ViewProjection = projection * view;
+		m_JitteredViewProjection = m_JitteredProjection * view;
+
+		m_Frame++;
+	}
+
+	void TemporalAntiAliasing::Reset()
+	{
+		m_Frame = 0;
+		m_HistoryValid = false;
+	}
+
+	glm::mat4 TemporalAntiAliasing::GetReprojection() const
+	{
+		// The history converged to the unjittered image, so the last frame is addressed without jitter
+		return m_PreviousViewProjection * glm::inverse(m_JitteredViewProjection);
+	}
+
+	float TemporalAntiAliasing::GetHistoryWeight() const
+	{
+		return m_HistoryValid ? s_HistoryWeight : 0.0f;
+	}
+
+}
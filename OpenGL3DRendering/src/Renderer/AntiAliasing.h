@@ -0,0 +1,58 @@
+#pragma once
+#include <stdint.h>
+#include <glm/glm.hpp>
+
+#include "Renderer/RenderGraph.h"
+
+// Anti-aliasing modes of the renderer and the state of the temporal anti-aliasing
+// MSAA renders into multisampled targets and resolves them, all other modes render the scene with one sample and filter the image:
+// FXAA (one pass), SMAA 1x (edge detection, blending weights, neighbourhood blending) and TAA (jittered projection, reprojected history)
+
+namespace OpenGLRendering {
+
+	enum class AntiAliasingMode : uint8_t
+	{
+		Off = 0, FXAA, SMAA, TAA, MSAA2x, MSAA4x, MSAA8x, Count
+	};
+
+	const char* GetAntiAliasingModeName(AntiAliasingMode mode);
+	uint8_t GetAntiAliasingSamples(AntiAliasingMode mode); // Samples of the scene render targets
+
+	// Sub-pixel jitter of the projection and the two history textures the resolve alternates between
+	class TemporalAntiAliasing
+	{
+	public:
+		TemporalAntiAliasing() = default;
+		~TemporalAntiAliasing();
+
+		TemporalAntiAliasing(const TemporalAntiAliasing&) = delete;
+		TemporalAntiAliasing& operator=(const TemporalAntiAliasing&) = delete;
+
+		// Advances the jitter sequence, the matrices of the last frame are kept for the reprojection
+		// The histories are imported into the graph, so it has to forget them when they are recreated for a new size
+		// The histories have the output size, the jitter is a sub-pixel offset of the (possibly smaller) render size
+		void BeginFrame(RenderGraph& graph, const glm::mat4& view, const glm::mat4& projection, uint32_t width, uint32_t height, uint32_t renderWidth, uint32_t renderHeight);
+		void Reset(); // The next frame starts without history, e.g. after the mode was switched
+
+		const glm::mat4& GetJitteredProjection() const { return m_JitteredProjection; }
+		glm::mat4 GetReprojection() const; // Clip space of this frame (jittered) to clip space of the last frame
+		float GetHistoryWeight() const; // 0 while there is no usable history
+
+		uint32_t GetHistoryTexture() const { return m_Textures[m_Current ^ 1]; }
+		uint32_t GetTargetTexture() const { return m_Textures[m_Current]; } // Becomes the history of the next frame
+		RenderTargetDesc GetDesc() const { return { m_Width, m_Height }; }
+
+	private:
+		uint32_t m_Textures[2] = {};
+		uint32_t m_Width = 0, m_Height = 0;
+		uint32_t m_Current = 0;
+		uint32_t m_Frame = 0;
+		bool m_HistoryValid = false;
+
+		glm::mat4 m_JitteredProjection = glm::mat4(1.0f);
+		glm::mat4 m_JitteredViewProjection = glm::mat4(1.0f);
+		glm::mat4 m_ViewProjection = glm::mat4(1.0f);
+		glm::mat4 m_PreviousViewProjection = glm::mat4(1.0f);
+	};
+
+}
@@ -0,0 +1,77 @@
+#include "oglpch.h"
+
+#include "BrdfLut.h"
+#include "Renderer/IBLCache.h"
+#include "Renderer/RendererAPI.h"
+#include "Renderer/Shader.h"
+#include "Renderer/StateCache.h"
+
+#include <glad/glad.h>
+
+namespace OpenGLRendering {
+
+	static const uint32_t s_BrdfLutSize = 512;
+
+	static const char* s_BrdfVertexShader = "src/Resources/ShaderSource/Conversion/brdf_vertex.glsl";
+	static const char* s_BrdfFragmentShader = "src/Resources/ShaderSource/Conversion/brdf_fragment.glsl";
+	static const char* s_CacheName = "brdf_lut";
+
+	BrdfLut::BrdfLut(const Ref<VertexArray>& quadVertexArray)
+	{
+		OGL_PROFILE_FUNCTION();
+
+		glCreateTextures(GL_TEXTURE_2D, 1, &m_TextureId);
+		glTextureStorage2D(m_TextureId, 1, GL_RG16F, s_BrdfLutSize, s_BrdfLutSize);
+		glTextureParameteri(m_TextureId, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTextureParameteri(m_TextureId, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glTextureParameteri(m_TextureId, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTextureParameteri(m_TextureId, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glObjectLabel(GL_TEXTURE, m_TextureId, -1, "BRDF LUT");
+
+		uint64_t key = IBLCache::HashFile(s_BrdfFragmentShader, IBLCache::HashFile(s_BrdfVertexShader));
+		key = IBLCache::Hash(&s_BrdfLutSize, sizeof(s_BrdfLutSize), key);
+
+		std::vector<IBLCacheLevel> levels = { IBLCache::GetLevel(m_TextureId, 0, s_BrdfLutSize, 1, GL_RG, 2) };
+		if (!IBLCache::Load(s_CacheName, key, levels))
+		{
+			Generate(quadVertexArray);
+			IBLCache::Save(s_CacheName, key, levels);
+		}
+	}
+
+	BrdfLut::~BrdfLut()
+	{
+		glDeleteTextures(1, &m_TextureId);
+		StateCache::ForgetTexture(m_TextureId);
+	}
+
+	void BrdfLut::Bind(uint32_t slot) const
+	{
+		StateCache::BindTexture(slot, m_TextureId);
+	}
+
+	void BrdfLut::Generate(const Ref<VertexArray>& quadVertexArray)
+	{
+		OGL_PROFILE_FUNCTION();
+
+		Shader brdfShader(s_BrdfVertexShader, s_BrdfFragmentShader);
+
+		// A fullscreen quad into the texture, no depth attachment is needed
+		uint32_t framebuffer = 0;
+		glCreateFramebuffers(1, &framebuffer);
+		glNamedFramebufferTexture(framebuffer, GL_COLOR_ATTACHMENT0, m_TextureId, 0);
+
+		glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+		glViewport(0, 0, s_BrdfLutSize, s_BrdfLutSize);
+		brdfShader.Bind();
+
+		RendererAPI::DrawIndexed(quadVertexArray, 0);
+
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		glDeleteFramebuffers(1, &framebuffer);
+
+		// The generation binds the framebuffer, program and viewport directly
+		StateCache::Invalidate();
+	}
+
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <stdint.h>
+
+#include "Renderer/VertexArray.h"
+
+// Split sum lookup texture of the specular image based lighting: scale and bias of F0 (rg) by NdotV (x) and roughness (y)
+// It only depends on the BRDF, so the renderer creates one at startup and shares it between all environments; the texture is
+// rendered once and kept in the IBL cache afterwards
+
+namespace OpenGLRendering {
+
+	class BrdfLut
+	{
+	public:
+		BrdfLut(const Ref<VertexArray>& quadVertexArray); // Fullscreen quad, position at location 0 and texture coordinates at 1
+		~BrdfLut();
+
+		BrdfLut(const BrdfLut&) = delete;
+		BrdfLut& operator=(const BrdfLut&) = delete;
+
+		void Bind(uint32_t slot) const;
+
+	private:
+		void Generate(const Ref<VertexArray>& quadVertexArray);
+
+	private:
+		uint32_t m_TextureId = 0;
+	};
+
+}
@@ -2,10 +2,12 @@
 
 #include "Cubemap.h"
 #include "Renderer/RendererAPI.h"
+#include "Renderer/StateCache.h"
 
 #include <stb_image.h>
 #include <glad/glad.h>
 #include <glm/glm.hpp>
+#include <filesystem>
 
 
 // Static cube geometry, matrices and settings
@@ -22,6 +24,13 @@ static const glm::mat4 s_Projection = glm::perspective(glm::radians(90.0f), 1.0f
 
 static const uint32_t s_FramebufferWidth = 512;
 static const uint32_t s_FramebufferHeight = 512;
+static const uint32_t s_PrefilterSize = 128;
+
+// Shaders of the precomputation, their sources are part of the cache key
+static const char* s_ConversionVertexShader = "src/Resources/ShaderSource/Conversion/conversion_vertex.glsl";
+static const char* s_EquirectangularFragmentShader = "src/Resources/ShaderSource/Conversion/equirectengular_conversion_fragment.glsl";
+static const char* s_PrefilterVertexShader = "src/Resources/ShaderSource/Conversion/cubemap_vertex.glsl";
+static const char* s_PrefilterFragmentShader = "src/Resources/ShaderSource/Conversion/prefilter_fragment.glsl";
 
 static float s_CubeVertexBuffer[]
 {
@@ -53,6 +62,19 @@ static uint32_t s_CubeIndexBuffer[] =
 
 namespace OpenGLRendering {
 
+	// Everything the maps depend on: the HDR file, the generation shaders and the map sizes
+	static uint64_t ComputeCacheKey(const std::string& filepath, uint32_t prefilterMipLevels)
+	{
+		OGL_PROFILE_FUNCTION();
+
+		uint64_t hash = IBLCache::HashFile(filepath);
+		for (const char* shader : { s_ConversionVertexShader, s_EquirectangularFragmentShader, s_PrefilterVertexShader, s_PrefilterFragmentShader })
+			hash = IBLCache::HashFile(shader, hash);
+
+		uint32_t sizes[] = { s_FramebufferWidth, s_PrefilterSize, prefilterMipLevels };
+		return IBLCache::Hash(sizes, sizeof(sizes), hash);
+	}
+
 	Cubemap::Cubemap(const std::string& filepath)
 	{
 		Initialize(filepath);
@@ -62,40 +84,29 @@ namespace OpenGLRendering {
 	{
 		glDeleteTextures(1, &m_CubemapTextureId);
 		glDeleteTextures(1, &m_EnvironmentMapId);
-		glDeleteTextures(1, &m_IrradianceMapId);
 		glDeleteTextures(1, &m_PrefilterMapId);
-		glDeleteTextures(1, &m_BrdfLutTexture);
 
 		glDeleteRenderbuffers(1, &m_RenderbufferAttachmentId);
 		glDeleteFramebuffers(1, &m_FramebufferId);
-	}
 
-	void Cubemap::BindEnvironmentMap(uint32_t slot)
-	{
-		glActiveTexture(GL_TEXTURE0 + slot);
-		glBindTexture(GL_TEXTURE_CUBE_MAP, m_EnvironmentMapId);
+		StateCache::ForgetTexture(m_EnvironmentMapId);
+		StateCache::ForgetTexture(m_PrefilterMapId);
 	}
 
-	void Cubemap::BindIrradianceMap(uint32_t slot)
+	void Cubemap::BindEnvironmentMap(uint32_t slot)
 	{
-		glActiveTexture(GL_TEXTURE0 + slot);
-		glBindTexture(GL_TEXTURE_CUBE_MAP, m_IrradianceMapId);
+		StateCache::BindTexture(slot, m_EnvironmentMapId);
 	}
 
 	void Cubemap::BindPrefilterMap(uint32_t slot)
 	{
-		glActiveTexture(GL_TEXTURE0 + slot);
-		glBindTexture(GL_TEXTURE_CUBE_MAP, m_PrefilterMapId);
-	}
-
-	void Cubemap::BindBrdfLutTexture(uint32_t slot)
-	{
-		glActiveTexture(GL_TEXTURE0 + slot);
-		glBindTexture(GL_TEXTURE_2D, m_BrdfLutTexture);
+		StateCache::BindTexture(slot, m_PrefilterMapId);
 	}
 
 	void Cubemap::Initialize(const std::string& filepath)
 	{
+		OGL_PROFILE_FUNCTION();
+
 		glEnable(GL_TEXTURE_CUBE_MAP_SEAMLESS);
 		glDepthFunc(GL_LEQUAL);
 
@@ -113,6 +124,51 @@ namespace OpenGLRendering {
 		m_VertexArray->AddVertexBuffer(vb);
 		m_VertexArray->SetIndexBuffer(ib);
 
+		CreateTextures();
+
+		// Cache files are named after the HDR file and a hash of its full path, so equally named files in different folders
+		// (or one called brdf_lut) don't share a cache file, a changed key overwrites it
+		uint64_t key = ComputeCacheKey(filepath, m_PrefilterMipLevels);
+		std::string absolutePath = std::filesystem::absolute(filepath).lexically_normal().string();
+		char pathHash[17];
+		snprintf(pathHash, sizeof(pathHash), "%016llx", (unsigned long long)IBLCache::Hash(absolutePath.data(), absolutePath.size()));
+		std::string cacheName = std::filesystem::path(filepath).stem().string() + "_" + pathHash;
+
+		if (!IBLCache::Load(cacheName, key, GetCacheLevels(), &m_IrradianceSH, sizeof(IrradianceSH)))
+		{
+			GenerateMaps(filepath);
+			IBLCache::Save(cacheName, key, GetCacheLevels(), &m_IrradianceSH, sizeof(IrradianceSH));
+		}
+
+		// The precomputation binds textures, framebuffers and viewports directly
+		StateCache::Invalidate();
+	}
+
+	void Cubemap::CreateTextures()
+	{
+		// Immutable storage, the maps are either rendered to or uploaded from the cache
+		uint32_t cubemaps[] = { 0, 0 };
+		glCreateTextures(GL_TEXTURE_CUBE_MAP, 2, cubemaps);
+		m_EnvironmentMapId = cubemaps[0];
+		m_PrefilterMapId = cubemaps[1];
+
+		glTextureStorage2D(m_EnvironmentMapId, 1, GL_RGB16F, s_FramebufferWidth, s_FramebufferHeight);
+		glTextureStorage2D(m_PrefilterMapId, m_PrefilterMipLevels, GL_RGB16F, s_PrefilterSize, s_PrefilterSize);
+
+		for (uint32_t texture : cubemaps)
+		{
+			glTextureParameteri(texture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+			glTextureParameteri(texture, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+			glTextureParameteri(texture, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+			glTextureParameteri(texture, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+			glTextureParameteri(texture, GL_TEXTURE_MIN_FILTER, texture == m_PrefilterMapId ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+		}
+	}
+
+	void Cubemap::GenerateMaps(const std::string& filepath)
+	{
+		OGL_PROFILE_FUNCTION();
+
 		// Load image data
 		int width, height, channels;
 		stbi_set_flip_vertically_on_load(true);
@@ -130,40 +186,29 @@ namespace OpenGLRendering {
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
+		// The diffuse lighting is projected from the image on the CPU, it doesn't need the cube map
+		m_IrradianceSH = ComputeIrradianceSH(data, (uint32_t)width, (uint32_t)height, (uint32_t)channels);
+
 		stbi_image_free(data);
 
+		// Setup framebuffer for capturing the cube maps
+		glGenFramebuffers(1, &m_FramebufferId);
+		glGenRenderbuffers(1, &m_RenderbufferAttachmentId);
+
 		// Environment map
 		{
 			// Compile and link conversion shader
-			Shader conversionShader("src/Resources/ShaderSource/Conversion/conversion_vertex.glsl", "src/Resources/ShaderSource/Conversion/equirectengular_conversion_fragment.glsl");
+			Shader conversionShader(s_ConversionVertexShader, s_EquirectangularFragmentShader);
 
 			conversionShader.Bind();
 			conversionShader.SetInt("u_EquirectengularMap", 0);
 			conversionShader.SetMat4("u_Projection", s_Projection);
 
-			// Setup framebuffer for capturing the cube map
-			glGenFramebuffers(1, &m_FramebufferId);
-			glGenRenderbuffers(1, &m_RenderbufferAttachmentId);
-
 			glBindFramebuffer(GL_FRAMEBUFFER, m_FramebufferId);
 			glBindRenderbuffer(GL_RENDERBUFFER, m_RenderbufferAttachmentId);
 			glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, s_FramebufferWidth, s_FramebufferHeight);
 			glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, m_RenderbufferAttachmentId);
 
-			glCreateTextures(GL_TEXTURE_CUBE_MAP, 1, &m_EnvironmentMapId);
-			glBindTexture(GL_TEXTURE_CUBE_MAP, m_EnvironmentMapId);
-
-			for (unsigned int i = 0; i < 6; i++)
-			{
-				glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGB16F, s_FramebufferWidth, s_FramebufferHeight, 0, GL_RGB, GL_FLOAT, nullptr);
-			}
-
-			glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-			glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-			glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
-			glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-			glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-
 			// Render cube map to framebuffer
 			glViewport(0, 0, s_FramebufferWidth, s_FramebufferHeight);
 
@@ -181,73 +226,10 @@ namespace OpenGLRendering {
 			glBindFramebuffer(GL_FRAMEBUFFER, 0);
 		}
 
-		// Irradiance map
-		{		
-			// Compile and link irradiance conversion shader
-			Shader irradianceConversionShader("src/Resources/ShaderSource/Conversion/conversion_vertex.glsl", "src/Resources/ShaderSource/Conversion/irradiance_conversion_fragment.glsl");
-
-			// Create irradiance texture
-			glCreateTextures(GL_TEXTURE_CUBE_MAP, 1, &m_IrradianceMapId);
-			glBindTexture(GL_TEXTURE_CUBE_MAP, m_IrradianceMapId);
-
-			for (unsigned int i = 0; i < 6; i++)
-			{
-				glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGB16F, 32, 32, 0, GL_RGB, GL_FLOAT, nullptr);
-			}
-
-			glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-			glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-			glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
-			glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-			glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-
-			glBindFramebuffer(GL_FRAMEBUFFER, m_FramebufferId);
-			glBindRenderbuffer(GL_RENDERBUFFER, m_RenderbufferAttachmentId);
-			glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, 32, 32);
-
-			irradianceConversionShader.Bind();
-			irradianceConversionShader.SetInt("u_EnvironmentMap", 0);
-			irradianceConversionShader.SetMat4("u_Projection", s_Projection);
-
-			glActiveTexture(GL_TEXTURE0);
-			glBindTexture(GL_TEXTURE_CUBE_MAP, m_EnvironmentMapId);
-
-			glViewport(0, 0, 32, 32);
-
-			// Render irradiance map to framebuffer / texture
-			for (unsigned int i = 0; i < 6; i++)
-			{
-				irradianceConversionShader.SetMat4("u_View", s_Views[i]);
-				glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, m_IrradianceMapId, 0);
-				glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-				RendererAPI::DrawIndexed(m_VertexArray, 0);
-			}
-
-			glBindFramebuffer(GL_FRAMEBUFFER, 0);
-		}
-
 		// Prefilter map
 		{
 			// Compile and link prefilter shader
-			Shader prefilterShader("src/Resources/ShaderSource/Conversion/cubemap_vertex.glsl", "src/Resources/ShaderSource/Conversion/prefilter_fragment.glsl");
-
-			// Generate prefilter map
-			glCreateTextures(GL_TEXTURE_CUBE_MAP, 1, &m_PrefilterMapId);
-			glBindTexture(GL_TEXTURE_CUBE_MAP, m_PrefilterMapId);
-
-			for (unsigned int i = 0; i < 6; i++)
-			{
-				glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGB16F, 128, 128, 0, GL_RGB, GL_FLOAT, nullptr);
-			}
-
-			glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-			glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-			glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
-			glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-			glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-			
-			glGenerateMipmap(GL_TEXTURE_CUBE_MAP);
+			Shader prefilterShader(s_PrefilterVertexShader, s_PrefilterFragmentShader);
 
 			prefilterShader.Bind();
 			prefilterShader.SetInt("u_EnvironmentMap", 0);
@@ -256,11 +238,11 @@ namespace OpenGLRendering {
 			glBindTexture(GL_TEXTURE_CUBE_MAP, m_EnvironmentMapId);
 
 			glBindFramebuffer(GL_FRAMEBUFFER, m_FramebufferId);
-			unsigned int maxMipLevels = 5;
+			unsigned int maxMipLevels = m_PrefilterMipLevels;
 			for (unsigned int mip = 0; mip < maxMipLevels; mip++)
 			{
-				unsigned int mipWidth = 128 * pow(0.5, mip);
-				unsigned int mipHeight = 128 * pow(0.5, mip);
+				unsigned int mipWidth = s_PrefilterSize >> mip;
+				unsigned int mipHeight = s_PrefilterSize >> mip;
 
 				glBindRenderbuffer(GL_RENDERBUFFER, m_RenderbufferAttachmentId);
 				glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, mipWidth, mipHeight);
@@ -280,60 +262,15 @@ namespace OpenGLRendering {
 			}
 			glBindFramebuffer(GL_FRAMEBUFFER, 0);
 		}
+	}
 
-		// BRDF LUT texture
-		{
-			Shader brdfShader("src/Resources/ShaderSource/Conversion/brdf_vertex.glsl", "src/Resources/ShaderSource/Conversion/brdf_fragment.glsl");
-
-			glCreateTextures(GL_TEXTURE_2D, 1, &m_BrdfLutTexture);
-			glBindTexture(GL_TEXTURE_2D, m_BrdfLutTexture);
-
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RG16F, 512, 512, 0, GL_RG, GL_FLOAT, 0);
-
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-			glBindFramebuffer(GL_FRAMEBUFFER, m_FramebufferId);
-			glBindRenderbuffer(GL_RENDERBUFFER, m_RenderbufferAttachmentId);
-			glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, 512, 512);
-			glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_BrdfLutTexture, 0);
-
-			glViewport(0, 0, 512, 512);
-			brdfShader.Bind();
-
-			float quadVertices[] =
-			{
-				-1.0f, -1.0f, 0.0f, 0.0f,
-				 1.0f, -1.0f, 1.0f, 0.0f,
-				 1.0f,  1.0f, 1.0f, 1.0f,
-				-1.0f,  1.0f, 0.0f, 1.0f,
-			};
-
-			uint32_t quadIndices[] =
-			{
-				0, 1, 2,
-				0, 2, 3,
-			};
-
-			Ref<VertexBuffer> vb = CreateRef<VertexBuffer>(quadVertices, 4 * 4 * 4);
-			vb->SetLayout(
-			{
-				{ ShaderDataType::Float2, "a_Position" },
-				{ ShaderDataType::Float2, "a_TexCoords" },
-			});
-
-			Ref<IndexBuffer> ib = CreateRef<IndexBuffer>(quadIndices, 2 * 3);
-
-			Ref<VertexArray> va = CreateRef<VertexArray>();
-			va->AddVertexBuffer(vb);
-			va->SetIndexBuffer(ib);
-
-			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-			RendererAPI::DrawIndexed(va, 0);
+	std::vector<IBLCacheLevel> Cubemap::GetCacheLevels() const
+	{
+		std::vector<IBLCacheLevel> levels;
+		levels.push_back(IBLCache::GetLevel(m_EnvironmentMapId, 0, s_FramebufferWidth, 6, GL_RGB, 3));
+		for (uint32_t mip = 0; mip < m_PrefilterMipLevels; mip++)
+			levels.push_back(IBLCache::GetLevel(m_PrefilterMapId, mip, s_PrefilterSize, 6, GL_RGB, 3));
 
-			glBindFramebuffer(GL_FRAMEBUFFER, 0);
-		}
+		return levels;
 	}
-}
\ No newline at end of file
+}
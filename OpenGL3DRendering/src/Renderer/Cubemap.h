@@ -2,9 +2,17 @@
 
 #include <string>
 #include <memory>
+#include <vector>
 
 #include "Renderer/Shader.h"
 #include "Renderer/VertexArray.h"
+#include "Renderer/SphericalHarmonics.h"
+#include "Renderer/IBLCache.h"
+
+// Image based lighting of an HDR environment: the environment cube map, the prefiltered specular mip chain and the diffuse irradiance
+// as spherical harmonics. Generating them takes several render passes, so the results are stored in the IBL cache keyed by a hash of
+// the HDR file, the generation shaders and sizes; a warm cache is uploaded directly without any render pass
+// The BRDF lookup texture doesn't depend on the environment, the renderer shares one between all of them
 
 namespace OpenGLRendering {
 
@@ -15,24 +23,27 @@ namespace OpenGLRendering {
 		~Cubemap();
 
 		void BindEnvironmentMap(uint32_t slot);
-		void BindIrradianceMap(uint32_t slot);
 		void BindPrefilterMap(uint32_t slot);
-		void BindBrdfLutTexture(uint32_t slot);
 
 		Ref<VertexArray> GetVertexArray() { return m_VertexArray; }
+		uint32_t GetPrefilterMipLevels() const { return m_PrefilterMipLevels; }
+		const IrradianceSH& GetIrradianceSH() const { return m_IrradianceSH; }
 
 	private:
 		void Initialize(const std::string& filepath);
+		void CreateTextures();
+		void GenerateMaps(const std::string& filepath);
+		std::vector<IBLCacheLevel> GetCacheLevels() const; // In file order
 
 	private:
-		uint32_t m_CubemapTextureId;
-		uint32_t m_EnvironmentMapId;
-		uint32_t m_IrradianceMapId;
-		uint32_t m_PrefilterMapId;
-		uint32_t m_BrdfLutTexture;
-
-		uint32_t m_RenderbufferAttachmentId;
-		uint32_t m_FramebufferId;
+		uint32_t m_CubemapTextureId = 0; // Equirectangular source, only loaded without a cache
+		uint32_t m_EnvironmentMapId = 0;
+		uint32_t m_PrefilterMapId = 0;
+
+		uint32_t m_RenderbufferAttachmentId = 0;
+		uint32_t m_FramebufferId = 0;
+		uint32_t m_PrefilterMipLevels = 5;
+		IrradianceSH m_IrradianceSH = {};
 
 		Ref<VertexArray> m_VertexArray;
 	};
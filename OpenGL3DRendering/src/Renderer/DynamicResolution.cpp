@@ -0,0 +1,51 @@
+#include "oglpch.h"
+
+#include "DynamicResolution.h"
+
+#include <cmath>
+
+namespace OpenGLRendering {
+
+	// Headroom below the target frame time that is needed before the scale grows again, so it doesn't flicker around the target
+	static const float s_Tolerance = 0.05f;
+
+	// Share of the step towards the estimated scale taken per frame, the timings lag behind, so a full step would overshoot
+	static const float s_AdjustRate = 0.1f;
+
+	void DynamicResolution::Update(float gpuFrameTime)
+	{
+		if (!m_Settings.Enabled)
+		{
+			m_Scale = 1.0f;
+			return;
+		}
+
+		// No timings yet
+		if (gpuFrameTime <= 0.0f)
+			return;
+
+		// Frames over the target always lower the scale, so it settles just below the target
+		if (gpuFrameTime > m_Settings.TargetFrameTime || gpuFrameTime < m_Settings.TargetFrameTime * (1.0f - s_Tolerance))
+		{
+			// The GPU time grows with the pixel count, the square of the scale
+			float estimatedScale = m_Scale * std::sqrt(m_Settings.TargetFrameTime / gpuFrameTime);
+			m_Scale += (estimatedScale - m_Scale) * s_AdjustRate;
+		}
+
+		m_Scale = std::min(std::max(m_Scale, m_Settings.MinScale), m_Settings.MaxScale);
+	}
+
+	void DynamicResolution::SetSettings(const DynamicResolutionSettings& settings)
+	{
+		OGL_ASSERT(settings.MinScale > 0.0f && settings.MinScale <= settings.MaxScale && settings.MaxScale <= 1.0f, "Invalid dynamic resolution scale range");
+
+		m_Settings = settings;
+		m_Scale = std::min(std::max(m_Scale, m_Settings.MinScale), m_Settings.MaxScale);
+	}
+
+	uint32_t DynamicResolution::GetRenderSize(uint32_t size) const
+	{
+		return std::max((uint32_t)((float)size * m_Scale + 0.5f), 1u);
+	}
+
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include <stdint.h>
+
+// Dynamic resolution: the scene is rendered into the lower left part of the full size targets and upscaled afterwards,
+// the scale follows the GPU frame time towards a target, so heavy scenes lose resolution instead of frame rate
+// Changing the scale never reallocates render targets, only the viewport of the scene passes changes
+
+namespace OpenGLRendering {
+
+	struct DynamicResolutionSettings
+	{
+		bool Enabled = false;
+		float TargetFrameTime = 16.6f; // GPU milliseconds
+		float MinScale = 0.5f; // Per axis
+		float MaxScale = 1.0f;
+		float Sharpness = 0.5f; // Of the upscale, 0 - 1
+	};
+
+	class DynamicResolution
+	{
+	public:
+		// Moves the scale towards the target frame time, the GPU timings are a few frames old
+		void Update(float gpuFrameTime);
+
+		void SetSettings(const DynamicResolutionSettings& settings);
+		const DynamicResolutionSettings& GetSettings() const { return m_Settings; }
+
+		float GetScale() const { return m_Scale; }
+		uint32_t GetRenderSize(uint32_t size) const; // Scaled size of one axis, at least 1
+
+	private:
+		DynamicResolutionSettings m_Settings;
+		float m_Scale = 1.0f;
+	};
+
+}
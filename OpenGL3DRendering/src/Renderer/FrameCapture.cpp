@@ -0,0 +1,173 @@
+#include "oglpch.h"
+
+#include "FrameCapture.h"
+
+#include <glad/glad.h>
+
+namespace OpenGLRendering {
+
+	// Frames waiting for the worker, the render thread blocks beyond this instead of buffering without limit
+	static const uint32_t s_MaxQueuedFrames = 8;
+
+	FrameCapture::FrameCapture(const FrameCallbackFn& callback, uint32_t ringSize)
+		: m_Callback(callback), m_Slots(std::max(ringSize, 1u))
+	{
+		m_Worker = std::thread(&FrameCapture::WorkerLoop, this);
+	}
+
+	FrameCapture::~FrameCapture()
+	{
+		Flush();
+
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_Running = false;
+		}
+		m_Condition.notify_all();
+		m_Worker.join();
+
+		for (Slot& slot : m_Slots)
+		{
+			if (slot.Buffer)
+				glDeleteBuffers(1, &slot.Buffer);
+		}
+	}
+
+	void FrameCapture::Capture(uint32_t textureId, uint32_t width, uint32_t height)
+	{
+		OGL_PROFILE_FUNCTION();
+
+		Poll();
+
+		// The ring is full if the next slot is still pending, its copy is the oldest one and has to finish first
+		Slot& slot = m_Slots[m_Next];
+		if (slot.Fence)
+		{
+			m_Stalls++;
+			Retire(slot, true);
+		}
+
+		uint32_t size = width * height * 4;
+
+		if (slot.Size != size)
+		{
+			if (slot.Buffer)
+				glDeleteBuffers(1, &slot.Buffer);
+
+			glCreateBuffers(1, &slot.Buffer);
+			glNamedBufferData(slot.Buffer, size, nullptr, GL_STREAM_READ);
+			slot.Size = size;
+		}
+
+		// With a pack buffer bound the copy goes into the buffer and returns immediately
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.Buffer);
+		glPixelStorei(GL_PACK_ALIGNMENT, 1);
+		glGetTextureImage(textureId, 0, GL_RGBA, GL_UNSIGNED_BYTE, size, nullptr);
+		glPixelStorei(GL_PACK_ALIGNMENT, 4);
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+		slot.Fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		slot.Index = m_CapturedFrames++;
+		slot.Width = width;
+		slot.Height = height;
+
+		m_Next = (m_Next + 1) % (uint32_t)m_Slots.size();
+	}
+
+	void FrameCapture::Poll()
+	{
+		// Frames are retired in capture order, starting with the oldest pending slot
+		for (uint32_t i = 0; i < m_Slots.size(); i++)
+		{
+			Slot& slot = m_Slots[(m_Next + i) % m_Slots.size()];
+			if (slot.Fence && !Retire(slot, false))
+				break;
+		}
+	}
+
+	void FrameCapture::Flush()
+	{
+		for (uint32_t i = 0; i < m_Slots.size(); i++)
+		{
+			Slot& slot = m_Slots[(m_Next + i) % m_Slots.size()];
+			if (slot.Fence)
+				Retire(slot, true);
+		}
+
+		std::unique_lock<std::mutex> lock(m_Mutex);
+		m_Condition.wait(lock, [this]() { return m_Queue.empty() && !m_WorkerBusy; });
+	}
+
+	bool FrameCapture::Retire(Slot& slot, bool wait)
+	{
+		GLsync fence = (GLsync)slot.Fence;
+
+		// The flush makes sure the fence gets signaled even if nothing else flushes the command stream
+		GLenum status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, wait ? GL_TIMEOUT_IGNORED : 0);
+		if (status == GL_TIMEOUT_EXPIRED)
+			return false;
+
+		OGL_ASSERT(status != GL_WAIT_FAILED, "Waiting for a frame capture failed");
+		glDeleteSync(fence);
+		slot.Fence = nullptr;
+
+		CapturedFrame frame;
+		frame.Index = slot.Index;
+		frame.Width = slot.Width;
+		frame.Height = slot.Height;
+
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			if (m_Queue.size() >= s_MaxQueuedFrames)
+			{
+				// The worker is behind, the capture blocks until it has written a frame
+				m_Stalls++;
+				m_Condition.wait(lock, [this]() { return m_Queue.size() < s_MaxQueuedFrames; });
+			}
+
+			if (!m_FreePixels.empty())
+			{
+				frame.Pixels = std::move(m_FreePixels.back());
+				m_FreePixels.pop_back();
+			}
+		}
+
+		const void* data = glMapNamedBufferRange(slot.Buffer, 0, slot.Size, GL_MAP_READ_BIT);
+		frame.Pixels.resize(slot.Size);
+		memcpy(frame.Pixels.data(), data, slot.Size);
+		glUnmapNamedBuffer(slot.Buffer);
+
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_Queue.push_back(std::move(frame));
+		}
+		m_Condition.notify_all();
+
+		return true;
+	}
+
+	void FrameCapture::WorkerLoop()
+	{
+		std::unique_lock<std::mutex> lock(m_Mutex);
+
+		while (true)
+		{
+			m_Condition.wait(lock, [this]() { return !m_Queue.empty() || !m_Running; });
+			if (m_Queue.empty())
+				return;
+
+			CapturedFrame frame = std::move(m_Queue.front());
+			m_Queue.pop_front();
+			m_WorkerBusy = true;
+
+			lock.unlock();
+			m_Callback(frame);
+			lock.lock();
+
+			m_FreePixels.push_back(std::move(frame.Pixels));
+			m_WorkerBusy = false;
+			m_Condition.notify_all();
+		}
+	}
+
+}
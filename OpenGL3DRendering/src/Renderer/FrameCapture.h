@@ -0,0 +1,67 @@
+#pragma once
+#include <stdint.h>
+#include <vector>
+#include <deque>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+// Asynchronous readback of RGBA8 render targets (OpenGL abstraction)
+// The pixels are copied into a ring of pixel buffer objects and a fence per copy tells when the GPU is done,
+// so the buffer is only mapped once the data is there. Finished frames are handed to a worker thread (PNG encoding, streaming)
+
+namespace OpenGLRendering {
+
+	struct CapturedFrame
+	{
+		uint64_t Index; // Number of the capture, starting at 0
+		uint32_t Width, Height;
+		std::vector<uint8_t> Pixels; // RGBA8, bottom row first
+	};
+
+	class FrameCapture
+	{
+	public:
+		using FrameCallbackFn = std::function<void(const CapturedFrame&)>; // Runs on the worker thread
+
+		FrameCapture(const FrameCallbackFn& callback, uint32_t ringSize = 3);
+		~FrameCapture(); // Waits for all outstanding frames
+
+		void Capture(uint32_t textureId, uint32_t width, uint32_t height);
+		void Poll(); // Hands finished readbacks to the worker without waiting, call once per frame
+		void Flush(); // Waits until all captured frames went through the callback
+
+		uint64_t GetCapturedFrames() const { return m_CapturedFrames; }
+		uint32_t GetStalls() const { return m_Stalls; } // Waits for the GPU (the ring was full) or for the writer thread (the queue was full)
+
+	private:
+		struct Slot
+		{
+			uint32_t Buffer = 0;
+			uint32_t Size = 0;
+			void* Fence = nullptr; // Pending while set
+			uint64_t Index = 0;
+			uint32_t Width = 0, Height = 0;
+		};
+
+		bool Retire(Slot& slot, bool wait);
+		void WorkerLoop();
+
+	private:
+		FrameCallbackFn m_Callback;
+		std::vector<Slot> m_Slots;
+		uint32_t m_Next = 0; // Next slot to write, the oldest pending readback if the ring is full
+		uint64_t m_CapturedFrames = 0;
+		uint32_t m_Stalls = 0;
+
+		std::thread m_Worker;
+		std::mutex m_Mutex;
+		std::condition_variable m_Condition;
+		std::deque<CapturedFrame> m_Queue;
+		std::vector<std::vector<uint8_t>> m_FreePixels; // Recycled pixel storage
+		bool m_WorkerBusy = false;
+		bool m_Running = true;
+	};
+
+}
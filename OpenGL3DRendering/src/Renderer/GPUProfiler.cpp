@@ -0,0 +1,153 @@
+#include "oglpch.h"
+
+#include "GPUProfiler.h"
+
+#include <glad/glad.h>
+
+namespace OpenGLRendering {
+
+	static const uint32_t s_RingSize = 3;
+
+	struct PassRecord
+	{
+		const char* Name;
+		uint32_t Depth;
+		uint32_t StartQuery;
+		uint32_t EndQuery;
+	};
+
+	struct FrameQueries
+	{
+		std::vector<GLuint> Queries; // Grown on demand, never shrinks
+		uint32_t UsedQueries = 0;
+		std::vector<PassRecord> Passes;
+		bool Pending = false;
+	};
+
+	struct GPUProfilerData
+	{
+		FrameQueries Frames[s_RingSize];
+		uint32_t Current = 0;
+		std::vector<uint32_t> OpenPasses; // Indices into the passes of the current frame
+
+		std::vector<GPUPassTiming> Timings;
+		uint32_t DroppedFrames = 0;
+	};
+
+	static GPUProfilerData s_ProfilerData;
+
+	static uint32_t WriteTimestamp(FrameQueries& frame)
+	{
+		if (frame.UsedQueries == frame.Queries.size())
+		{
+			uint32_t count = std::max((uint32_t)frame.Queries.size(), 16u);
+			frame.Queries.resize(frame.Queries.size() + count);
+			glCreateQueries(GL_TIMESTAMP, count, &frame.Queries[frame.Queries.size() - count]);
+		}
+
+		glQueryCounter(frame.Queries[frame.UsedQueries], GL_TIMESTAMP);
+		return frame.UsedQueries++;
+	}
+
+	static void CollectResults(FrameQueries& frame)
+	{
+		// Timestamps complete in order, if the last one is available all of them are
+		GLint available = 0;
+		glGetQueryObjectiv(frame.Queries[frame.UsedQueries - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+		if (!available)
+		{
+			s_ProfilerData.DroppedFrames++;
+			return;
+		}
+
+		std::vector<GPUPassTiming>& timings = s_ProfilerData.Timings;
+		timings.clear();
+
+		for (const PassRecord& pass : frame.Passes)
+		{
+			GLuint64 start = 0, end = 0;
+			glGetQueryObjectui64v(frame.Queries[pass.StartQuery], GL_QUERY_RESULT, &start);
+			glGetQueryObjectui64v(frame.Queries[pass.EndQuery], GL_QUERY_RESULT, &end);
+
+			timings.push_back({ pass.Name, pass.Depth, (float)(end - start) / 1000000.0f });
+		}
+	}
+
+	void GPUProfiler::BeginFrame()
+	{
+		s_ProfilerData.Current = (s_ProfilerData.Current + 1) % s_RingSize;
+		FrameQueries& frame = s_ProfilerData.Frames[s_ProfilerData.Current];
+
+		if (frame.Pending)
+			CollectResults(frame);
+
+		frame.UsedQueries = 0;
+		frame.Passes.clear();
+		frame.Pending = false;
+		s_ProfilerData.OpenPasses.clear();
+
+		BeginPass("Frame");
+	}
+
+	void GPUProfiler::EndFrame()
+	{
+		// Passes that were left open are closed together with the frame
+		while (!s_ProfilerData.OpenPasses.empty())
+			EndPass();
+
+		s_ProfilerData.Frames[s_ProfilerData.Current].Pending = true;
+	}
+
+	void GPUProfiler::BeginPass(const char* name)
+	{
+		FrameQueries& frame = s_ProfilerData.Frames[s_ProfilerData.Current];
+
+		glPushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, 0, -1, name);
+
+		s_ProfilerData.OpenPasses.push_back((uint32_t)frame.Passes.size());
+		frame.Passes.push_back({ name, (uint32_t)s_ProfilerData.OpenPasses.size() - 1, WriteTimestamp(frame), 0 });
+	}
+
+	void GPUProfiler::EndPass()
+	{
+		OGL_ASSERT(!s_ProfilerData.OpenPasses.empty(), "EndPass without a matching BeginPass");
+
+		FrameQueries& frame = s_ProfilerData.Frames[s_ProfilerData.Current];
+		frame.Passes[s_ProfilerData.OpenPasses.back()].EndQuery = WriteTimestamp(frame);
+		s_ProfilerData.OpenPasses.pop_back();
+
+		glPopDebugGroup();
+	}
+
+	void GPUProfiler::Shutdown()
+	{
+		for (FrameQueries& frame : s_ProfilerData.Frames)
+		{
+			if (!frame.Queries.empty())
+				glDeleteQueries((GLsizei)frame.Queries.size(), frame.Queries.data());
+
+			frame.Queries.clear();
+			frame.UsedQueries = 0;
+			frame.Passes.clear();
+			frame.Pending = false;
+		}
+
+		s_ProfilerData.OpenPasses.clear();
+	}
+
+	const std::vector<GPUPassTiming>& GPUProfiler::GetPassTimings()
+	{
+		return s_ProfilerData.Timings;
+	}
+
+	float GPUProfiler::GetFrameTime()
+	{
+		return s_ProfilerData.Timings.empty() ? 0.0f : s_ProfilerData.Timings.front().Milliseconds;
+	}
+
+	uint32_t GPUProfiler::GetDroppedFrames()
+	{
+		return s_ProfilerData.DroppedFrames;
+	}
+
+}
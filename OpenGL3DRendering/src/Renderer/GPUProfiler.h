@@ -0,0 +1,43 @@
+#pragma once
+#include <stdint.h>
+#include <vector>
+
+// Measures the GPU time of the render passes with timestamp queries and marks them as KHR_debug groups,
+// so external tools (RenderDoc, Nsight) show the same pass names
+// Every frame uses its own set of queries out of a ring, results are collected when the set is reused a few frames later
+// and dropped if the GPU is still not done with them, so reading them never stalls the pipeline
+
+namespace OpenGLRendering {
+
+	struct GPUPassTiming
+	{
+		const char* Name; // Pass names have to be string literals
+		uint32_t Depth; // Nesting level, 0 for the frame itself
+		float Milliseconds;
+	};
+
+	class GPUProfiler
+	{
+	public:
+		static void BeginFrame();
+		static void EndFrame();
+		static void Shutdown(); // Deletes the queries, has to run while the context exists
+
+		static void BeginPass(const char* name);
+		static void EndPass();
+
+		// Timings of the latest finished frame, the frame is the first entry
+		static const std::vector<GPUPassTiming>& GetPassTimings();
+		static float GetFrameTime();
+		static uint32_t GetDroppedFrames(); // Frames whose results were not available in time
+	};
+
+	// Marks the current scope as a pass
+	class GPUProfilerScope
+	{
+	public:
+		GPUProfilerScope(const char* name) { GPUProfiler::BeginPass(name); }
+		~GPUProfilerScope() { GPUProfiler::EndPass(); }
+	};
+
+}
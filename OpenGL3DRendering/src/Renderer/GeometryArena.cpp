@@ -0,0 +1,84 @@
+#include "oglpch.h"
+
+#include "GeometryArena.h"
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+namespace OpenGLRendering {
+
+	GeometryArena::GeometryArena(GeometryFormat format, const VertexBufferLayout& layout, uint32_t vertexCapacity, uint32_t indexCapacity)
+		: m_Format(format), m_Layout(layout), m_VertexCapacity(0), m_IndexCapacity(0)
+	{
+		const VertexBufferElement& position = m_Layout.GetElements()[0];
+		OGL_ASSERT(position.Type == ShaderDataType::Float3 && position.Offset == 0, "The first vertex element has to be the position");
+
+		Grow(vertexCapacity, indexCapacity);
+	}
+
+	GeometryRange GeometryArena::Allocate(const void* vertices, uint32_t vertexCount, const uint32_t* indices, uint32_t indexCount)
+	{
+		uint32_t vertexCapacity = m_VertexCapacity;
+		while (m_VertexCount + vertexCount > vertexCapacity)
+			vertexCapacity *= 2;
+
+		uint32_t indexCapacity = m_IndexCapacity;
+		while (m_IndexCount + indexCount > indexCapacity)
+			indexCapacity *= 2;
+
+		if (vertexCapacity != m_VertexCapacity || indexCapacity != m_IndexCapacity)
+			Grow(vertexCapacity, indexCapacity);
+
+		uint32_t stride = m_Layout.GetStride();
+		m_VertexBuffer->SetData(vertices, vertexCount * stride, m_VertexCount * stride);
+		m_IndexBuffer->SetData(indices, indexCount, m_IndexCount);
+
+		std::vector<glm::vec3> positions(vertexCount);
+		for (uint32_t i = 0; i < vertexCount; i++)
+			memcpy(&positions[i], (const uint8_t*)vertices + (size_t)i * stride, sizeof(glm::vec3));
+		m_PositionBuffer->SetData(positions.data(), vertexCount * (uint32_t)sizeof(glm::vec3), m_VertexCount * (uint32_t)sizeof(glm::vec3));
+
+		GeometryRange range = { m_AllocationCount++, indexCount, m_IndexCount, m_VertexCount };
+		m_VertexCount += vertexCount;
+		m_IndexCount += indexCount;
+
+		return range;
+	}
+
+	void GeometryArena::Grow(uint32_t vertexCapacity, uint32_t indexCapacity)
+	{
+		uint32_t stride = m_Layout.GetStride();
+
+		Ref<VertexBuffer> vertexBuffer = CreateRef<VertexBuffer>(vertexCapacity * stride);
+		vertexBuffer->SetLayout(m_Layout);
+		Ref<VertexBuffer> positionBuffer = CreateRef<VertexBuffer>(vertexCapacity * (uint32_t)sizeof(glm::vec3));
+		positionBuffer->SetLayout({ { ShaderDataType::Float3, "a_Position" } });
+		Ref<IndexBuffer> indexBuffer = CreateRef<IndexBuffer>(indexCapacity);
+
+		// Keep the geometry that was already allocated, ranges handed out before stay valid
+		if (m_VertexCount)
+			glCopyNamedBufferSubData(m_VertexBuffer->GetRendererID(), vertexBuffer->GetRendererID(), 0, 0, (GLsizeiptr)m_VertexCount * stride);
+		if (m_VertexCount)
+			glCopyNamedBufferSubData(m_PositionBuffer->GetRendererID(), positionBuffer->GetRendererID(), 0, 0, (GLsizeiptr)m_VertexCount * sizeof(glm::vec3));
+		if (m_IndexCount)
+			glCopyNamedBufferSubData(m_IndexBuffer->GetRendererID(), indexBuffer->GetRendererID(), 0, 0, (GLsizeiptr)m_IndexCount * sizeof(uint32_t));
+
+		m_VertexBuffer = vertexBuffer;
+		m_PositionBuffer = positionBuffer;
+		m_IndexBuffer = indexBuffer;
+
+		m_VertexArray = CreateRef<VertexArray>();
+		m_VertexArray->AddVertexBuffer(m_VertexBuffer);
+		m_VertexArray->SetIndexBuffer(m_IndexBuffer);
+
+		m_PositionVertexArray = CreateRef<VertexArray>();
+		m_PositionVertexArray->AddVertexBuffer(m_PositionBuffer);
+		m_PositionVertexArray->SetIndexBuffer(m_IndexBuffer);
+
+		m_VertexCapacity = vertexCapacity;
+		m_IndexCapacity = indexCapacity;
+
+		OGL_INFO("Geometry arena resized to {0} vertices / {1} indices", vertexCapacity, indexCapacity);
+	}
+
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "Core/Core.h"
+#include "Renderer/VertexArray.h"
+
+// Shared vertex and index storage for all meshes that use the same vertex format
+// Meshes only keep their range inside the arena, so they can all be drawn from one vertex array (and one multi draw call)
+// The positions are kept a second time in a tightly packed stream, depth only passes (pre-pass, shadows) fetch 12 bytes per vertex
+// instead of the whole vertex, the position vertex array shares the index buffer so geometry ranges are valid for both
+
+namespace OpenGLRendering {
+
+	// Location of one mesh inside a geometry arena, maps directly onto the parameters of an indirect draw command
+	struct GeometryRange
+	{
+		uint32_t Id; // Unique inside the arena, used to group identical meshes
+		uint32_t IndexCount;
+		uint32_t FirstIndex;
+		uint32_t BaseVertex;
+	};
+
+	// Vertex formats of the meshes, every format has its own arena
+	enum class GeometryFormat : uint8_t
+	{
+		Simple = 0, // Position, normal
+		Textured    // Position, normal, texture coordinates, tangent, bitangent
+	};
+
+	class GeometryArena
+	{
+	public:
+		// The first element of the layout has to be the position (Float3)
+		GeometryArena(GeometryFormat format, const VertexBufferLayout& layout, uint32_t vertexCapacity, uint32_t indexCapacity);
+
+		// Copies the geometry into the arena, the buffers grow (and the vertex arrays are recreated) when they are full
+		// Allocations are never freed, meshes live as long as the application
+		GeometryRange Allocate(const void* vertices, uint32_t vertexCount, const uint32_t* indices, uint32_t indexCount);
+
+		GeometryFormat GetFormat() const { return m_Format; } // Tells the arenas apart, the geometry ids are only unique inside one
+		const Ref<VertexArray>& GetVertexArray() const { return m_VertexArray; }
+		const Ref<VertexArray>& GetPositionVertexArray() const { return m_PositionVertexArray; }
+
+	private:
+		void Grow(uint32_t vertexCapacity, uint32_t indexCapacity);
+
+	private:
+		GeometryFormat m_Format;
+		VertexBufferLayout m_Layout;
+
+		Ref<VertexArray> m_VertexArray;
+		Ref<VertexBuffer> m_VertexBuffer;
+		Ref<VertexArray> m_PositionVertexArray;
+		Ref<VertexBuffer> m_PositionBuffer;
+		Ref<IndexBuffer> m_IndexBuffer;
+
+		uint32_t m_VertexCapacity;
+		uint32_t m_IndexCapacity;
+		uint32_t m_VertexCount = 0;
+		uint32_t m_IndexCount = 0;
+		uint32_t m_AllocationCount = 0;
+	};
+
+}
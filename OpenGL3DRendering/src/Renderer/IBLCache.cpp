@@ -0,0 +1,132 @@
+#include "oglpch.h"
+
+#include "IBLCache.h"
+#include "Renderer/Shader.h"
+
+#include <glad/glad.h>
+#include <filesystem>
+
+namespace OpenGLRendering {
+
+	static const char* s_CacheDirectory = "Cache/IBL";
+	static const uint32_t s_CacheMagic = 0x4C42494F; // "OIBL"
+	static const uint32_t s_CacheVersion = 3;
+
+	struct CacheHeader
+	{
+		uint32_t Magic;
+		uint32_t Version;
+		uint64_t Key;
+	};
+
+	static std::string GetCachePath(const std::string& name)
+	{
+		return std::string(s_CacheDirectory) + "/" + name + ".ibl";
+	}
+
+	uint64_t IBLCache::Hash(const void* data, size_t size, uint64_t hash)
+	{
+		const uint8_t* bytes = (const uint8_t*)data;
+		for (size_t i = 0; i < size; i++)
+			hash = (hash ^ bytes[i]) * 1099511628211ull;
+
+		return hash;
+	}
+
+	uint64_t IBLCache::HashFile(const std::string& filePath, uint64_t hash)
+	{
+		std::string content = Shader::ReadFile(filePath);
+		return Hash(content.data(), content.size(), hash);
+	}
+
+	IBLCacheLevel IBLCache::GetLevel(uint32_t texture, uint32_t level, uint32_t size, uint32_t depth, uint32_t format, uint32_t channels)
+	{
+		uint32_t width = size >> level;
+		return { texture, level, width, depth, format, (size_t)width * width * depth * channels * sizeof(uint16_t) };
+	}
+
+	bool IBLCache::Load(const std::string& name, uint64_t key, const std::vector<IBLCacheLevel>& levels, void* extraData, size_t extraSize)
+	{
+		OGL_PROFILE_FUNCTION();
+
+		std::string cachePath = GetCachePath(name);
+		std::ifstream stream(cachePath, std::ios::binary);
+		if (!stream)
+			return false;
+
+		CacheHeader header = {};
+		stream.read((char*)&header, sizeof(header));
+		if (!stream || header.Magic != s_CacheMagic || header.Version != s_CacheVersion || header.Key != key)
+		{
+			OGL_INFO("The IBL cache {0} is outdated, regenerating it", cachePath);
+			return false;
+		}
+
+		std::vector<uint8_t> extra(extraSize);
+		stream.read((char*)extra.data(), extraSize);
+
+		std::vector<std::vector<uint8_t>> data(levels.size());
+		for (size_t i = 0; i < levels.size() && stream; i++)
+		{
+			data[i].resize(levels[i].Size);
+			stream.read((char*)data[i].data(), levels[i].Size);
+		}
+
+		if (!stream)
+		{
+			OGL_WARN("The IBL cache {0} is truncated, regenerating it", cachePath);
+			return false;
+		}
+
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		for (size_t i = 0; i < levels.size(); i++)
+		{
+			const IBLCacheLevel& level = levels[i];
+			if (level.Depth == 6)
+				glTextureSubImage3D(level.Texture, level.Level, 0, 0, 0, level.Width, level.Width, 6, level.Format, GL_HALF_FLOAT, data[i].data());
+			else
+				glTextureSubImage2D(level.Texture, level.Level, 0, 0, level.Width, level.Width, level.Format, GL_HALF_FLOAT, data[i].data());
+		}
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+		if (extraSize)
+			memcpy(extraData, extra.data(), extraSize);
+
+		OGL_INFO("Loaded {0} from the IBL cache", name);
+		return true;
+	}
+
+	void IBLCache::Save(const std::string& name, uint64_t key, const std::vector<IBLCacheLevel>& levels, const void* extraData, size_t extraSize)
+	{
+		OGL_PROFILE_FUNCTION();
+
+		std::error_code error;
+		std::filesystem::create_directories(s_CacheDirectory, error);
+
+		std::string cachePath = GetCachePath(name);
+		std::ofstream stream(cachePath, std::ios::binary);
+		if (!stream)
+		{
+			OGL_WARN("Couldn't write the IBL cache {0}", cachePath);
+			return;
+		}
+
+		CacheHeader header = { s_CacheMagic, s_CacheVersion, key };
+		stream.write((const char*)&header, sizeof(header));
+		stream.write((const char*)extraData, extraSize);
+
+		// Half floats, the textures are read back in their storage format
+		glPixelStorei(GL_PACK_ALIGNMENT, 1);
+		std::vector<uint8_t> data;
+		for (const IBLCacheLevel& level : levels)
+		{
+			data.resize(level.Size);
+			glGetTextureImage(level.Texture, level.Level, level.Format, GL_HALF_FLOAT, (GLsizei)level.Size, data.data());
+			stream.write((const char*)data.data(), level.Size);
+		}
+		glPixelStorei(GL_PACK_ALIGNMENT, 4);
+
+		OGL_INFO("Stored {0} in {1}", name, cachePath);
+	}
+
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+// Binary cache files of precomputed lighting textures in Cache/IBL. A file starts with a key that hashes everything its textures depend on,
+// followed by an optional block of extra data and the texture levels as half floats; a missing or mismatching file is regenerated by the caller
+
+namespace OpenGLRendering {
+
+	// One mip level of a cached texture, cube map levels hold all six faces
+	struct IBLCacheLevel
+	{
+		uint32_t Texture;
+		uint32_t Level;
+		uint32_t Width;
+		uint32_t Depth; // 6 for cube maps, 1 otherwise
+		uint32_t Format; // GL_RGB or GL_RG
+		size_t Size; // Bytes
+	};
+
+	class IBLCache
+	{
+	public:
+		// FNV-1a, the keys chain several hashes
+		static const uint64_t HashSeed = 14695981039346656037ull;
+		static uint64_t Hash(const void* data, size_t size, uint64_t hash = HashSeed);
+		static uint64_t HashFile(const std::string& filePath, uint64_t hash = HashSeed);
+
+		static IBLCacheLevel GetLevel(uint32_t texture, uint32_t level, uint32_t size, uint32_t depth, uint32_t format, uint32_t channels);
+
+		// The levels are read completely before anything is uploaded, a truncated file leaves the textures untouched
+		static bool Load(const std::string& name, uint64_t key, const std::vector<IBLCacheLevel>& levels, void* extraData = nullptr, size_t extraSize = 0);
+		static void Save(const std::string& name, uint64_t key, const std::vector<IBLCacheLevel>& levels, const void* extraData = nullptr, size_t extraSize = 0);
+	};
+
+}
@@ -14,6 +14,14 @@ namespace OpenGLRendering {
 		glBufferData(GL_ARRAY_BUFFER, count * sizeof(uint32_t), indices, GL_STATIC_DRAW);
 	}
 
+	IndexBuffer::IndexBuffer(uint32_t count)
+		: m_IndexCount(count)
+	{
+		glCreateBuffers(1, &m_RendererID);
+		glBindBuffer(GL_ARRAY_BUFFER, m_RendererID);
+		glBufferData(GL_ARRAY_BUFFER, count * sizeof(uint32_t), nullptr, GL_DYNAMIC_DRAW);
+	}
+
 	IndexBuffer::~IndexBuffer()
 	{
 		glDeleteBuffers(1, &m_RendererID);
@@ -29,4 +37,9 @@ namespace OpenGLRendering {
 		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 	}
 
+	void IndexBuffer::SetData(const uint32_t* indices, uint32_t count, uint32_t offset)
+	{
+		glNamedBufferSubData(m_RendererID, offset * sizeof(uint32_t), count * sizeof(uint32_t), indices);
+	}
+
 }
\ No newline at end of file
@@ -9,12 +9,16 @@ namespace OpenGLRendering {
 	{
 	public:
 		IndexBuffer(const uint32_t* indices, uint32_t count);
+		IndexBuffer(uint32_t count); // Dynamic buffer with room for count indices
 		~IndexBuffer();
 
 		void Bind() const;
 		void Unbind() const;
 
+		void SetData(const uint32_t* indices, uint32_t count, uint32_t offset = 0); // Offset in indices
+
 		uint32_t GetIndexCount() const { return m_IndexCount; }
+		uint32_t GetRendererID() const { return m_RendererID; }
 
 	private:
 		uint32_t m_RendererID;
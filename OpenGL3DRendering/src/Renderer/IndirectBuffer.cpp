@@ -0,0 +1,42 @@
+#include "oglpch.h"
+
+#include "IndirectBuffer.h"
+
+#include <glad/glad.h>
+
+namespace OpenGLRendering {
+
+	IndirectBuffer::IndirectBuffer(uint32_t size)
+		: m_Size(size)
+	{
+		glCreateBuffers(1, &m_RendererID);
+		glNamedBufferData(m_RendererID, size, nullptr, GL_DYNAMIC_DRAW);
+	}
+
+	IndirectBuffer::~IndirectBuffer()
+	{
+		glDeleteBuffers(1, &m_RendererID);
+	}
+
+	void IndirectBuffer::SetData(const void* data, uint32_t size, uint32_t offset)
+	{
+		glNamedBufferSubData(m_RendererID, offset, size, data);
+	}
+
+	void IndirectBuffer::Resize(uint32_t size)
+	{
+		glNamedBufferData(m_RendererID, size, nullptr, GL_DYNAMIC_DRAW);
+		m_Size = size;
+	}
+
+	void IndirectBuffer::Bind() const
+	{
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_RendererID);
+	}
+
+	void IndirectBuffer::Unbind() const
+	{
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+	}
+
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include <stdint.h>
+
+// DrawIndirectBuffer wrapper class (OpenGL abstraction)
+
+namespace OpenGLRendering {
+
+	// Memory layout is defined by OpenGL (DrawElementsIndirectCommand)
+	struct DrawIndexedIndirectCommand
+	{
+		uint32_t IndexCount;
+		uint32_t InstanceCount;
+		uint32_t FirstIndex;
+		int32_t BaseVertex;
+		uint32_t BaseInstance;
+	};
+
+	class IndirectBuffer
+	{
+	public:
+		IndirectBuffer(uint32_t size);
+		~IndirectBuffer();
+
+		void SetData(const void* data, uint32_t size, uint32_t offset = 0);
+		void Resize(uint32_t size); // Reallocates the storage (contents are lost)
+		void Bind() const;
+		void Unbind() const;
+
+		uint32_t GetSize() const { return m_Size; }
+
+	private:
+		uint32_t m_RendererID;
+		uint32_t m_Size;
+	};
+
+}
@@ -0,0 +1,232 @@
+#include "oglpch.h"
+
+#include "LightClusters.h"
+
+namespace OpenGLRendering {
+
+	LightClusterGrid::LightClusterGrid(uint32_t workerCount)
+		: m_ClusterBounds(ClusterCount), m_ClusterLights(ClusterCount), m_Ranges(ClusterCount)
+	{
+		// Every job needs at least one slice
+		workerCount = std::min(workerCount, Slices - 1);
+		for (uint32_t i = 0; i < workerCount; i++)
+			m_Workers.emplace_back(&LightClusterGrid::WorkerLoop, this, i + 1);
+	}
+
+	LightClusterGrid::~LightClusterGrid()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_Running = false;
+		}
+		m_StartCondition.notify_all();
+
+		for (std::thread& worker : m_Workers)
+			worker.join();
+	}
+
+	glm::vec2 LightClusterGrid::GetSliceParams(float nearClip, float farClip)
+	{
+		float scale = (float)Slices / std::log(farClip / nearClip);
+		return { scale, -std::log(nearClip) * scale };
+	}
+
+	float LightClusterGrid::GetSliceDepth(uint32_t slice) const
+	{
+		return m_NearClip * std::pow(m_FarClip / m_NearClip, (float)slice / (float)Slices);
+	}
+
+	void LightClusterGrid::Assign(const std::vector<glm::vec4>& spheres, const glm::mat4& projection, float nearClip, float farClip)
+	{
+		OGL_PROFILE_FUNCTION();
+
+		m_Spheres = &spheres;
+		m_Projection = projection;
+		m_NearClip = nearClip;
+		m_FarClip = farClip;
+
+		m_Indices.clear();
+		if (spheres.empty())
+		{
+			std::fill(m_Ranges.begin(), m_Ranges.end(), ClusterRange{ 0, 0 });
+			return;
+		}
+
+		ComputeExtents();
+
+		// The calling thread takes the first job
+		if (!m_Workers.empty())
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_Mutex);
+				m_Generation++;
+				m_PendingJobs = (uint32_t)m_Workers.size();
+			}
+			m_StartCondition.notify_all();
+		}
+
+		AssignSlices(0);
+
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			m_DoneCondition.wait(lock, [this]() { return m_PendingJobs == 0; });
+		}
+
+		for (uint32_t cluster = 0; cluster < ClusterCount; cluster++)
+		{
+			const std::vector<uint32_t>& lights = m_ClusterLights[cluster];
+			m_Ranges[cluster] = { (uint32_t)m_Indices.size(), (uint32_t)lights.size() };
+			m_Indices.insert(m_Indices.end(), lights.begin(), lights.end());
+		}
+	}
+
+	static uint32_t ToTile(float ndc, uint32_t tiles)
+	{
+		int tile = (int)std::floor((ndc * 0.5f + 0.5f) * (float)tiles);
+		return (uint32_t)std::min(std::max(tile, 0), (int)tiles - 1);
+	}
+
+	void LightClusterGrid::ComputeExtents()
+	{
+		const std::vector<glm::vec4>& spheres = *m_Spheres;
+		glm::vec2 sliceParams = GetSliceParams(m_NearClip, m_FarClip);
+		auto toSlice = [sliceParams](float depth)
+		{
+			int slice = (int)std::floor(std::log(depth) * sliceParams.x + sliceParams.y);
+			return (uint32_t)std::min(std::max(slice, 0), (int)Slices - 1);
+		};
+
+		m_Extents.resize(spheres.size());
+		for (uint32_t i = 0; i < (uint32_t)spheres.size(); i++)
+		{
+			glm::vec3 center = spheres[i];
+			float radius = spheres[i].w;
+			LightExtent& extent = m_Extents[i];
+
+			// The camera looks down -z
+			float minDepth = -center.z - radius, maxDepth = -center.z + radius;
+			extent.Visible = maxDepth >= m_NearClip && minDepth <= m_FarClip;
+			if (!extent.Visible)
+				continue;
+
+			extent.MinSlice = toSlice(std::max(minDepth, m_NearClip));
+			extent.MaxSlice = toSlice(std::min(maxDepth, m_FarClip));
+
+			// A sphere that reaches the near plane may cover any tile, the cluster bounds test sorts it out
+			glm::vec2 minCorner = glm::vec2(-1.0f), maxCorner = glm::vec2(1.0f);
+			if (minDepth > m_NearClip)
+			{
+				minCorner = glm::vec2(1.0f);
+				maxCorner = glm::vec2(-1.0f);
+				for (uint32_t corner = 0; corner < 8; corner++)
+				{
+					glm::vec3 offset = { (corner & 1) ? radius : -radius, (corner & 2) ? radius : -radius, (corner & 4) ? radius : -radius };
+					glm::vec4 clip = m_Projection * glm::vec4(center + offset, 1.0f);
+					glm::vec2 ndc = glm::vec2(clip) / clip.w;
+					minCorner = glm::min(minCorner, ndc);
+					maxCorner = glm::max(maxCorner, ndc);
+				}
+
+				if (maxCorner.x < -1.0f || maxCorner.y < -1.0f || minCorner.x > 1.0f || minCorner.y > 1.0f)
+				{
+					extent.Visible = false;
+					continue;
+				}
+			}
+
+			extent.MinTileX = ToTile(minCorner.x, TilesX);
+			extent.MaxTileX = ToTile(maxCorner.x, TilesX);
+			extent.MinTileY = ToTile(minCorner.y, TilesY);
+			extent.MaxTileY = ToTile(maxCorner.y, TilesY);
+		}
+	}
+
+	static bool Intersects(const glm::vec4& sphere, const glm::vec3& boxMin, const glm::vec3& boxMax)
+	{
+		glm::vec3 center = sphere;
+		glm::vec3 closest = glm::clamp(center, boxMin, boxMax);
+		glm::vec3 offset = closest - center;
+
+		return glm::dot(offset, offset) <= sphere.w * sphere.w;
+	}
+
+	void LightClusterGrid::AssignSlices(uint32_t job)
+	{
+		uint32_t jobCount = (uint32_t)m_Workers.size() + 1;
+		uint32_t firstSlice = job * Slices / jobCount, lastSlice = (job + 1) * Slices / jobCount;
+
+		// View space x = depth * (ndc.x + P[2][0]) / P[0][0], the bounds of a cluster are spanned by the corners of its near and far side
+		for (uint32_t slice = firstSlice; slice < lastSlice; slice++)
+		{
+			float nearDepth = GetSliceDepth(slice), farDepth = GetSliceDepth(slice + 1);
+
+			for (uint32_t y = 0; y < TilesY; y++)
+			{
+				float minY = ((float)y / (float)TilesY * 2.0f - 1.0f + m_Projection[2][1]) / m_Projection[1][1];
+				float maxY = ((float)(y + 1) / (float)TilesY * 2.0f - 1.0f + m_Projection[2][1]) / m_Projection[1][1];
+
+				for (uint32_t x = 0; x < TilesX; x++)
+				{
+					float minX = ((float)x / (float)TilesX * 2.0f - 1.0f + m_Projection[2][0]) / m_Projection[0][0];
+					float maxX = ((float)(x + 1) / (float)TilesX * 2.0f - 1.0f + m_Projection[2][0]) / m_Projection[0][0];
+
+					uint32_t cluster = x + TilesX * (y + TilesY * slice);
+					ClusterBounds& bounds = m_ClusterBounds[cluster];
+					bounds.Min = { std::min(minX * nearDepth, minX * farDepth), std::min(minY * nearDepth, minY * farDepth), -farDepth };
+					bounds.Max = { std::max(maxX * nearDepth, maxX * farDepth), std::max(maxY * nearDepth, maxY * farDepth), -nearDepth };
+
+					m_ClusterLights[cluster].clear();
+				}
+			}
+		}
+
+		const std::vector<glm::vec4>& spheres = *m_Spheres;
+		for (uint32_t i = 0; i < (uint32_t)spheres.size(); i++)
+		{
+			const LightExtent& extent = m_Extents[i];
+			if (!extent.Visible || extent.MaxSlice < firstSlice || extent.MinSlice >= lastSlice)
+				continue;
+
+			uint32_t minSlice = std::max(extent.MinSlice, firstSlice), maxSlice = std::min(extent.MaxSlice, lastSlice - 1);
+			for (uint32_t slice = minSlice; slice <= maxSlice; slice++)
+			{
+				for (uint32_t y = extent.MinTileY; y <= extent.MaxTileY; y++)
+				{
+					for (uint32_t x = extent.MinTileX; x <= extent.MaxTileX; x++)
+					{
+						uint32_t cluster = x + TilesX * (y + TilesY * slice);
+						const ClusterBounds& bounds = m_ClusterBounds[cluster];
+
+						if (Intersects(spheres[i], bounds.Min, bounds.Max))
+							m_ClusterLights[cluster].push_back(i);
+					}
+				}
+			}
+		}
+	}
+
+	void LightClusterGrid::WorkerLoop(uint32_t job)
+	{
+		uint64_t generation = 0;
+		while (true)
+		{
+			{
+				std::unique_lock<std::mutex> lock(m_Mutex);
+				m_StartCondition.wait(lock, [this, generation]() { return !m_Running || m_Generation != generation; });
+				if (!m_Running)
+					return;
+
+				generation = m_Generation;
+			}
+
+			AssignSlices(job);
+
+			{
+				std::lock_guard<std::mutex> lock(m_Mutex);
+				m_PendingJobs--;
+			}
+			m_DoneCondition.notify_one();
+		}
+	}
+
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include <stdint.h>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <glm/glm.hpp>
+
+// Clustered light assignment: the view frustum is split into screen tiles and exponential depth slices, every cluster gets
+// the list of lights whose bounding sphere overlaps it, so a fragment only evaluates the lights of its own cluster
+// The depth slices are divided between worker threads, every cluster is written by exactly one thread and no locking is needed
+
+namespace OpenGLRendering {
+
+	// Lights of one cluster in the index list (std430 uvec2, storage block "LightClusters")
+	struct ClusterRange
+	{
+		uint32_t Offset;
+		uint32_t Count;
+	};
+
+	class LightClusterGrid
+	{
+	public:
+		static const uint32_t TilesX = 16, TilesY = 9, Slices = 24;
+		static const uint32_t ClusterCount = TilesX * TilesY * Slices;
+
+		LightClusterGrid(uint32_t workerCount); // Threads besides the calling one
+		~LightClusterGrid();
+
+		// Spheres are in view space (xyz: center, w: radius), the projection may be jittered
+		void Assign(const std::vector<glm::vec4>& spheres, const glm::mat4& projection, float nearClip, float farClip);
+
+		const std::vector<ClusterRange>& GetRanges() const { return m_Ranges; }
+		const std::vector<uint32_t>& GetIndices() const { return m_Indices; } // Ascending light indices per cluster
+		static glm::vec2 GetSliceParams(float nearClip, float farClip); // Depth slice = log(view depth) * x + y
+		uint32_t GetWorkerCount() const { return (uint32_t)m_Workers.size(); }
+
+	private:
+		// Clusters a light may touch, from its depth range and projected bounds
+		struct LightExtent
+		{
+			uint32_t MinSlice, MaxSlice;
+			uint32_t MinTileX, MaxTileX, MinTileY, MaxTileY;
+			bool Visible;
+		};
+
+		// View space box of a cluster
+		struct ClusterBounds
+		{
+			glm::vec3 Min, Max;
+		};
+
+		void ComputeExtents();
+		void AssignSlices(uint32_t job);
+		void WorkerLoop(uint32_t job);
+
+		float GetSliceDepth(uint32_t slice) const;
+
+	private:
+		const std::vector<glm::vec4>* m_Spheres = nullptr;
+		glm::mat4 m_Projection = glm::mat4(1.0f);
+		float m_NearClip = 0.1f, m_FarClip = 100.0f;
+
+		std::vector<LightExtent> m_Extents;
+		std::vector<ClusterBounds> m_ClusterBounds;
+		std::vector<std::vector<uint32_t>> m_ClusterLights; // Filled by the jobs
+		std::vector<ClusterRange> m_Ranges;
+		std::vector<uint32_t> m_Indices;
+
+		std::vector<std::thread> m_Workers;
+		std::mutex m_Mutex;
+		std::condition_variable m_StartCondition;
+		std::condition_variable m_DoneCondition;
+		uint64_t m_Generation = 0; // Incremented for every assignment, the workers wait for a new one
+		uint32_t m_PendingJobs = 0;
+		bool m_Running = true;
+	};
+
+}
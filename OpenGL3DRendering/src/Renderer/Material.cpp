@@ -4,11 +4,13 @@
 
 namespace OpenGLRendering {
 
+	static uint32_t s_MaterialCount = 0;
+
 	Material::Material()
-		: m_Albedo({ 0.0f, 0.0f, 0.0f }), m_Metallic(0.0f), m_Roughness(0.0f), m_AmbientOcclusion(0.0f), m_UseTextures(false) { }
+		: m_Id(s_MaterialCount++), m_Albedo({ 0.0f, 0.0f, 0.0f }), m_Metallic(0.0f), m_Roughness(0.0f), m_AmbientOcclusion(0.0f), m_UseTextures(false) { }
 
 	Material::Material(const std::unordered_map<TextureType, Ref<Texture2D>>& textures)
-		: m_Albedo({ 0.0f, 0.0f, 0.0f }), m_Metallic(0.0f), m_Roughness(0.0f), m_AmbientOcclusion(0.0f), m_Textures(textures), m_UseTextures(true) { }
+		: m_Id(s_MaterialCount++), m_Albedo({ 0.0f, 0.0f, 0.0f }), m_Metallic(0.0f), m_Roughness(0.0f), m_AmbientOcclusion(0.0f), m_Textures(textures), m_UseTextures(true) { }
 
 
 }
\ No newline at end of file
@@ -22,6 +22,7 @@ namespace OpenGLRendering {
 		void SetAmbientOcclusion(float ao) { m_AmbientOcclusion = ao; }
 		void UseTextures(bool use) { m_UseTextures = use; }
 		
+		uint32_t GetId() const { return m_Id; }
 		const std::unordered_map<TextureType, Ref<Texture2D>>& GetTextures() const { return m_Textures; }
 		const glm::vec3& GetAlbedo() const { return m_Albedo; }
 
@@ -32,6 +33,7 @@ namespace OpenGLRendering {
 		bool IsUsingTextures() { return m_UseTextures; }
 
 	private:
+		uint32_t m_Id; // Unique per material, used to group draws that share a material
 		std::unordered_map<TextureType, Ref<Texture2D>> m_Textures;
 		
 		glm::vec3 m_Albedo;
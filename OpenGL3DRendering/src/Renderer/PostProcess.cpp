@@ -0,0 +1,82 @@
+#include "oglpch.h"
+
+#include "PostProcess.h"
+
+namespace OpenGLRendering {
+
+	struct PostEffectInfo
+	{
+		const char* Name; // Also the name of the GLSL function
+		const char* SnippetFile;
+	};
+
+	static const PostEffectInfo s_PostEffects[] =
+	{
+		{ "Invert", "src/Resources/ShaderSource/PostProcessing/Effects/invert.glsl" },
+		{ "ColorGrading", "src/Resources/ShaderSource/PostProcessing/Effects/color_grading.glsl" },
+		{ "Vignette", "src/Resources/ShaderSource/PostProcessing/Effects/vignette.glsl" },
+	};
+
+	static_assert(sizeof(s_PostEffects) / sizeof(s_PostEffects[0]) == (size_t)PostEffect::Count, "Every post effect needs a snippet");
+
+	const char* GetPostEffectName(PostEffect effect)
+	{
+		return s_PostEffects[(uint32_t)effect].Name;
+	}
+
+	const Ref<Shader>& PostProcessShaderCache::GetShader(const std::vector<PostEffect>& effects)
+	{
+		std::string key;
+		for (PostEffect effect : effects)
+			key += (char)('A' + (char)effect);
+
+		auto it = m_Shaders.find(key);
+		if (it != m_Shaders.end())
+			return it->second;
+
+		if (m_VertexSource.empty())
+			m_VertexSource = Shader::ReadFile("src/Resources/ShaderSource/PostProcessing/post_process_vertex.glsl");
+
+		OGL_INFO("Generating post processing shader for {0} effects", effects.size());
+		return m_Shaders[key] = Shader::CreateFromSource(m_VertexSource, GenerateFragmentSource(effects));
+	}
+
+	void PostProcessShaderCache::SetUniforms(const Ref<Shader>& shader, const PostProcessStack& stack)
+	{
+		// Uniforms of effects that are not part of the shader don't exist and are ignored
+		shader->SetInt("u_Frame", 0);
+		shader->SetFloat4("u_GradingColor", stack.GradingColor);
+		shader->SetFloat("u_VignetteStrength", stack.VignetteStrength);
+		shader->SetFloat("u_VignetteRadius", stack.VignetteRadius);
+	}
+
+	std::string PostProcessShaderCache::GenerateFragmentSource(const std::vector<PostEffect>& effects)
+	{
+		std::stringstream source;
+		source << "#version 450 core\n\n";
+		source << "layout(location = 0) out vec4 color;\n\n";
+		source << "in vec2 v_TexCoords;\n\n";
+		source << "uniform sampler2D u_Frame;\n\n";
+
+		// Every snippet is included once, even if its effect is applied several times
+		bool included[(size_t)PostEffect::Count] = {};
+		for (PostEffect effect : effects)
+		{
+			if (included[(size_t)effect])
+				continue;
+
+			source << "// " << s_PostEffects[(size_t)effect].Name << "\n";
+			source << Shader::ReadFile(s_PostEffects[(size_t)effect].SnippetFile) << "\n";
+			included[(size_t)effect] = true;
+		}
+
+		source << "void main()\n{\n";
+		source << "\tvec4 result = texture(u_Frame, v_TexCoords);\n";
+		for (PostEffect effect : effects)
+			source << "\tresult = " << s_PostEffects[(size_t)effect].Name << "(result, v_TexCoords);\n";
+		source << "\tcolor = result;\n}\n";
+
+		return source.str();
+	}
+
+}
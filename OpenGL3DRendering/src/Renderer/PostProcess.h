@@ -0,0 +1,49 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <glm/glm.hpp>
+
+#include "Core/Core.h"
+#include "Renderer/Shader.h"
+
+// Post processing stack, all per pixel colour effects of a frame run in one fused fullscreen pass
+// Every effect is a GLSL snippet (Resources/ShaderSource/PostProcessing/Effects) with a function vec4 <Name>(vec4 color, vec2 texCoords),
+// the fragment shader of an effect sequence is generated from the snippets on first use and cached
+// The stack runs on the tonemapped display colour, exposure and gamma belong to the tonemap pass of the renderer
+
+namespace OpenGLRendering {
+
+	enum class PostEffect : uint8_t
+	{
+		Invert = 0, ColorGrading, Vignette, Count
+	};
+
+	const char* GetPostEffectName(PostEffect effect);
+
+	struct PostProcessStack
+	{
+		std::vector<PostEffect> Effects; // Applied in order, an effect may appear more than once
+
+		glm::vec4 GradingColor = { 1.0f, 1.0f, 1.0f, 1.0f };
+		float VignetteStrength = 0.5f;
+		float VignetteRadius = 0.5f; // Relative distance from the center where the darkening starts
+	};
+
+	class PostProcessShaderCache
+	{
+	public:
+		const Ref<Shader>& GetShader(const std::vector<PostEffect>& effects);
+		void SetUniforms(const Ref<Shader>& shader, const PostProcessStack& stack);
+
+		uint32_t GetShaderCount() const { return (uint32_t)m_Shaders.size(); }
+
+		static std::string GenerateFragmentSource(const std::vector<PostEffect>& effects);
+
+	private:
+		std::unordered_map<std::string, Ref<Shader>> m_Shaders; // Effect sequence -> fused shader
+		std::string m_VertexSource;
+	};
+
+}
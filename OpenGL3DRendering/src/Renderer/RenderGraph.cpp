@@ -0,0 +1,465 @@
+#include "oglpch.h"
+
+#include "RenderGraph.h"
+#include "StateCache.h"
+#include "GPUProfiler.h"
+
+#include <glad/glad.h>
+
+namespace OpenGLRendering {
+
+	// Pooled textures that weren't needed for this many frames are deleted, e.g. the old sizes after a resize
+	static const uint64_t s_PoolRetainFrames = 2;
+
+	static uint64_t GetTextureMemory(const RenderTargetDesc& desc)
+	{
+		return (uint64_t)desc.Width * desc.Height * GetBytesPerPixel(desc.Format) * desc.Samples;
+	}
+
+	static bool Contains(const std::vector<RenderGraphResource>& resources, RenderGraphResource resource)
+	{
+		return std::find(resources.begin(), resources.end(), resource) != resources.end();
+	}
+
+	uint32_t RenderPassContext::GetTexture(RenderGraphResource resource) const
+	{
+		return m_Graph.GetTextureId(resource);
+	}
+
+	void RenderPassContext::BindTexture(RenderGraphResource resource, uint32_t slot) const
+	{
+		StateCache::BindTexture(slot, m_Graph.GetTextureId(resource));
+	}
+
+	uint32_t RenderPassContext::GetFramebuffer() const
+	{
+		return m_Graph.GetFramebuffer(m_Graph.m_Passes[m_Pass].Writes);
+	}
+
+	uint32_t RenderPassContext::GetFramebuffer(const std::vector<RenderGraphResource>& attachments) const
+	{
+		return m_Graph.GetFramebuffer(attachments);
+	}
+
+	void RenderPassContext::BindFramebuffer() const
+	{
+		const std::vector<RenderGraphResource>& writes = m_Graph.m_Passes[m_Pass].Writes;
+		OGL_ASSERT(!writes.empty(), "Pass doesn't write any texture");
+
+		StateCache::BindFramebuffer(m_Graph.GetFramebuffer(writes));
+
+		const RenderTargetDesc& desc = m_Graph.m_Resources[writes.front()].Desc;
+		StateCache::SetViewport(0, 0, desc.Width, desc.Height);
+	}
+
+	RenderGraph::~RenderGraph()
+	{
+		for (const CachedFramebuffer& framebuffer : m_Framebuffers)
+		{
+			glDeleteFramebuffers(1, &framebuffer.Id);
+			StateCache::ForgetFramebuffer(framebuffer.Id);
+		}
+
+		for (const PooledTexture& texture : m_Pool)
+		{
+			glDeleteTextures(1, &texture.Id);
+			StateCache::ForgetTexture(texture.Id);
+		}
+	}
+
+	void RenderGraph::Reset()
+	{
+		m_Resources.clear();
+		m_Passes.clear();
+		m_Order.clear();
+		m_Output = UINT32_MAX;
+		m_Compiled = false;
+	}
+
+	RenderGraphResource RenderGraph::CreateTexture(const std::string& name, const RenderTargetDesc& desc)
+	{
+		OGL_ASSERT(desc.Width > 0 && desc.Height > 0 && desc.Samples > 0, "Invalid render target size");
+
+		TextureResource resource;
+		resource.Name = name;
+		resource.Desc = desc;
+		m_Resources.push_back(resource);
+
+		return (RenderGraphResource)m_Resources.size() - 1;
+	}
+
+	RenderGraphResource RenderGraph::ImportTexture(const std::string& name, uint32_t textureId, const RenderTargetDesc& desc)
+	{
+		RenderGraphResource resource = CreateTexture(name, desc);
+		m_Resources[resource].ImportedId = textureId;
+
+		return resource;
+	}
+
+	void RenderGraph::AddPass(const char* name, const std::vector<RenderGraphResource>& reads, const std::vector<RenderGraphResource>& writes, const ExecuteFn& execute)
+	{
+		Pass pass;
+		pass.Name = name;
+		pass.Reads = reads;
+		pass.Writes = writes;
+		pass.Execute = execute;
+		m_Passes.push_back(pass);
+
+		m_Compiled = false;
+	}
+
+	void RenderGraph::SetOutput(RenderGraphResource resource)
+	{
+		OGL_ASSERT(resource < m_Resources.size(), "Unknown render graph texture");
+		m_Output = resource;
+	}
+
+	const RenderTargetDesc& RenderGraph::GetDesc(RenderGraphResource resource) const
+	{
+		return m_Resources[resource].Desc;
+	}
+
+	void RenderGraph::Compile()
+	{
+		OGL_PROFILE_FUNCTION();
+
+		for (TextureResource& resource : m_Resources)
+		{
+			resource.RefCount = 0;
+			resource.FirstPass = UINT32_MAX;
+			resource.LastPass = 0;
+			resource.Allocation = -1;
+		}
+
+		// Reference counts: readers per texture, written textures per pass
+		std::vector<bool> written(m_Resources.size(), false);
+		for (Pass& pass : m_Passes)
+		{
+			for (RenderGraphResource resource : pass.Reads)
+			{
+				OGL_ASSERT(written[resource] || m_Resources[resource].ImportedId, "Pass reads a texture before any pass wrote it");
+				m_Resources[resource].RefCount++;
+			}
+
+			for (RenderGraphResource resource : pass.Writes)
+				written[resource] = true;
+
+			pass.RefCount = pass.Writes.empty() ? 1 : (uint32_t)pass.Writes.size();
+			pass.Culled = false;
+		}
+
+		if (m_Output != UINT32_MAX)
+		{
+			OGL_ASSERT(written[m_Output], "Render graph output is never written");
+			m_Resources[m_Output].RefCount++;
+		}
+
+		for (TextureResource& resource : m_Resources)
+		{
+			if (resource.ImportedId)
+				resource.RefCount++;
+		}
+
+		// Textures nobody reads make their writers lose a reference, writers without references are culled
+		// and release the textures they read in turn
+		std::vector<RenderGraphResource> unused;
+		for (RenderGraphResource resource = 0; resource < m_Resources.size(); resource++)
+		{
+			if (m_Resources[resource].RefCount == 0)
+				unused.push_back(resource);
+		}
+
+		while (!unused.empty())
+		{
+			RenderGraphResource resource = unused.back();
+			unused.pop_back();
+
+			for (Pass& pass : m_Passes)
+			{
+				if (pass.Culled || !Contains(pass.Writes, resource) || --pass.RefCount > 0)
+					continue;
+
+				pass.Culled = true;
+				for (RenderGraphResource read : pass.Reads)
+				{
+					if (--m_Resources[read].RefCount == 0)
+						unused.push_back(read);
+				}
+			}
+		}
+
+		// Lifetimes in pass indices, a texture is alive from its first to its last use
+		m_Order.clear();
+		for (uint32_t i = 0; i < m_Passes.size(); i++)
+		{
+			const Pass& pass = m_Passes[i];
+			if (pass.Culled)
+				continue;
+
+			m_Order.push_back(i);
+
+			for (const std::vector<RenderGraphResource>* resources : { &pass.Reads, &pass.Writes })
+			{
+				for (RenderGraphResource resource : *resources)
+				{
+					TextureResource& texture = m_Resources[resource];
+					texture.FirstPass = std::min(texture.FirstPass, i);
+					texture.LastPass = std::max(texture.LastPass, i);
+				}
+			}
+		}
+
+		m_Stats.Passes = (uint32_t)m_Order.size();
+		m_Stats.CulledPasses = (uint32_t)(m_Passes.size() - m_Order.size());
+		m_Stats.Textures = 0;
+		m_Stats.UnaliasedMemory = 0;
+		m_Stats.ImportedMemory = 0;
+		for (const TextureResource& resource : m_Resources)
+		{
+			if (resource.FirstPass == UINT32_MAX)
+				continue;
+
+			m_Stats.Textures++;
+			(resource.ImportedId ? m_Stats.ImportedMemory : m_Stats.UnaliasedMemory) += GetTextureMemory(resource.Desc);
+		}
+
+		m_Compiled = true;
+	}
+
+	void RenderGraph::Execute()
+	{
+		OGL_PROFILE_FUNCTION();
+		OGL_ASSERT(m_Compiled, "Render graph has to be compiled before it is executed");
+
+		// The output of the last frame is free again, it was displayed and read back by now
+		m_Frame++;
+		for (PooledTexture& texture : m_Pool)
+			texture.InUse = false;
+
+		TrimPool();
+
+		std::vector<RenderGraphResource> dead;
+		for (uint32_t index : m_Order)
+		{
+			const Pass& pass = m_Passes[index];
+
+			// Textures that start their life here hold whatever an aliased texture left behind, the driver doesn't have to load it
+			dead.clear();
+			for (RenderGraphResource resource : pass.Writes)
+			{
+				if (m_Resources[resource].FirstPass == index && !m_Resources[resource].ImportedId)
+				{
+					Acquire(resource);
+
+					if (!Contains(pass.Reads, resource))
+						dead.push_back(resource);
+				}
+			}
+			InvalidateAttachments(pass, dead);
+
+			{
+				GPUProfilerScope scope(pass.Name);
+				pass.Execute(RenderPassContext(*this, index));
+			}
+
+			// Attachments that aren't used afterwards don't have to be stored, sampled textures are discarded as a whole
+			dead.clear();
+			for (RenderGraphResource resource : pass.Writes)
+			{
+				if (m_Resources[resource].LastPass == index && resource != m_Output && !m_Resources[resource].ImportedId)
+					dead.push_back(resource);
+			}
+			InvalidateAttachments(pass, dead);
+
+			for (RenderGraphResource resource : pass.Reads)
+			{
+				if (m_Resources[resource].LastPass == index && resource != m_Output && !m_Resources[resource].ImportedId && !Contains(pass.Writes, resource))
+				{
+					glInvalidateTexImage(GetTextureId(resource), 0);
+					Release(resource);
+				}
+			}
+
+			for (RenderGraphResource resource : dead)
+				Release(resource);
+		}
+
+		if (m_Output != UINT32_MAX && m_Resources[m_Output].FirstPass != UINT32_MAX)
+		{
+			m_OutputTexture = GetTextureId(m_Output);
+			m_OutputDesc = m_Resources[m_Output].Desc;
+		}
+
+		m_Stats.PooledTextures = (uint32_t)m_Pool.size();
+		m_Stats.PooledMemory = 0;
+		for (const PooledTexture& texture : m_Pool)
+			m_Stats.PooledMemory += GetTextureMemory(texture.Desc);
+	}
+
+	void RenderGraph::Acquire(RenderGraphResource resource)
+	{
+		TextureResource& texture = m_Resources[resource];
+
+		// Any free texture with the same description will do, its previous contents are dead
+		for (uint32_t i = 0; i < m_Pool.size(); i++)
+		{
+			PooledTexture& pooled = m_Pool[i];
+			if (!pooled.InUse && pooled.Desc == texture.Desc)
+			{
+				pooled.InUse = true;
+				pooled.LastUsedFrame = m_Frame;
+				texture.Allocation = (int32_t)i;
+				return;
+			}
+		}
+
+		const RenderTargetDesc& desc = texture.Desc;
+		GLenum format = RenderTargetFormatToOpenGLFormat(desc.Format);
+
+		PooledTexture pooled;
+		pooled.Desc = desc;
+		pooled.InUse = true;
+		pooled.LastUsedFrame = m_Frame;
+
+		if (desc.Samples > 1)
+		{
+			glCreateTextures(GL_TEXTURE_2D_MULTISAMPLE, 1, &pooled.Id);
+			glTextureStorage2DMultisample(pooled.Id, desc.Samples, format, desc.Width, desc.Height, GL_TRUE);
+		}
+		else
+		{
+			glCreateTextures(GL_TEXTURE_2D, 1, &pooled.Id);
+			glTextureStorage2D(pooled.Id, 1, format, desc.Width, desc.Height);
+			glTextureParameteri(pooled.Id, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+			glTextureParameteri(pooled.Id, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+			glTextureParameteri(pooled.Id, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+			glTextureParameteri(pooled.Id, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		}
+
+		glObjectLabel(GL_TEXTURE, pooled.Id, -1, texture.Name.c_str());
+
+		texture.Allocation = (int32_t)m_Pool.size();
+		m_Pool.push_back(pooled);
+	}
+
+	void RenderGraph::Release(RenderGraphResource resource)
+	{
+		TextureResource& texture = m_Resources[resource];
+		OGL_ASSERT(texture.Allocation >= 0, "Released texture is not alive");
+
+		m_Pool[texture.Allocation].InUse = false;
+	}
+
+	void RenderGraph::TrimPool()
+	{
+		for (uint32_t i = 0; i < m_Pool.size();)
+		{
+			const PooledTexture& texture = m_Pool[i];
+			if (m_Frame - texture.LastUsedFrame <= s_PoolRetainFrames)
+			{
+				i++;
+				continue;
+			}
+
+			ForgetTexture(texture.Id);
+			glDeleteTextures(1, &texture.Id);
+			StateCache::ForgetTexture(texture.Id);
+			m_Pool.erase(m_Pool.begin() + i);
+		}
+	}
+
+	void RenderGraph::ForgetTexture(uint32_t textureId)
+	{
+		// The framebuffers would keep the storage alive and the texture name can be reused
+		for (uint32_t i = 0; i < m_Framebuffers.size();)
+		{
+			const CachedFramebuffer& framebuffer = m_Framebuffers[i];
+			if (std::find(framebuffer.Attachments.begin(), framebuffer.Attachments.end(), textureId) == framebuffer.Attachments.end())
+			{
+				i++;
+				continue;
+			}
+
+			glDeleteFramebuffers(1, &framebuffer.Id);
+			StateCache::ForgetFramebuffer(framebuffer.Id);
+			m_Framebuffers.erase(m_Framebuffers.begin() + i);
+		}
+	}
+
+	void RenderGraph::InvalidateAttachments(const Pass& pass, const std::vector<RenderGraphResource>& resources)
+	{
+		if (resources.empty())
+			return;
+
+		// Attachment points follow the order of the writes, see GetFramebuffer
+		std::vector<GLenum> attachments;
+		uint32_t colorAttachment = 0;
+		for (RenderGraphResource resource : pass.Writes)
+		{
+			bool depth = IsDepthFormat(m_Resources[resource].Desc.Format);
+			if (Contains(resources, resource))
+				attachments.push_back(depth ? GetDepthAttachmentPoint(m_Resources[resource].Desc.Format) : GL_COLOR_ATTACHMENT0 + colorAttachment);
+
+			if (!depth)
+				colorAttachment++;
+		}
+
+		glInvalidateNamedFramebufferData(GetFramebuffer(pass.Writes), (GLsizei)attachments.size(), attachments.data());
+	}
+
+	uint32_t RenderGraph::GetTextureId(RenderGraphResource resource) const
+	{
+		const TextureResource& texture = m_Resources[resource];
+		if (texture.ImportedId)
+			return texture.ImportedId;
+
+		OGL_ASSERT(texture.Allocation >= 0, "Texture is not alive, the pass has to declare it");
+
+		return m_Pool[texture.Allocation].Id;
+	}
+
+	uint32_t RenderGraph::GetFramebuffer(const std::vector<RenderGraphResource>& attachments)
+	{
+		std::vector<uint32_t> textures;
+		for (RenderGraphResource resource : attachments)
+			textures.push_back(GetTextureId(resource));
+
+		// Aliasing keeps the set of texture combinations small, so the framebuffers are looked up linearly
+		for (const CachedFramebuffer& framebuffer : m_Framebuffers)
+		{
+			if (framebuffer.Attachments == textures)
+				return framebuffer.Id;
+		}
+
+		CachedFramebuffer framebuffer;
+		framebuffer.Attachments = textures;
+		glCreateFramebuffers(1, &framebuffer.Id);
+
+		std::vector<GLenum> drawBuffers;
+		for (uint32_t i = 0; i < attachments.size(); i++)
+		{
+			RenderTargetFormat format = m_Resources[attachments[i]].Desc.Format;
+			if (IsDepthFormat(format))
+			{
+				glNamedFramebufferTexture(framebuffer.Id, GetDepthAttachmentPoint(format), textures[i], 0);
+			}
+			else
+			{
+				GLenum attachment = GL_COLOR_ATTACHMENT0 + (GLenum)drawBuffers.size();
+				glNamedFramebufferTexture(framebuffer.Id, attachment, textures[i], 0);
+				drawBuffers.push_back(attachment);
+			}
+		}
+
+		if (drawBuffers.empty())
+			glNamedFramebufferDrawBuffer(framebuffer.Id, GL_NONE);
+		else
+			glNamedFramebufferDrawBuffers(framebuffer.Id, (GLsizei)drawBuffers.size(), drawBuffers.data());
+
+		OGL_ASSERT(glCheckNamedFramebufferStatus(framebuffer.Id, GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE, "Framebuffer is incomplete");
+
+		m_Framebuffers.push_back(framebuffer);
+		return framebuffer.Id;
+	}
+
+}
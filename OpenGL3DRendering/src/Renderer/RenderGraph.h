@@ -0,0 +1,163 @@
+#pragma once
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <functional>
+
+#include "Renderer/RenderTargetFormat.h"
+
+// Render graph of a frame (OpenGL abstraction)
+// Passes declare the textures they read and write, the graph culls passes whose results are never used, allocates the
+// transient textures from a pool (textures with disjoint lifetimes share one allocation) and invalidates attachments once their contents are dead
+// The graph is rebuilt every frame: Reset, CreateTexture / AddPass, SetOutput, Compile, Execute
+
+namespace OpenGLRendering {
+
+	struct RenderTargetDesc
+	{
+		uint32_t Width, Height;
+		RenderTargetFormat Format = RenderTargetFormat::RGBA8;
+		uint8_t Samples = 1;
+
+		bool operator==(const RenderTargetDesc& other) const
+		{
+			return Width == other.Width && Height == other.Height && Format == other.Format && Samples == other.Samples;
+		}
+	};
+
+	using RenderGraphResource = uint32_t; // Texture of the graph, only valid until the next Reset
+
+	struct RenderGraphStats
+	{
+		uint32_t Passes; // Executed passes
+		uint32_t CulledPasses;
+		uint32_t Textures; // Textures used by the executed passes
+		uint32_t PooledTextures; // Actual allocations, including the ones kept for later frames
+		uint64_t PooledMemory; // Bytes
+		uint64_t UnaliasedMemory; // Bytes the used transient textures would take with one allocation each
+		uint64_t ImportedMemory; // Bytes of the used imported textures
+	};
+
+	class RenderGraph;
+
+	// Handed to the execute function of a pass
+	class RenderPassContext
+	{
+	public:
+		uint32_t GetTexture(RenderGraphResource resource) const;
+		void BindTexture(RenderGraphResource resource, uint32_t slot) const;
+
+		// Framebuffer with the written textures of the pass as attachments
+		uint32_t GetFramebuffer() const;
+		uint32_t GetFramebuffer(const std::vector<RenderGraphResource>& attachments) const;
+		void BindFramebuffer() const; // Also sets the viewport to the size of the attachments
+
+	private:
+		RenderPassContext(RenderGraph& graph, uint32_t pass)
+			: m_Graph(graph), m_Pass(pass) { }
+
+		friend class RenderGraph;
+
+	private:
+		RenderGraph& m_Graph;
+		uint32_t m_Pass;
+	};
+
+	class RenderGraph
+	{
+	public:
+		using ExecuteFn = std::function<void(const RenderPassContext&)>;
+
+		RenderGraph() = default;
+		~RenderGraph();
+
+		RenderGraph(const RenderGraph&) = delete;
+		RenderGraph& operator=(const RenderGraph&) = delete;
+
+		void Reset(); // Forgets the passes and textures of the last frame, the pool is kept
+
+		RenderGraphResource CreateTexture(const std::string& name, const RenderTargetDesc& desc);
+
+		// Textures that live across frames (e.g. histories) are owned by the caller, the graph never aliases or invalidates them
+		// and passes writing them are never culled. They may be read before any pass wrote them
+		RenderGraphResource ImportTexture(const std::string& name, uint32_t textureId, const RenderTargetDesc& desc);
+		void ForgetTexture(uint32_t textureId); // Has to be called before an imported texture is deleted, drops the framebuffers using it
+
+		// Written colour textures become the colour attachments in the given order, a written depth texture the depth stencil attachment
+		// The declaration order is the execution order, a pass can only read textures an earlier pass wrote
+		// Passes without writes are never culled, they are expected to have side effects outside of the graph
+		void AddPass(const char* name, const std::vector<RenderGraphResource>& reads, const std::vector<RenderGraphResource>& writes, const ExecuteFn& execute);
+
+		// The output keeps the graph alive, it is never aliased and stays valid until the next Execute
+		void SetOutput(RenderGraphResource resource);
+
+		void Compile();
+		void Execute();
+
+		uint32_t GetOutputTexture() const { return m_OutputTexture; } // 0 before the first Execute
+		const RenderTargetDesc& GetOutputDesc() const { return m_OutputDesc; }
+		const RenderTargetDesc& GetDesc(RenderGraphResource resource) const;
+		const RenderGraphStats& GetStats() const { return m_Stats; }
+
+	private:
+		struct TextureResource
+		{
+			std::string Name;
+			RenderTargetDesc Desc;
+			uint32_t RefCount = 0; // Passes reading the texture, +1 for the output and imported textures
+			uint32_t FirstPass = 0, LastPass = 0;
+			int32_t Allocation = -1; // Index into the pool while the texture is alive
+			uint32_t ImportedId = 0;
+		};
+
+		struct Pass
+		{
+			const char* Name; // Has to be a string literal, it is used for the GPU profiler
+			std::vector<RenderGraphResource> Reads;
+			std::vector<RenderGraphResource> Writes;
+			ExecuteFn Execute;
+			uint32_t RefCount = 0; // Written textures that are used later on
+			bool Culled = false;
+		};
+
+		struct PooledTexture
+		{
+			uint32_t Id;
+			RenderTargetDesc Desc;
+			bool InUse = false;
+			uint64_t LastUsedFrame = 0;
+		};
+
+		struct CachedFramebuffer
+		{
+			std::vector<uint32_t> Attachments; // Texture ids
+			uint32_t Id;
+		};
+
+		void Acquire(RenderGraphResource resource);
+		void Release(RenderGraphResource resource);
+		void TrimPool();
+		void InvalidateAttachments(const Pass& pass, const std::vector<RenderGraphResource>& resources);
+
+		uint32_t GetTextureId(RenderGraphResource resource) const;
+		uint32_t GetFramebuffer(const std::vector<RenderGraphResource>& attachments);
+
+		friend class RenderPassContext;
+
+	private:
+		std::vector<TextureResource> m_Resources;
+		std::vector<Pass> m_Passes;
+		std::vector<uint32_t> m_Order; // Indices of the passes that survived culling
+		RenderGraphResource m_Output = UINT32_MAX;
+		bool m_Compiled = false;
+
+		std::vector<PooledTexture> m_Pool;
+		std::vector<CachedFramebuffer> m_Framebuffers;
+		uint64_t m_Frame = 0;
+
+		uint32_t m_OutputTexture = 0;
+		RenderTargetDesc m_OutputDesc = { 0, 0 };
+		RenderGraphStats m_Stats = {};
+	};
+
+}
@@ -0,0 +1,44 @@
+#include "oglpch.h"
+
+#include "RenderQueue.h"
+
+namespace OpenGLRendering {
+
+	uint64_t RenderQueue::GenerateSortKey(RenderPass pass, uint32_t shaderIndex, uint32_t materialId, GeometryFormat geometryFormat, uint32_t geometryId, float normalizedDepth)
+	{
+		normalizedDepth = std::min(std::max(normalizedDepth, 0.0f), 1.0f);
+		if (pass == RenderPass::Transparent)
+			normalizedDepth = 1.0f - normalizedDepth;
+
+		uint64_t depth = (uint64_t)(normalizedDepth * (float)0x3FFFFF);
+
+		return ((uint64_t)pass & 0xF) << 60
+			| ((uint64_t)shaderIndex & 0xF) << 56
+			| ((uint64_t)materialId & 0xFFFF) << 40
+			| ((uint64_t)geometryFormat & 0x3) << 38
+			| ((uint64_t)geometryId & 0xFFFF) << 22
+			| (depth & 0x3FFFFF);
+	}
+
+	void RenderQueue::Push(const MeshInfo& mesh, uint64_t sortKey)
+	{
+		m_SortedEntries.push_back({ sortKey, (uint32_t)m_Meshes.size() });
+		m_Meshes.push_back(mesh);
+	}
+
+	void RenderQueue::Sort()
+	{
+		// Only the small key/index pairs are moved around, the draws themselves stay in submission order
+		std::sort(m_SortedEntries.begin(), m_SortedEntries.end(), [](const SortEntry& a, const SortEntry& b)
+		{
+			return a.Key < b.Key;
+		});
+	}
+
+	void RenderQueue::Clear()
+	{
+		m_Meshes.clear();
+		m_SortedEntries.clear();
+	}
+
+}
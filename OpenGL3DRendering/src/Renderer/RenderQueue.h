@@ -0,0 +1,60 @@
+#pragma once
+
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "Renderer/Shader.h"
+#include "Renderer/VertexArray.h"
+#include "Renderer/GeometryArena.h"
+#include "Renderer/Material.h"
+
+// Render queue that orders the draws of a frame by a 64 bit sort key to minimize state changes
+
+namespace OpenGLRendering {
+
+	enum class RenderPass : uint8_t
+	{
+		Opaque = 0, Transparent
+	};
+
+	struct MeshInfo
+	{
+		Ref<VertexArray> VertexArray;
+		Ref<OpenGLRendering::VertexArray> PositionVertexArray; // Same geometry ranges, used by the depth pre-pass
+		GeometryRange Geometry;
+		Ref<Material> Material;
+		Ref<Shader> Shader;
+
+		glm::mat4 ModelMatrix;
+	};
+
+	// Key layout (most significant bit first):
+	// | pass (4 bits) | shader (4 bits) | material (16 bits) | geometry format (2 bits) | geometry (16 bits) | depth (22 bits) |
+	// Opaque draws are sorted front to back inside a state bucket, transparent draws back to front.
+	class RenderQueue
+	{
+	public:
+		static uint64_t GenerateSortKey(RenderPass pass, uint32_t shaderIndex, uint32_t materialId, GeometryFormat geometryFormat, uint32_t geometryId, float normalizedDepth);
+
+		void Push(const MeshInfo& mesh, uint64_t sortKey);
+		void Sort();
+		void Clear();
+
+		uint32_t GetSize() const { return (uint32_t)m_Meshes.size(); }
+		bool IsEmpty() const { return m_Meshes.empty(); }
+
+		// Access in sorted order (only valid after Sort())
+		const MeshInfo& operator[](uint32_t index) const { return m_Meshes[m_SortedEntries[index].Index]; }
+
+	private:
+		struct SortEntry
+		{
+			uint64_t Key;
+			uint32_t Index;
+		};
+
+		std::vector<MeshInfo> m_Meshes;
+		std::vector<SortEntry> m_SortedEntries;
+	};
+
+}
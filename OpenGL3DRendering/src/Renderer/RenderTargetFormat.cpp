@@ -0,0 +1,65 @@
+#include "oglpch.h"
+
+#include "RenderTargetFormat.h"
+
+#include <glad/glad.h>
+
+namespace OpenGLRendering {
+
+	uint32_t RenderTargetFormatToOpenGLFormat(RenderTargetFormat format)
+	{
+		switch (format)
+		{
+		case RenderTargetFormat::RGBA8:				return GL_RGBA8;
+		case RenderTargetFormat::RGB10A2:			return GL_RGB10_A2;
+		case RenderTargetFormat::R11G11B10F:		return GL_R11F_G11F_B10F;
+		case RenderTargetFormat::RGBA16F:			return GL_RGBA16F;
+		case RenderTargetFormat::Depth24Stencil8:	return GL_DEPTH24_STENCIL8;
+		case RenderTargetFormat::Depth32F:			return GL_DEPTH_COMPONENT32F;
+		case RenderTargetFormat::R8:				return GL_R8;
+		}
+
+		OGL_ASSERT(false, "Unknown RenderTargetFormat");
+		return 0;
+	}
+
+	uint32_t GetBytesPerPixel(RenderTargetFormat format)
+	{
+		switch (format)
+		{
+		case RenderTargetFormat::RGBA8:				return 4;
+		case RenderTargetFormat::RGB10A2:			return 4;
+		case RenderTargetFormat::R11G11B10F:		return 4;
+		case RenderTargetFormat::RGBA16F:			return 8;
+		case RenderTargetFormat::Depth24Stencil8:	return 4;
+		case RenderTargetFormat::Depth32F:			return 4;
+		case RenderTargetFormat::R8:				return 1;
+		}
+
+		OGL_ASSERT(false, "Unknown RenderTargetFormat");
+		return 0;
+	}
+
+	uint32_t GetDepthAttachmentPoint(RenderTargetFormat format)
+	{
+		return format == RenderTargetFormat::Depth24Stencil8 ? GL_DEPTH_STENCIL_ATTACHMENT : GL_DEPTH_ATTACHMENT;
+	}
+
+	const char* GetRenderTargetFormatName(RenderTargetFormat format)
+	{
+		switch (format)
+		{
+		case RenderTargetFormat::RGBA8:				return "RGBA8";
+		case RenderTargetFormat::RGB10A2:			return "RGB10A2";
+		case RenderTargetFormat::R11G11B10F:		return "R11G11B10F";
+		case RenderTargetFormat::RGBA16F:			return "RGBA16F";
+		case RenderTargetFormat::Depth24Stencil8:	return "Depth24Stencil8";
+		case RenderTargetFormat::Depth32F:			return "Depth32F";
+		case RenderTargetFormat::R8:				return "R8";
+		}
+
+		OGL_ASSERT(false, "Unknown RenderTargetFormat");
+		return "";
+	}
+
+}
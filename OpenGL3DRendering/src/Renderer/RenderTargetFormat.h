@@ -0,0 +1,29 @@
+#pragma once
+#include <stdint.h>
+
+// Texture formats of the render targets, the render graph creates its textures and attachments from them
+
+namespace OpenGLRendering {
+
+	enum class RenderTargetFormat : uint8_t
+	{
+		RGBA8 = 0,
+		RGB10A2, // Unsigned normalized, clamps to [0, 1] but has more precision than RGBA8 at the same size
+		R11G11B10F, // HDR without alpha, the same size as RGBA8
+		RGBA16F,
+		Depth24Stencil8,
+		Depth32F, // Depth only
+		R8 // Single channel, for G-buffer data
+	};
+
+	uint32_t RenderTargetFormatToOpenGLFormat(RenderTargetFormat format);
+	uint32_t GetBytesPerPixel(RenderTargetFormat format);
+	uint32_t GetDepthAttachmentPoint(RenderTargetFormat format); // GL_DEPTH_STENCIL_ATTACHMENT or GL_DEPTH_ATTACHMENT
+	const char* GetRenderTargetFormatName(RenderTargetFormat format);
+
+	inline bool IsDepthFormat(RenderTargetFormat format)
+	{
+		return format == RenderTargetFormat::Depth24Stencil8 || format == RenderTargetFormat::Depth32F;
+	}
+
+}
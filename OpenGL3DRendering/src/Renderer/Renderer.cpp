@@ -2,38 +2,292 @@
 
 #include "Renderer.h"
 #include "RendererAPI.h"
-#include "Framebuffer.h"
+#include "RenderQueue.h"
+#include "UniformBuffer.h"
+#include "StorageBuffer.h"
+#include "IndirectBuffer.h"
+#include "StateCache.h"
+#include "StatisticsQuery.h"
+#include "GPUProfiler.h"
+#include "RenderGraph.h"
+#include "LightClusters.h"
+#include "BrdfLut.h"
+
+#include <glm/gtc/constants.hpp>
+#include <chrono>
 
 namespace OpenGLRendering {
 
-	struct MeshInfo
+	// Fixed texture units, they match the layout(binding = x) declarations of the shaders
+	enum TextureSlot : uint32_t
+	{
+		PrefilterMapSlot = 1, BrdfLutSlot = 2,
+		AlbedoSlot = 3, NormalSlot = 4, MetallicSmoothnessSlot = 5, AmbientOcclusionSlot = 6,
+		EnvironmentMapSlot = 0,
+		GBufferAlbedoSlot = 3, GBufferNormalSlot = 4, GBufferDepthSlot = 5, GBufferMetallicSlot = 6,
+		ShadowAtlasSlot = 7,
+	};
+
+	// Per frame data shared by all shaders (std140 layout, uniform block "FrameData" at binding 0)
+	struct FrameData
+	{
+		glm::mat4 View;
+		glm::mat4 Projection;
+		glm::mat4 ViewProjection;
+		glm::vec4 CameraPosition;
+		glm::vec4 LightPosition;
+		glm::vec4 LightColor;
+		glm::vec4 ViewportSize; // width, height, 1 / width, 1 / height
+		glm::vec4 EnvironmentParams; // x: max prefilter mip level
+		glm::uvec4 LightCounts; // x: lights, written in EndScene once all lights are submitted
+		glm::mat4 InverseViewProjection; // Reconstructs world positions from the depth buffer
+		glm::uvec4 ClusterCounts; // xyz: tiles x, tiles y, depth slices
+		glm::vec4 ClusterParams; // Depth slice = log(view depth) * x + y
+	};
+
+	static const uint32_t s_FrameDataBinding = 0;
+
+	static const uint32_t s_PointShadowFaces = 6;
+
+	// Sun and shadow views of the frame (std140 layout, uniform block "ShadowData" at binding 1)
+	// The matrices map world positions to the texture coordinates and depth of their atlas tile
+	struct ShadowData
+	{
+		glm::mat4 CascadeMatrices[ShadowSettings::MaxCascades];
+		glm::vec4 CascadeRects[ShadowSettings::MaxCascades]; // xy: min, zw: max texture coordinates
+		glm::vec4 CascadeSplits; // View depth where every cascade ends
+		glm::vec4 CascadeTexelSizes;
+		glm::mat4 PointShadowMatrices[s_PointShadowFaces];
+		glm::vec4 PointShadowRects[s_PointShadowFaces];
+		glm::vec4 SunDirection; // xyz: towards the sun
+		glm::vec4 SunColor;
+		glm::vec4 ShadowParams; // x: cascades, y: point light shadows, z: normal offset in texels, w: 2 / cube face size
+	};
+
+	static const uint32_t s_ShadowDataBinding = 1;
+
+	// Diffuse lighting of the environment (std140 layout, uniform block "EnvironmentData" at binding 2), only uploaded when it changes
+	static const uint32_t s_EnvironmentDataBinding = 2;
+
+	// Pipeline state blocks of the passes
+	static const PipelineState s_OpaqueState = { true, true, DepthFunction::LessEqual, BlendMode::None, CullMode::Back, true };
+	static const PipelineState s_SkyboxState = { true, false, DepthFunction::LessEqual, BlendMode::None, CullMode::Back, true }; // Drawn at the far plane, where the cleared depth already is
+	static const PipelineState s_DepthPrePassState = { true, true, DepthFunction::Less, BlendMode::None, CullMode::Back, false };
+	static const PipelineState s_DepthEqualState = { true, false, DepthFunction::Equal, BlendMode::None, CullMode::Back, true };
+	static const PipelineState s_FullscreenState = { false, true, DepthFunction::Always, BlendMode::None, CullMode::Back, true };
+	static const PipelineState s_GBufferState = { true, true, DepthFunction::Less, BlendMode::None, CullMode::Back, true }; // The alpha channels hold material data
+	static const PipelineState s_GBufferDepthEqualState = { true, false, DepthFunction::Equal, BlendMode::None, CullMode::Back, true };
+	static const PipelineState s_LightVolumeState = { false, false, DepthFunction::Always, BlendMode::Additive, CullMode::None, true };
+	static const PipelineState s_ShadowState = { true, true, DepthFunction::Less, BlendMode::None, CullMode::None, false }; // Meshes aren't guaranteed to be closed
+
+	// Estimated average number of opaque layers per pixel above which the automatic depth pre-pass kicks in
+	static const float s_AutoDepthPrePassComplexity = 1.5f;
+
+	// The output only follows a new viewport size once it stayed unchanged this long, dragging a panel would reallocate every frame otherwise
+	static const float s_ResizeDelay = 150.0f; // Milliseconds
+
+	// Scene targets are allocated in steps of this many pixels, so small size changes keep using the same targets
+	static const uint32_t s_TargetSizeGranularity = 128;
+	static const uint64_t s_TargetShrinkFactor = 2; // Targets with more than this many times the needed area are shrunk
+
+	// Projected bounding sphere radius (relative to half the viewport height) below which LOD 1 is used, halved for every further level
+	static const float s_LodScreenSize = 0.5f;
+	static const float s_LodHysteresis = 0.1f;
+
+	// Per instance vertex data, stored in one shared buffer that is attached to every geometry arena vertex array
+	struct InstanceData
+	{
+		glm::mat4 ModelMatrix;
+		int32_t MaterialIndex; // Index into the material storage buffer (untextured materials only)
+	};
+
+	// Parameters of an untextured material (std430 layout, storage block "Materials" at binding 0)
+	struct MaterialData
+	{
+		glm::vec4 Albedo; // rgb: albedo
+		glm::vec4 Params; // x: roughness, y: metallic, z: ambient occlusion
+	};
+
+	static const uint32_t s_MaterialBinding = 0;
+
+	// Point or spot light (std430 layout, storage block "Lights" at binding 1)
+	// The spot factor is clamp(dot(-L, direction) * scale + offset, 0, 1), point lights use a scale of 0 and an offset of 1
+	struct LightData
+	{
+		glm::vec4 PositionRadius; // xyz: world position, w: radius
+		glm::vec4 Color; // rgb: colour, w: spot offset
+		glm::vec4 Direction; // xyz: spot direction, w: spot scale
+	};
+
+	static const uint32_t s_LightBinding = 1;
+	static const uint32_t s_ClusterRangeBinding = 2;
+	static const uint32_t s_LightIndexBinding = 3;
+
+	// Consecutive draws of the sorted queue that share shader, material and geometry
+	struct DrawBatch
+	{
+		uint32_t First; // Index into the sorted queue
+		uint32_t InstanceCount;
+		uint32_t BaseInstance;
+		uint32_t Bucket; // Only used for indirect drawing
+	};
+
+	// Batches that can be issued with one multi draw call (same shader and vertex array, same material for textured draws)
+	struct DrawBucket
 	{
-		Ref<VertexArray> VertexArray;
-		Ref<Material> Material;
+		uint32_t FirstBatch;
+		uint32_t FirstCommand;
+		uint32_t CommandCount;
+	};
 
+	// Mesh that may cast a shadow, collected in Submit before the camera culling
+	struct ShadowCaster
+	{
+		Ref<VertexArray> VertexArray; // Position only
+		GeometryRange Geometry;
 		glm::mat4 ModelMatrix;
+		BoundingSphere Sphere; // World space
+	};
+
+	// Consecutive casters of a shadow view with the same geometry, drawn instanced
+	struct ShadowBatch
+	{
+		VertexArray* VertexArray;
+		GeometryRange Geometry;
+		uint32_t InstanceCount;
+		uint32_t BaseInstance;
+	};
+
+	// Atlas tile of a cascade or cube face, the cache holds the static casters rendered with the cached matrix
+	// and the live tile is the cache plus the dynamic casters of the last frame the view was rendered
+	struct ShadowView
+	{
+		ShadowAtlasTile Tile;
+		bool Allocated = false;
+		bool Active = false; // Sampled this frame
+		glm::mat4 ViewProjection = glm::mat4(1.0f);
+
+		bool CacheValid = false;
+		glm::mat4 CachedViewProjection = glm::mat4(1.0f);
+		uint64_t CachedStaticHash = 0;
+		bool LiveHasDynamic = false;
+
+		// Work of the frame, the batches index into the shadow batches of the frame
+		bool RenderStatic = false; // Into the cache, or straight into the atlas without caching
+		bool UpdateLive = false;
+		uint32_t FirstStaticBatch = 0, StaticBatchCount = 0;
+		uint32_t FirstDynamicBatch = 0, DynamicBatchCount = 0;
 	};
 
+	static const uint32_t s_ShadowViewCount = ShadowSettings::MaxCascades + s_PointShadowFaces; // Cascades first
+
+	static const uint32_t s_InstanceAttributeLocation = 5; // Mesh vertex formats use locations 0 - 4
+	static const uint32_t s_InitialInstanceCapacity = 1024;
+	static const uint32_t s_InitialMaterialCapacity = 64;
+	static const uint32_t s_InitialCommandCapacity = 256;
+	static const uint32_t s_InitialArenaVertexCapacity = 1 << 16;
+	static const uint32_t s_InitialArenaIndexCapacity = 1 << 18;
+	static const uint32_t s_InitialLightCapacity = 64;
+	static const uint32_t s_InitialLightIndexCapacity = 4096;
+
 	struct RendererData
 	{
 		Ref<Camera> Camera;
 		Ref<Cubemap> Cubemap;
+		Scope<BrdfLut> BrdfLut; // Shared by all environments
 
 		Ref<Shader> PBRShaderTextured;
 		Ref<Shader> PBRShader;
+		Ref<Shader> DepthShader;
+		Ref<Shader> ShadowShader;
+		Ref<Shader> GBufferShaderTextured;
+		Ref<Shader> GBufferShader;
+		Ref<Shader> DeferredLightingShader;
+		Ref<Shader> LightVolumeShader;
 		Ref<Shader> CubemapShader;
-		Ref<Shader> ColorGradingShader;
-		Ref<Shader> InvertColorShader;
+		Ref<Shader> TonemapShader;
+		Ref<Shader> UpscaleShader;
+		PostProcessShaderCache PostProcessShaders;
+		Ref<Shader> FXAAShader;
+		Ref<Shader> SMAAEdgeShader;
+		Ref<Shader> SMAAWeightShader;
+		Ref<Shader> SMAABlendShader;
+		Ref<Shader> TAAShader;
+
+		// Rebuilt every frame, the scene passes are added in EndScene and the post processing passes after it
+		RenderGraph Graph;
+		RenderGraphResource FrameColor; // Latest colour result of the frame, the graph output
+		uint32_t Width = 1920, Height = 1080; // Output size
+		uint32_t RequestedWidth = 1920, RequestedHeight = 1080;
+		std::chrono::steady_clock::time_point ResizeTime;
+		uint64_t FrameIndex = 0;
+
+		// The scene targets are allocated in size buckets of at least the output size, the scene passes only cover their lower left
+		// RenderWidth x RenderHeight pixels and the upscale (or a copy) moves that part into an output sized texture
+		uint32_t TargetWidth = 0, TargetHeight = 0;
+		DynamicResolution DynamicResolution;
+		uint32_t RenderWidth = 1920, RenderHeight = 1080;
 
-		Ref<Framebuffer> MultisampleFramebuffer;
-		Ref<Framebuffer> IntermediateFramebuffer;
-		Ref<Framebuffer> FinalFramebuffer;
+		// The scene is shaded into a linear HDR target, the tonemap pass maps it to the display once per pixel
+		RenderTargetFormat SceneColorFormat = RenderTargetFormat::R11G11B10F;
+		float Exposure = 1.0f;
+		float Gamma = 2.2f;
 
-		std::vector<MeshInfo> Meshes;
+		// The deferred path writes the surfaces into a G-buffer first and shades every pixel once, lights only touch the pixels they reach
+		ShadingPath ShadingPath = ShadingPath::Forward;
+
+		AntiAliasingMode AntiAliasingMode = AntiAliasingMode::MSAA8x;
+		TemporalAntiAliasing TemporalAntiAliasing;
+
+		RenderQueue Queue;
+		Frustum Frustum;
+		bool FrustumCulling = true;
+		std::vector<uint32_t> VisibleMeshes;
+		bool AutomaticLod = true;
+		float LodBias = 1.0f;
 		LightInfo LightInfo;
 		Ref<VertexArray> QuadVertexArray;
-		
-		bool RenderedToFinalBuffer;
+		Ref<UniformBuffer> FrameUniformBuffer;
+		Ref<GeometryArena> GeometryArenas[2]; // Indexed by the geometry format, created with the first mesh of the format
+
+		Ref<VertexBuffer> InstanceBuffer;
+		std::vector<InstanceData> Instances;
+		std::vector<DrawBatch> Batches;
+
+		Ref<StorageBuffer> MaterialBuffer;
+		std::vector<MaterialData> Materials;
+		std::unordered_map<uint32_t, int32_t> MaterialIndices; // Material id -> index into Materials
+
+		// Submitted lights are culled in EndScene, the forward path reads the visible ones through the light clusters
+		std::vector<LightData> SubmittedLights;
+		std::vector<LightData> Lights;
+		std::vector<glm::vec4> LightSpheres; // View space bounds of the visible lights
+		Ref<StorageBuffer> LightBuffer;
+		Scope<LightClusterGrid> LightClusters;
+		Ref<StorageBuffer> ClusterRangeBuffer;
+		Ref<StorageBuffer> LightIndexBuffer;
+		glm::mat4 Projection; // Of the frame, jittered with TAA
+
+		// Shadow views of the sun cascades and the main light, see Shadows.h
+		ShadowSettings ShadowSettings;
+		ShadowAtlas ShadowAtlas;
+		ShadowView ShadowViews[s_ShadowViewCount];
+		bool ShadowTilesValid = false; // Cleared when the settings change the tile layout
+		std::vector<ShadowCaster> StaticCasters;
+		std::vector<ShadowCaster> DynamicCasters;
+		uint64_t StaticCasterHash = 0; // Independent of the submission order, a change invalidates every cached tile
+		std::vector<ShadowBatch> ShadowBatches;
+		Ref<UniformBuffer> ShadowUniformBuffer;
+		Ref<UniformBuffer> EnvironmentUniformBuffer;
+
+		bool IndirectDrawing = true;
+		Ref<IndirectBuffer> CommandBuffer;
+		std::vector<DrawIndexedIndirectCommand> Commands;
+		std::vector<DrawBucket> Buckets;
+
+		DepthPrePassMode DepthPrePassMode = DepthPrePassMode::Auto;
+		Scope<StatisticsQuery> PrePassFragmentQuery; // Only created if fragment shader invocations can be queried
+		Scope<StatisticsQuery> ShadingFragmentQuery;
 
 		RendererStats Stats;
 	};
@@ -42,11 +296,24 @@ namespace OpenGLRendering {
 
 	void Renderer::Init()
 	{
+		OGL_PROFILE_FUNCTION();
+
 		s_RendererData.PBRShaderTextured = CreateRef<Shader>("src/Resources/ShaderSource/PBR/vertex_textured_pbr.glsl", "src/Resources/ShaderSource/PBR/fragment_textured_pbr.glsl");
 		s_RendererData.PBRShader = CreateRef<Shader>("src/Resources/ShaderSource/PBR/vertex_static_pbr.glsl", "src/Resources/ShaderSource/PBR/fragment_static_pbr.glsl");
+		s_RendererData.DepthShader = CreateRef<Shader>("src/Resources/ShaderSource/PBR/vertex_depth.glsl", "src/Resources/ShaderSource/PBR/fragment_depth.glsl");
+		s_RendererData.ShadowShader = CreateRef<Shader>("src/Resources/ShaderSource/Shadows/shadow_vertex.glsl", "src/Resources/ShaderSource/PBR/fragment_depth.glsl");
+		s_RendererData.GBufferShaderTextured = CreateRef<Shader>("src/Resources/ShaderSource/PBR/vertex_textured_pbr.glsl", "src/Resources/ShaderSource/PBR/fragment_textured_gbuffer.glsl");
+		s_RendererData.GBufferShader = CreateRef<Shader>("src/Resources/ShaderSource/PBR/vertex_static_pbr.glsl", "src/Resources/ShaderSource/PBR/fragment_static_gbuffer.glsl");
+		s_RendererData.DeferredLightingShader = CreateRef<Shader>("src/Resources/ShaderSource/PostProcessing/post_process_vertex.glsl", "src/Resources/ShaderSource/Deferred/deferred_lighting_fragment.glsl");
+		s_RendererData.LightVolumeShader = CreateRef<Shader>("src/Resources/ShaderSource/Deferred/light_volume_vertex.glsl", "src/Resources/ShaderSource/Deferred/light_volume_fragment.glsl");
 		s_RendererData.CubemapShader = CreateRef<Shader>("src/Resources/ShaderSource/Cubemap/background_vertex.glsl", "src/Resources/ShaderSource/Cubemap/background_fragment.glsl");
-		s_RendererData.ColorGradingShader = CreateRef<Shader>("src/Resources/ShaderSource/PostProcessing/color_grading_vertex.glsl", "src/Resources/ShaderSource/PostProcessing/color_grading_fragment.glsl");
-		s_RendererData.InvertColorShader = CreateRef<Shader>("src/Resources/ShaderSource/PostProcessing/color_invert_vertex.glsl", "src/Resources/ShaderSource/PostProcessing/color_invert_fragment.glsl");
+		s_RendererData.TonemapShader = CreateRef<Shader>("src/Resources/ShaderSource/PostProcessing/post_process_vertex.glsl", "src/Resources/ShaderSource/PostProcessing/tonemap_fragment.glsl");
+		s_RendererData.UpscaleShader = CreateRef<Shader>("src/Resources/ShaderSource/PostProcessing/post_process_vertex.glsl", "src/Resources/ShaderSource/PostProcessing/upscale_fragment.glsl");
+		s_RendererData.FXAAShader = CreateRef<Shader>("src/Resources/ShaderSource/PostProcessing/post_process_vertex.glsl", "src/Resources/ShaderSource/AntiAliasing/fxaa_fragment.glsl");
+		s_RendererData.SMAAEdgeShader = CreateRef<Shader>("src/Resources/ShaderSource/PostProcessing/post_process_vertex.glsl", "src/Resources/ShaderSource/AntiAliasing/smaa_edges_fragment.glsl");
+		s_RendererData.SMAAWeightShader = CreateRef<Shader>("src/Resources/ShaderSource/PostProcessing/post_process_vertex.glsl", "src/Resources/ShaderSource/AntiAliasing/smaa_weights_fragment.glsl");
+		s_RendererData.SMAABlendShader = CreateRef<Shader>("src/Resources/ShaderSource/PostProcessing/post_process_vertex.glsl", "src/Resources/ShaderSource/AntiAliasing/smaa_blend_fragment.glsl");
+		s_RendererData.TAAShader = CreateRef<Shader>("src/Resources/ShaderSource/PostProcessing/post_process_vertex.glsl", "src/Resources/ShaderSource/AntiAliasing/taa_fragment.glsl");
 
 		float quadVertices[] =
 		{
@@ -75,207 +342,1546 @@ namespace OpenGLRendering {
 		s_RendererData.QuadVertexArray->AddVertexBuffer(vb);
 		s_RendererData.QuadVertexArray->SetIndexBuffer(ib);
 
-		FramebufferSettings settings = { 1920, 1080, true, true, 8 };
-		s_RendererData.MultisampleFramebuffer = CreateRef<Framebuffer>(settings);
-		settings = { 1920, 1080 };
-		s_RendererData.IntermediateFramebuffer = CreateRef<Framebuffer>(settings);
-		s_RendererData.FinalFramebuffer = CreateRef<Framebuffer>(settings);
+		s_RendererData.BrdfLut = CreateScope<BrdfLut>(s_RendererData.QuadVertexArray);
+
+		s_RendererData.FrameUniformBuffer = CreateRef<UniformBuffer>((uint32_t)sizeof(FrameData), s_FrameDataBinding);
+		s_RendererData.ShadowUniformBuffer = CreateRef<UniformBuffer>((uint32_t)sizeof(ShadowData), s_ShadowDataBinding);
+		s_RendererData.EnvironmentUniformBuffer = CreateRef<UniformBuffer>((uint32_t)sizeof(IrradianceSH), s_EnvironmentDataBinding);
+
+		s_RendererData.InstanceBuffer = CreateRef<VertexBuffer>(s_InitialInstanceCapacity * (uint32_t)sizeof(InstanceData));
+		s_RendererData.InstanceBuffer->SetLayout(
+		{
+			{ ShaderDataType::Mat4, "a_ModelMatrix", false, true },
+			{ ShaderDataType::Int, "a_MaterialIndex", false, true },
+		});
+
+		s_RendererData.MaterialBuffer = CreateRef<StorageBuffer>(s_InitialMaterialCapacity * (uint32_t)sizeof(MaterialData), s_MaterialBinding);
+		s_RendererData.CommandBuffer = CreateRef<IndirectBuffer>(s_InitialCommandCapacity * (uint32_t)sizeof(DrawIndexedIndirectCommand));
+		s_RendererData.LightBuffer = CreateRef<StorageBuffer>(s_InitialLightCapacity * (uint32_t)sizeof(LightData), s_LightBinding);
+		s_RendererData.ClusterRangeBuffer = CreateRef<StorageBuffer>(LightClusterGrid::ClusterCount * (uint32_t)sizeof(ClusterRange), s_ClusterRangeBinding);
+		s_RendererData.LightIndexBuffer = CreateRef<StorageBuffer>(s_InitialLightIndexCapacity * (uint32_t)sizeof(uint32_t), s_LightIndexBinding);
+
+		// The calling thread assigns its share of the clusters too
+		uint32_t hardwareThreads = std::max(std::thread::hardware_concurrency(), 1u);
+		s_RendererData.LightClusters = CreateScope<LightClusterGrid>(hardwareThreads - 1);
+
+		if (StatisticsQuery::IsSupported(StatisticsType::FragmentShaderInvocations))
+		{
+			s_RendererData.PrePassFragmentQuery = CreateScope<StatisticsQuery>(StatisticsType::FragmentShaderInvocations);
+			s_RendererData.ShadingFragmentQuery = CreateScope<StatisticsQuery>(StatisticsType::FragmentShaderInvocations);
+		}
+		else
+		{
+			OGL_WARN("Fragment shader invocation queries are not supported, depth pre-pass savings won't be reported");
+		}
+	}
+
+	void Renderer::Shutdown()
+	{
+		// The draws of the last frame still reference the arenas, the meshes release their references when they are destroyed
+		s_RendererData.Queue.Clear();
+		s_RendererData.Batches.clear();
+		s_RendererData.StaticCasters.clear();
+		s_RendererData.DynamicCasters.clear();
+		s_RendererData.ShadowBatches.clear();
+		s_RendererData.Camera.reset();
+		s_RendererData.Cubemap.reset();
+
+		for (Ref<GeometryArena>& arena : s_RendererData.GeometryArenas)
+			arena.reset();
+
+		s_RendererData.BrdfLut.reset();
+	}
+
+	const Ref<GeometryArena>& Renderer::GetGeometryArena(GeometryFormat format)
+	{
+		Ref<GeometryArena>& arena = s_RendererData.GeometryArenas[(uint32_t)format];
+		if (arena)
+			return arena;
+
+		if (format == GeometryFormat::Simple)
+		{
+			arena = CreateRef<GeometryArena>(format, VertexBufferLayout(
+			{
+				{ ShaderDataType::Float3, "a_Position" },
+				{ ShaderDataType::Float3, "a_Normal" },
+			}), s_InitialArenaVertexCapacity, s_InitialArenaIndexCapacity);
+		}
+		else
+		{
+			arena = CreateRef<GeometryArena>(format, VertexBufferLayout(
+			{
+				{ ShaderDataType::Float3, "a_Position" },
+				{ ShaderDataType::Float3, "a_Normal" },
+				{ ShaderDataType::Float2, "a_TextureCoords" },
+				{ ShaderDataType::Float3, "a_Tangent" },
+				{ ShaderDataType::Float3, "a_Bitangent" }
+			}), s_InitialArenaVertexCapacity, s_InitialArenaIndexCapacity);
+		}
+
+		return arena;
 	}
 
 	void Renderer::OnResize(uint32_t width, uint32_t height)
 	{
-		s_RendererData.MultisampleFramebuffer->Resize(width, height);
-		s_RendererData.IntermediateFramebuffer->Resize(width, height);
-		s_RendererData.FinalFramebuffer->Resize(width, height);
+		OGL_ASSERT(width > 0 && height > 0, "Viewport size has to be at least 1x1");
+
+		// Applied in BeginScene once the size stopped changing
+		if (width == s_RendererData.RequestedWidth && height == s_RendererData.RequestedHeight)
+			return;
+
+		s_RendererData.RequestedWidth = width;
+		s_RendererData.RequestedHeight = height;
+		s_RendererData.ResizeTime = std::chrono::steady_clock::now();
+	}
+
+	static uint32_t RoundUpToTargetSize(uint32_t size)
+	{
+		return (size + s_TargetSizeGranularity - 1) / s_TargetSizeGranularity * s_TargetSizeGranularity;
+	}
+
+	// Until a requested size is applied, the last output is stretched over the viewport
+	// Textures of an old size leave the pool of the graph after a few frames
+	static void UpdateRenderTargetSizes()
+	{
+		RendererData& data = s_RendererData;
+
+		if (data.RequestedWidth != data.Width || data.RequestedHeight != data.Height)
+		{
+			float elapsed = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - data.ResizeTime).count();
+			if (data.FrameIndex == 0 || elapsed >= s_ResizeDelay)
+			{
+				data.Width = data.RequestedWidth;
+				data.Height = data.RequestedHeight;
+			}
+		}
+
+		uint32_t bucketWidth = RoundUpToTargetSize(data.Width), bucketHeight = RoundUpToTargetSize(data.Height);
+		if (data.TargetWidth < data.Width || data.TargetHeight < data.Height)
+		{
+			data.TargetWidth = std::max(data.TargetWidth, bucketWidth);
+			data.TargetHeight = std::max(data.TargetHeight, bucketHeight);
+		}
+
+		if ((uint64_t)data.TargetWidth * data.TargetHeight > s_TargetShrinkFactor * bucketWidth * bucketHeight)
+		{
+			data.TargetWidth = bucketWidth;
+			data.TargetHeight = bucketHeight;
+		}
+
+		data.RenderWidth = data.DynamicResolution.GetRenderSize(data.Width);
+		data.RenderHeight = data.DynamicResolution.GetRenderSize(data.Height);
+		data.FrameIndex++;
 	}
 
 	void Renderer::BeginScene(Ref<Camera>& camera, Ref<Cubemap>& cubemap, const LightInfo& lightInfo)
 	{
+		OGL_PROFILE_FUNCTION();
+
+		// ImGui and resource creation talk to OpenGL directly between frames
+		StateCache::Invalidate();
+		StateCache::ResetStats();
+
 		s_RendererData.Camera = camera;
-		s_RendererData.Cubemap = cubemap;
+		if (cubemap != s_RendererData.Cubemap)
+		{
+			s_RendererData.Cubemap = cubemap;
+			s_RendererData.EnvironmentUniformBuffer->SetData(&cubemap->GetIrradianceSH(), sizeof(IrradianceSH));
+		}
 		s_RendererData.LightInfo = lightInfo;
 
+		// The GPU time of a frame a few frames back decides the resolution of this one
+		s_RendererData.DynamicResolution.Update(GPUProfiler::GetFrameTime());
+		UpdateRenderTargetSizes();
+
+		float width = (float)s_RendererData.RenderWidth, height = (float)s_RendererData.RenderHeight;
+
+		// TAA moves the projection by a different sub-pixel offset every frame, culling and LOD selection use the camera without jitter
+		glm::mat4 projection = camera->GetProjectionMatrix();
+		TemporalAntiAliasing& taa = s_RendererData.TemporalAntiAliasing;
+		if (s_RendererData.AntiAliasingMode == AntiAliasingMode::TAA)
+		{
+			taa.BeginFrame(s_RendererData.Graph, camera->GetViewMatrix(), projection, s_RendererData.Width, s_RendererData.Height, s_RendererData.RenderWidth, s_RendererData.RenderHeight);
+			projection = taa.GetJitteredProjection();
+		}
+		else
+		{
+			taa.Reset();
+		}
+
+		FrameData frameData;
+		frameData.View = camera->GetViewMatrix();
+		frameData.Projection = projection;
+		frameData.ViewProjection = projection * camera->GetViewMatrix();
+		frameData.CameraPosition = glm::vec4(camera->GetPosition(), 1.0f);
+		frameData.LightPosition = glm::vec4(lightInfo.LightPos, 1.0f);
+		frameData.LightColor = glm::vec4(lightInfo.LightColor, 1.0f);
+		frameData.ViewportSize = { width, height, 1.0f / width, 1.0f / height };
+		frameData.EnvironmentParams = { (float)(cubemap->GetPrefilterMipLevels() - 1), 0.0f, 0.0f, 0.0f };
+		frameData.LightCounts = { 0, 0, 0, 0 };
+		frameData.InverseViewProjection = glm::inverse(frameData.ViewProjection);
+		frameData.ClusterCounts = { LightClusterGrid::TilesX, LightClusterGrid::TilesY, LightClusterGrid::Slices, 0 };
+		glm::vec2 sliceParams = LightClusterGrid::GetSliceParams(camera->GetNearClip(), camera->GetFarClip());
+		frameData.ClusterParams = { sliceParams.x, sliceParams.y, 0.0f, 0.0f };
+		s_RendererData.Projection = projection;
+
+		s_RendererData.FrameUniformBuffer->SetData(&frameData, sizeof(FrameData));
+
 		s_RendererData.Stats.VertexCount = 0;
 		s_RendererData.Stats.FaceCount = 0;
 		s_RendererData.Stats.DrawCalls = 0;
-		s_RendererData.RenderedToFinalBuffer = false;
+		s_RendererData.Stats.SubmittedMeshes = 0;
+		s_RendererData.Stats.CulledMeshes = 0;
+		s_RendererData.Stats.DrawnMeshes = 0;
+		s_RendererData.Stats.BoundsTests = 0;
+		s_RendererData.Stats.LodSwitches = 0;
+		s_RendererData.Stats.EstimatedDepthComplexity = 0.0f;
+		s_RendererData.Stats.LightIndices = 0;
+		s_RendererData.Stats.LightAssignmentTime = 0.0f;
+		s_RendererData.SubmittedLights.clear();
+		s_RendererData.StaticCasters.clear();
+		s_RendererData.DynamicCasters.clear();
+		s_RendererData.StaticCasterHash = 0;
+		s_RendererData.Frustum = Frustum(camera->GetViewProjectionMatrix());
+		s_RendererData.Graph.Reset();
 	}
 
-	void Renderer::EndScene()
+	// Shader indices used in the sort key, draws are grouped by shader first
+	enum PBRShaderIndex : uint32_t
 	{
-		s_RendererData.MultisampleFramebuffer->Bind();
-		RendererAPI::Clear();
+		PBRShaderStatic = 0, PBRShaderTextured = 1
+	};
+
+	static void BindMaterialTextures(const Ref<Material>& material)
+	{
+		const std::unordered_map<TextureType, Ref<Texture2D>>& textures = material->GetTextures();
+
+		if (textures.find(TextureType::ALBEDO) != textures.end())
+			textures.at(TextureType::ALBEDO)->Bind(AlbedoSlot);
+
+		if (textures.find(TextureType::NORMAL) != textures.end())
+			textures.at(TextureType::NORMAL)->Bind(NormalSlot);
 
-		s_RendererData.Cubemap->BindIrradianceMap(0);
-		s_RendererData.Cubemap->BindPrefilterMap(1);
-		s_RendererData.Cubemap->BindBrdfLutTexture(2);
+		if (textures.find(TextureType::METALLIC_SMOOTHNESS) != textures.end())
+			textures.at(TextureType::METALLIC_SMOOTHNESS)->Bind(MetallicSmoothnessSlot);
 
-		for (const MeshInfo& mesh : s_RendererData.Meshes)
+		if (textures.find(TextureType::AMBIENT_OCCLUSION) != textures.end())
+			textures.at(TextureType::AMBIENT_OCCLUSION)->Bind(AmbientOcclusionSlot);
+	}
+
+	// Untextured materials are read from the material storage buffer, so draws with different materials can share a draw call
+	static int32_t GetMaterialIndex(const Ref<Material>& material)
+	{
+		if (material->IsUsingTextures())
+			return 0;
+
+		auto it = s_RendererData.MaterialIndices.find(material->GetId());
+		if (it != s_RendererData.MaterialIndices.end())
+			return it->second;
+
+		int32_t index = (int32_t)s_RendererData.Materials.size();
+		s_RendererData.Materials.push_back({ glm::vec4(material->GetAlbedo(), 1.0f), { material->GetRoughness(), material->GetMetallic(), material->GetAmbientOcclusion(), 0.0f } });
+		s_RendererData.MaterialIndices[material->GetId()] = index;
+
+		return index;
+	}
+
+	// Textures are bound per draw call, so textured draws can only be merged if they share the material
+	static bool IsSameBucket(const MeshInfo& a, const MeshInfo& b)
+	{
+		if (a.Shader != b.Shader || a.VertexArray != b.VertexArray)
+			return false;
+
+		return !a.Material->IsUsingTextures() || a.Material == b.Material;
+	}
+
+	// Grows a buffer by doubling its size, the contents are uploaded completely afterwards
+	template<typename T>
+	static void ReserveBufferSize(const Ref<T>& buffer, uint32_t size)
+	{
+		if (size <= buffer->GetSize())
+			return;
+
+		uint32_t capacity = buffer->GetSize();
+		while (capacity < size)
+			capacity *= 2;
+
+		buffer->Resize(capacity);
+	}
+
+	// What the batches are drawn for, the depth only mode expects the depth shader to be bound already
+	enum class DrawMode : uint8_t
+	{
+		Shaded = 0, DepthOnly, GBuffer
+	};
+
+	struct BoundState
+	{
+		const Shader* Shader = nullptr;
+		const Material* Material = nullptr;
+		const VertexArray* VertexArray = nullptr;
+	};
+
+	// State only has to be set when it actually changes between draws
+	static void BindDrawState(const MeshInfo& mesh, BoundState& state, DrawMode mode)
+	{
+		if (mode != DrawMode::DepthOnly)
 		{
-			if (mesh.Material->IsUsingTextures())
+			// The G-buffer shaders share the vertex shaders and material inputs of the shading variants
+			const Shader* shader = mesh.Shader.get();
+			if (mode == DrawMode::GBuffer)
+				shader = mesh.Shader == s_RendererData.PBRShaderTextured ? s_RendererData.GBufferShaderTextured.get() : s_RendererData.GBufferShader.get();
+
+			if (shader != state.Shader)
 			{
-				s_RendererData.PBRShaderTextured->Bind();
-				s_RendererData.PBRShaderTextured->SetMat4("u_Projection", s_RendererData.Camera->GetProjectionMatrix());
-				s_RendererData.PBRShaderTextured->SetMat4("u_View", s_RendererData.Camera->GetViewMatrix());
-				s_RendererData.PBRShaderTextured->SetMat4("u_Model", mesh.ModelMatrix);
-				s_RendererData.PBRShaderTextured->SetFloat3("u_LightPos", s_RendererData.LightInfo.LightPos);
-				s_RendererData.PBRShaderTextured->SetFloat3("u_LightColor", s_RendererData.LightInfo.LightColor);
-				s_RendererData.PBRShaderTextured->SetFloat3("u_CameraPos", s_RendererData.Camera->GetPosition());
-
-				s_RendererData.PBRShaderTextured->SetInt("u_IrradianceMap", 0);
-				s_RendererData.PBRShaderTextured->SetInt("u_PrefilterMap", 1);
-				s_RendererData.PBRShaderTextured->SetInt("u_BrdfLutTexture", 2);
-
-				const std::unordered_map<TextureType, Ref<Texture2D>>& textures = mesh.Material->GetTextures();
-				
-				if (textures.find(TextureType::ALBEDO) != textures.end())
-				{
-					textures.at(TextureType::ALBEDO)->Bind(3);
-					s_RendererData.PBRShaderTextured->SetInt("u_TextureAlbedo", 3);
-				}
+				shader->Bind();
+				state.Shader = shader;
+			}
+		}
 
-				if (textures.find(TextureType::NORMAL) != textures.end())
-				{
-					textures.at(TextureType::NORMAL)->Bind(4);
-					s_RendererData.PBRShaderTextured->SetInt("u_TextureNormal", 4);
-				}
+		if (mode != DrawMode::DepthOnly && mesh.Material.get() != state.Material)
+		{
+			if (mesh.Material->IsUsingTextures())
+				BindMaterialTextures(mesh.Material);
 
-				if (textures.find(TextureType::METALLIC_SMOOTHNESS) != textures.end())
-				{
-					textures.at(TextureType::METALLIC_SMOOTHNESS)->Bind(5);
-					s_RendererData.PBRShaderTextured->SetInt("u_TextureMetallicSmooth", 5);
-				}
+			state.Material = mesh.Material.get();
+		}
 
-				if (textures.find(TextureType::AMBIENT_OCCLUSION) != textures.end())
-				{
-					textures.at(TextureType::AMBIENT_OCCLUSION)->Bind(6);
-					s_RendererData.PBRShaderTextured->SetInt("u_TextureAmbient", 6);
-				}
+		// The depth only passes read the packed position stream of the arena
+		VertexArray* vertexArray = mode == DrawMode::DepthOnly ? mesh.PositionVertexArray.get() : mesh.VertexArray.get();
+		if (vertexArray != state.VertexArray)
+		{
+			if (!vertexArray->HasVertexBuffer(s_RendererData.InstanceBuffer))
+				vertexArray->AddVertexBuffer(s_RendererData.InstanceBuffer, s_InstanceAttributeLocation);
+
+			vertexArray->Bind();
+			state.VertexArray = vertexArray;
+		}
+	}
+
+	static void BuildIndirectCommands()
+	{
+		OGL_PROFILE_FUNCTION();
+
+		// Every batch becomes one indirect command, the per draw data is fetched through the base instance
+		RenderQueue& queue = s_RendererData.Queue;
+		std::vector<DrawBatch>& batches = s_RendererData.Batches;
+		std::vector<DrawBucket>& buckets = s_RendererData.Buckets;
+		std::vector<DrawIndexedIndirectCommand>& commands = s_RendererData.Commands;
+		buckets.clear();
+
+		for (uint32_t b = 0; b < batches.size(); b++)
+		{
+			const MeshInfo& mesh = queue[batches[b].First];
+
+			// There are only a few buckets (one per vertex format and textured material), a linear search is fine
+			uint32_t bucket = 0;
+			while (bucket < buckets.size() && !IsSameBucket(mesh, queue[batches[buckets[bucket].FirstBatch].First]))
+				bucket++;
+
+			if (bucket == buckets.size())
+				buckets.push_back({ b, 0, 0 });
+
+			buckets[bucket].CommandCount++;
+			batches[b].Bucket = bucket;
+		}
+
+		uint32_t commandCount = 0;
+		for (DrawBucket& bucket : buckets)
+		{
+			bucket.FirstCommand = commandCount;
+			commandCount += bucket.CommandCount;
+			bucket.CommandCount = 0;
+		}
+
+		commands.resize(commandCount);
+		for (const DrawBatch& batch : batches)
+		{
+			const GeometryRange& geometry = queue[batch.First].Geometry;
+			DrawBucket& bucket = buckets[batch.Bucket];
+
+			commands[bucket.FirstCommand + bucket.CommandCount++] = { geometry.IndexCount, batch.InstanceCount, geometry.FirstIndex, (int32_t)geometry.BaseVertex, batch.BaseInstance };
+		}
+
+		uint32_t commandDataSize = commandCount * (uint32_t)sizeof(DrawIndexedIndirectCommand);
+		ReserveBufferSize(s_RendererData.CommandBuffer, commandDataSize);
+		if (commandDataSize)
+			s_RendererData.CommandBuffer->SetData(commands.data(), commandDataSize);
+	}
+
+	// Draws all batches of the frame
+	static void DrawBatches(DrawMode mode)
+	{
+		OGL_PROFILE_FUNCTION();
+
+		RenderQueue& queue = s_RendererData.Queue;
+		BoundState state;
 
-				RendererAPI::DrawIndexed(mesh.VertexArray, 0);
+		if (s_RendererData.IndirectDrawing)
+		{
+			s_RendererData.CommandBuffer->Bind();
+			for (const DrawBucket& bucket : s_RendererData.Buckets)
+			{
+				BindDrawState(queue[s_RendererData.Batches[bucket.FirstBatch].First], state, mode);
+
+				RendererAPI::MultiDrawIndexedIndirect(bucket.FirstCommand, bucket.CommandCount);
 				s_RendererData.Stats.DrawCalls += 1;
 			}
-			else
+			s_RendererData.CommandBuffer->Unbind();
+		}
+		else
+		{
+			for (const DrawBatch& batch : s_RendererData.Batches)
 			{
-				s_RendererData.PBRShader->Bind();
-				s_RendererData.PBRShader->SetMat4("u_Projection", s_RendererData.Camera->GetProjectionMatrix());
-				s_RendererData.PBRShader->SetMat4("u_View", s_RendererData.Camera->GetViewMatrix());
-				s_RendererData.PBRShader->SetMat4("u_Model", mesh.ModelMatrix);
-				s_RendererData.PBRShader->SetFloat3("u_LightPos", s_RendererData.LightInfo.LightPos);
-				s_RendererData.PBRShader->SetFloat3("u_LightColor", s_RendererData.LightInfo.LightColor);
-				s_RendererData.PBRShader->SetFloat3("u_CameraPos", s_RendererData.Camera->GetPosition());
-
-				s_RendererData.PBRShader->SetInt("u_IrradianceMap", 0);
-				s_RendererData.PBRShader->SetInt("u_PrefilterMap", 1);
-				s_RendererData.PBRShader->SetInt("u_BrdfLutTexture", 2);
-
-				s_RendererData.PBRShader->SetFloat3("u_Albedo", mesh.Material->GetAlbedo());
-				s_RendererData.PBRShader->SetFloat("u_Roughness", mesh.Material->GetRoughness());
-				s_RendererData.PBRShader->SetFloat("u_Metallic", mesh.Material->GetMetallic());
-				s_RendererData.PBRShader->SetFloat("u_Ambient", mesh.Material->GetAmbientOcclusion());
-
-				RendererAPI::DrawIndexed(mesh.VertexArray, 0);
+				const MeshInfo& mesh = queue[batch.First];
+				BindDrawState(mesh, state, mode);
+
+				RendererAPI::DrawIndexedInstanced(mesh.Geometry.IndexCount, batch.InstanceCount, mesh.Geometry.FirstIndex, mesh.Geometry.BaseVertex, batch.BaseInstance);
 				s_RendererData.Stats.DrawCalls += 1;
 			}
 		}
+	}
 
-		s_RendererData.Cubemap->BindEnvironmentMap(0);
-		s_RendererData.CubemapShader->Bind();
-		s_RendererData.CubemapShader->SetMat4("u_Projection", s_RendererData.Camera->GetProjectionMatrix());
-		s_RendererData.CubemapShader->SetMat4("u_View", s_RendererData.Camera->GetViewMatrix());
-		s_RendererData.CubemapShader->SetInt("u_EnvironmentMap", 0);
-
-		RendererAPI::DrawIndexed(s_RendererData.Cubemap->GetVertexArray(), 0);
-		s_RendererData.Stats.DrawCalls += 1;
-
-		s_RendererData.Meshes.clear();
-
-		RendererAPI::BlitFramebuffer(s_RendererData.MultisampleFramebuffer, s_RendererData.IntermediateFramebuffer);
+	// Dynamic resolution only renders into a part of the scene targets
+	static void BindSceneFramebuffer(const RenderPassContext& context)
+	{
+		context.BindFramebuffer();
+		StateCache::SetViewport(0, 0, s_RendererData.RenderWidth, s_RendererData.RenderHeight);
 	}
 
-	void Renderer::Submit(Ref<Mesh>& mesh, const glm::mat4& modelMatrix)
+	// Share of the targets the scene passes render to
+	static glm::vec2 GetRenderScale()
 	{
-		s_RendererData.Meshes.push_back({ mesh->GetVertexArray(), mesh->GetMaterial(), modelMatrix });
-		s_RendererData.Stats.VertexCount += mesh->GetVertexCount();
-		s_RendererData.Stats.FaceCount += mesh->GetFaceCount();
+		return { (float)s_RendererData.RenderWidth / (float)s_RendererData.TargetWidth, (float)s_RendererData.RenderHeight / (float)s_RendererData.TargetHeight };
 	}
 
-	void Renderer::Submit(Ref<Model>& model, uint16_t lod, uint16_t meshesPerLod)
+	// Tiles are handed out again whenever the settings change the layout, the cached shadows are lost then
+	static void UpdateShadowTiles()
 	{
-		for (unsigned int i = lod * meshesPerLod; i < (lod + 1) * meshesPerLod && i < model->GetMeshes().size(); i++)
+		RendererData& data = s_RendererData;
+		const ShadowSettings& settings = data.ShadowSettings;
+
+		if (!data.ShadowAtlas.Update(data.Graph, settings.AtlasSize, settings.Caching) && data.ShadowTilesValid)
+			return;
+
+		data.ShadowAtlas.ReleaseTiles();
+		bool complete = true;
+		for (uint32_t i = 0; i < s_ShadowViewCount; i++)
 		{
-			const Mesh& mesh = model->GetMeshes()[i];
-			s_RendererData.Meshes.push_back({ mesh.GetVertexArray(), mesh.GetMaterial(), model->GetModelMatrix() });
-			s_RendererData.Stats.VertexCount += mesh.GetVertexCount();
-			s_RendererData.Stats.FaceCount += mesh.GetFaceCount();
+			ShadowView& view = data.ShadowViews[i];
+			view = ShadowView();
+
+			bool cascade = i < ShadowSettings::MaxCascades;
+			if (cascade && i >= settings.CascadeCount)
+				continue;
+
+			view.Allocated = data.ShadowAtlas.Allocate(cascade ? settings.CascadeSize : settings.PointLightSize, view.Tile);
+			complete &= view.Allocated;
 		}
+
+		if (!complete)
+			OGL_WARN("The shadow atlas of {0}x{0} is too small for all shadow views", settings.AtlasSize);
+
+		data.ShadowTilesValid = true;
 	}
 
-	void Renderer::Submit(Ref<Model>& model)
+	// Appends the casters inside the frustum of a shadow view to the instances of the frame, returns the first batch
+	static uint32_t AddShadowBatches(const std::vector<ShadowCaster>& casters, const Frustum& frustum, uint32_t& batchCount)
 	{
-		for (const Mesh& mesh : model->GetMeshes())
+		std::vector<ShadowBatch>& batches = s_RendererData.ShadowBatches;
+		std::vector<InstanceData>& instances = s_RendererData.Instances;
+		uint32_t first = (uint32_t)batches.size();
+		uint32_t firstInstance = (uint32_t)instances.size();
+
+		// Submissions of the same geometry usually follow each other, so merging neighbours is enough
+		for (const ShadowCaster& caster : casters)
 		{
-			s_RendererData.Meshes.push_back({ mesh.GetVertexArray(), mesh.GetMaterial(), model->GetModelMatrix() });
-			s_RendererData.Stats.VertexCount += mesh.GetVertexCount();
-			s_RendererData.Stats.FaceCount += mesh.GetFaceCount();
+			if (!frustum.Intersects(caster.Sphere))
+				continue;
+
+			if (batches.size() > first && batches.back().VertexArray == caster.VertexArray.get() && batches.back().Geometry.Id == caster.Geometry.Id)
+				batches.back().InstanceCount++;
+			else
+				batches.push_back({ caster.VertexArray.get(), caster.Geometry, 1, (uint32_t)instances.size() });
+
+			instances.push_back({ caster.ModelMatrix, 0 });
 		}
+
+		batchCount = (uint32_t)batches.size() - first;
+		s_RendererData.Stats.ShadowCasters += (uint32_t)instances.size() - firstInstance;
+		return first;
 	}
 
-	void Renderer::ColorGrade(const glm::vec4& color)
+	// The static casters are only culled and drawn when the cached tile is outdated, the live tile only
+	// changes when the cache did or when dynamic casters are (or were in the last update) inside the view
+	static void PrepareShadowView(ShadowView& view, const glm::mat4& viewProjection)
 	{
-		if (s_RendererData.RenderedToFinalBuffer)
-			s_RendererData.IntermediateFramebuffer->Bind();
-		else
-			s_RendererData.FinalFramebuffer->Bind();
-		
+		RendererData& data = s_RendererData;
+		bool caching = data.ShadowAtlas.IsCaching();
+		Frustum frustum(viewProjection);
 
-		RendererAPI::Clear();
+		view.Active = true;
+		view.ViewProjection = viewProjection;
+		view.RenderStatic = !caching || !view.CacheValid || view.CachedViewProjection != viewProjection || view.CachedStaticHash != data.StaticCasterHash;
+		view.StaticBatchCount = 0;
 
-		if (s_RendererData.RenderedToFinalBuffer)
-			s_RendererData.FinalFramebuffer->BindColorTexture(0);
+		if (view.RenderStatic)
+		{
+			view.FirstStaticBatch = AddShadowBatches(data.StaticCasters, frustum, view.StaticBatchCount);
+			view.CacheValid = caching;
+			view.CachedViewProjection = viewProjection;
+			view.CachedStaticHash = data.StaticCasterHash;
+		}
 		else
-			s_RendererData.IntermediateFramebuffer->BindColorTexture(0);
-		
-		s_RendererData.ColorGradingShader->Bind();
-		s_RendererData.ColorGradingShader->SetInt("u_Frame", 0);
-		s_RendererData.ColorGradingShader->SetFloat4("u_GradingColor", color);
+		{
+			data.Stats.CachedShadowViews++;
+		}
 
-		RendererAPI::DrawIndexed(s_RendererData.QuadVertexArray, 0);
+		view.FirstDynamicBatch = AddShadowBatches(data.DynamicCasters, frustum, view.DynamicBatchCount);
 
-		s_RendererData.RenderedToFinalBuffer = !s_RendererData.RenderedToFinalBuffer;
-		s_RendererData.FinalFramebuffer->Unbind();
+		bool hasDynamic = view.DynamicBatchCount > 0;
+		view.UpdateLive = view.RenderStatic || hasDynamic || view.LiveHasDynamic;
+		view.LiveHasDynamic = hasDynamic;
+		data.Stats.ShadowViews++;
 	}
 
-	void Renderer::InvertColor()
+	// Places the shadow views of the frame and uploads the sun and shadow data, the caster instances end up in the instance buffer
+	static void PrepareShadows()
 	{
-		if (s_RendererData.RenderedToFinalBuffer)
-			s_RendererData.IntermediateFramebuffer->Bind();
-		else
-			s_RendererData.FinalFramebuffer->Bind();
+		OGL_PROFILE_FUNCTION();
 
-		RendererAPI::Clear();
+		RendererData& data = s_RendererData;
+		const ShadowSettings& settings = data.ShadowSettings;
+		const LightInfo& lightInfo = data.LightInfo;
+		data.ShadowBatches.clear();
+		data.Stats.ShadowViews = 0;
+		data.Stats.CachedShadowViews = 0;
+		data.Stats.ShadowCasters = 0;
 
-		if (s_RendererData.RenderedToFinalBuffer)
-			s_RendererData.FinalFramebuffer->BindColorTexture(0);
-		else
-			s_RendererData.IntermediateFramebuffer->BindColorTexture(0);
+		for (ShadowView& view : data.ShadowViews)
+			view.Active = false;
 
-		s_RendererData.InvertColorShader->Bind();
-		s_RendererData.InvertColorShader->SetInt("u_Frame", 0);
+		// A sun without direction doesn't shine
+		bool sun = glm::length(lightInfo.SunDirection) > 0.0f;
 
-		RendererAPI::DrawIndexed(s_RendererData.QuadVertexArray, 0);
+		ShadowData shadowData = {};
+		shadowData.SunDirection = sun ? glm::vec4(-glm::normalize(lightInfo.SunDirection), 0.0f) : glm::vec4(0.0f);
+		shadowData.SunColor = sun ? glm::vec4(lightInfo.SunColor, 1.0f) : glm::vec4(0.0f);
+		shadowData.ShadowParams = { 0.0f, 0.0f, settings.NormalBias, 2.0f / (float)settings.PointLightSize };
+
+		bool sunShadows = sun && settings.Enabled && settings.CascadeCount > 0 && glm::length(lightInfo.SunColor) > 0.0f;
+		bool pointShadows = settings.Enabled && glm::length(lightInfo.LightColor) > 0.0f;
+
+		if (sunShadows || pointShadows)
+			UpdateShadowTiles();
+
+		const ShadowAtlas& atlas = data.ShadowAtlas;
+		if (sunShadows)
+		{
+			// Fitted to the camera without jitter, the cascades would move every frame otherwise
+			const Ref<Camera>& camera = data.Camera;
+			ShadowCascade cascades[ShadowSettings::MaxCascades];
+			ComputeShadowCascades(camera->GetViewProjectionMatrix(), camera->GetNearClip(), camera->GetFarClip(), lightInfo.SunDirection, settings, cascades);
+
+			uint32_t cascadeCount = 0;
+			while (cascadeCount < settings.CascadeCount && data.ShadowViews[cascadeCount].Allocated)
+			{
+				ShadowView& view = data.ShadowViews[cascadeCount];
+				const ShadowCascade& cascade = cascades[cascadeCount];
+				PrepareShadowView(view, cascade.ViewProjection);
+
+				shadowData.CascadeMatrices[cascadeCount] = atlas.GetTileMatrix(view.Tile) * cascade.ViewProjection;
+				shadowData.CascadeRects[cascadeCount] = atlas.GetTileRect(view.Tile);
+				shadowData.CascadeSplits[cascadeCount] = cascade.SplitDepth;
+				shadowData.CascadeTexelSizes[cascadeCount] = cascade.TexelSize;
+				cascadeCount++;
+			}
 
-		s_RendererData.RenderedToFinalBuffer = !s_RendererData.RenderedToFinalBuffer;
-		s_RendererData.FinalFramebuffer->Unbind();
+			shadowData.ShadowParams.x = (float)cascadeCount;
+		}
+
+		ShadowView* faces = data.ShadowViews + ShadowSettings::MaxCascades;
+		if (pointShadows && std::all_of(faces, faces + s_PointShadowFaces, [](const ShadowView& view) { return view.Allocated; }))
+		{
+			glm::mat4 viewProjections[s_PointShadowFaces];
+			ComputePointShadowFaces(lightInfo.LightPos, settings.PointLightRange, viewProjections);
+
+			for (uint32_t i = 0; i < s_PointShadowFaces; i++)
+			{
+				PrepareShadowView(faces[i], viewProjections[i]);
+				shadowData.PointShadowMatrices[i] = atlas.GetTileMatrix(faces[i].Tile) * viewProjections[i];
+				shadowData.PointShadowRects[i] = atlas.GetTileRect(faces[i].Tile);
+			}
+
+			shadowData.ShadowParams.y = 1.0f;
+		}
+
+		data.ShadowUniformBuffer->SetData(&shadowData, sizeof(ShadowData));
 	}
 
-	const RendererStats& Renderer::GetStatistics()
+	static void DrawShadowBatches(uint32_t first, uint32_t count)
 	{
-		return s_RendererData.Stats;
-	}
+		const VertexArray* bound = nullptr;
+		for (uint32_t i = first; i < first + count; i++)
+		{
+			const ShadowBatch& batch = s_RendererData.ShadowBatches[i];
+			if (batch.VertexArray != bound)
+			{
+				if (!batch.VertexArray->HasVertexBuffer(s_RendererData.InstanceBuffer))
+					batch.VertexArray->AddVertexBuffer(s_RendererData.InstanceBuffer, s_InstanceAttributeLocation);
 
-	uint32_t Renderer::GetFrameTextureId()
+				batch.VertexArray->Bind();
+				bound = batch.VertexArray;
+			}
+
+			RendererAPI::DrawIndexedInstanced(batch.Geometry.IndexCount, batch.InstanceCount, batch.Geometry.FirstIndex, batch.Geometry.BaseVertex, batch.BaseInstance);
+			s_RendererData.Stats.DrawCalls += 1;
+		}
+	}
+
+	static void BindShadowState(const ShadowView& view)
+	{
+		PipelineState state = s_ShadowState;
+		state.DepthBias = s_RendererData.ShadowSettings.SlopeBias;
+		RendererAPI::SetPipelineState(state);
+
+		StateCache::SetViewport(view.Tile.X, view.Tile.Y, view.Tile.Size, view.Tile.Size);
+		s_RendererData.ShadowShader->Bind();
+		s_RendererData.ShadowShader->SetMat4("u_ShadowViewProjection", view.ViewProjection);
+	}
+
+	static void ExecuteShadowCachePass(const RenderPassContext& context)
+	{
+		context.BindFramebuffer();
+
+		for (const ShadowView& view : s_RendererData.ShadowViews)
+		{
+			if (!view.Active || !view.RenderStatic)
+				continue;
+
+			ShadowAtlas::ClearTile(s_RendererData.ShadowAtlas.GetCacheTexture(), view.Tile);
+			BindShadowState(view);
+			DrawShadowBatches(view.FirstStaticBatch, view.StaticBatchCount);
+		}
+	}
+
+	static void ExecuteShadowPass(const RenderPassContext& context)
+	{
+		context.BindFramebuffer();
+
+		const ShadowAtlas& atlas = s_RendererData.ShadowAtlas;
+		for (const ShadowView& view : s_RendererData.ShadowViews)
+		{
+			if (!view.Active || !view.UpdateLive)
+				continue;
+
+			// Without caching the static casters are drawn every frame
+			if (atlas.IsCaching())
+				ShadowAtlas::CopyTile(atlas.GetCacheTexture(), atlas.GetTexture(), view.Tile);
+			else
+				ShadowAtlas::ClearTile(atlas.GetTexture(), view.Tile);
+
+			BindShadowState(view);
+			if (!atlas.IsCaching())
+				DrawShadowBatches(view.FirstStaticBatch, view.StaticBatchCount);
+
+			DrawShadowBatches(view.FirstDynamicBatch, view.DynamicBatchCount);
+		}
+	}
+
+	// Returns the passes that light the scene have to read, the atlas is only written if a tile changed
+	static std::vector<RenderGraphResource> AddShadowPasses()
+	{
+		RendererData& data = s_RendererData;
+		bool active = false, renderStatic = false, updateLive = false;
+		for (const ShadowView& view : data.ShadowViews)
+		{
+			active |= view.Active;
+			renderStatic |= view.Active && view.RenderStatic;
+			updateLive |= view.Active && view.UpdateLive;
+		}
+
+		if (!active)
+			return {};
+
+		RenderGraph& graph = data.Graph;
+		const ShadowAtlas& atlas = data.ShadowAtlas;
+		RenderGraphResource atlasResource = graph.ImportTexture("Shadow Atlas", atlas.GetTexture(), atlas.GetDesc());
+		if (!updateLive)
+			return { atlasResource };
+
+		std::vector<RenderGraphResource> reads;
+		if (atlas.IsCaching())
+		{
+			RenderGraphResource cache = graph.ImportTexture("Shadow Cache", atlas.GetCacheTexture(), atlas.GetDesc());
+			if (renderStatic)
+				graph.AddPass("Shadow Cache", {}, { cache }, ExecuteShadowCachePass);
+
+			reads.push_back(cache);
+		}
+
+		graph.AddPass("Shadow Maps", reads, { atlasResource }, ExecuteShadowPass);
+		return { atlasResource };
+	}
+
+	static void BindShadowAtlas()
+	{
+		if (s_RendererData.Stats.ShadowViews)
+			StateCache::BindTexture(ShadowAtlasSlot, s_RendererData.ShadowAtlas.GetTexture());
+	}
+
+	// Draws the queue after a depth pre-pass if it is enabled, the pass state is expected to be set and the targets cleared
+	static void DrawScene(DrawMode mode, const PipelineState& depthEqualState)
+	{
+		bool depthPrePass = s_RendererData.Stats.DepthPrePass;
+		bool countFragments = s_RendererData.PrePassFragmentQuery != nullptr;
+
+		// Both queries advance every frame, so results with the same serial belong to the same frame (an empty pre-pass query counts 0)
+		if (countFragments)
+			s_RendererData.PrePassFragmentQuery->Begin();
+
+		if (depthPrePass)
+		{
+			GPUProfilerScope pass("Depth Pre-Pass");
+
+			RendererAPI::SetPipelineState(s_DepthPrePassState);
+			s_RendererData.DepthShader->Bind();
+
+			DrawBatches(DrawMode::DepthOnly);
+
+			RendererAPI::SetPipelineState(depthEqualState);
+		}
+
+		if (countFragments)
+			s_RendererData.PrePassFragmentQuery->End();
+
+		GPUProfilerScope pass(mode == DrawMode::GBuffer ? "Surfaces" : "Shading");
+
+		if (countFragments)
+			s_RendererData.ShadingFragmentQuery->Begin();
+
+		DrawBatches(mode);
+
+		if (countFragments)
+		{
+			s_RendererData.ShadingFragmentQuery->End();
+
+			const StatisticsQuery& prePassQuery = *s_RendererData.PrePassFragmentQuery;
+			const StatisticsQuery& shadingQuery = *s_RendererData.ShadingFragmentQuery;
+			if (prePassQuery.GetResultSerial() == shadingQuery.GetResultSerial())
+			{
+				s_RendererData.Stats.PrePassFragments = prePassQuery.GetResult();
+				s_RendererData.Stats.ShadedFragments = shadingQuery.GetResult();
+			}
+		}
+	}
+
+	static void BindEnvironmentLighting()
+	{
+		s_RendererData.Cubemap->BindPrefilterMap(PrefilterMapSlot);
+		s_RendererData.BrdfLut->Bind(BrdfLutSlot);
+	}
+
+	static void ExecuteScenePass(const RenderPassContext& context)
+	{
+		BindSceneFramebuffer(context);
+		RendererAPI::SetPipelineState(s_OpaqueState); // Depth writes have to be enabled for the clear
+		RendererAPI::Clear();
+
+		BindEnvironmentLighting();
+		BindShadowAtlas();
+		DrawScene(DrawMode::Shaded, s_DepthEqualState);
+	}
+
+	static void ExecuteGBufferPass(const RenderPassContext& context)
+	{
+		BindSceneFramebuffer(context);
+		RendererAPI::SetPipelineState(s_GBufferState);
+		RendererAPI::Clear();
+
+		DrawScene(DrawMode::GBuffer, s_GBufferDepthEqualState);
+	}
+
+	static void ExecuteSkyboxPass(const RenderPassContext& context)
+	{
+		BindSceneFramebuffer(context);
+		RendererAPI::SetPipelineState(s_SkyboxState);
+		s_RendererData.Cubemap->BindEnvironmentMap(EnvironmentMapSlot);
+		s_RendererData.CubemapShader->Bind();
+
+		RendererAPI::DrawIndexed(s_RendererData.Cubemap->GetVertexArray(), 0);
+		s_RendererData.Stats.DrawCalls += 1;
+	}
+
+	static void DrawFullscreenQuad()
+	{
+		RendererAPI::DrawIndexed(s_RendererData.QuadVertexArray, 0);
+		s_RendererData.Stats.DrawCalls += 1;
+	}
+
+	// G-buffer: albedo (square root encoded) and ambient occlusion in RGBA8, octahedral normal and roughness in RGB10A2, metallic in R8
+	// The lighting pass adds the image based and the main light of every pixel, then one screen rectangle per point or spot light
+	static void AddDeferredPasses(RenderGraphResource sceneColor, RenderGraphResource sceneDepth, const std::vector<RenderGraphResource>& shadowReads)
+	{
+		RenderGraph& graph = s_RendererData.Graph;
+		RenderTargetDesc desc = graph.GetDesc(sceneColor);
+
+		RenderGraphResource albedo = graph.CreateTexture("G-Buffer Albedo", { desc.Width, desc.Height, RenderTargetFormat::RGBA8 });
+		RenderGraphResource normal = graph.CreateTexture("G-Buffer Normal", { desc.Width, desc.Height, RenderTargetFormat::RGB10A2 });
+		RenderGraphResource metallic = graph.CreateTexture("G-Buffer Metallic", { desc.Width, desc.Height, RenderTargetFormat::R8 });
+
+		graph.AddPass("G-Buffer", {}, { albedo, normal, metallic, sceneDepth }, ExecuteGBufferPass);
+		std::vector<RenderGraphResource> lightingReads = { albedo, normal, metallic, sceneDepth };
+		lightingReads.insert(lightingReads.end(), shadowReads.begin(), shadowReads.end());
+
+		graph.AddPass("Deferred Lighting", lightingReads, { sceneColor }, [albedo, normal, metallic, sceneDepth](const RenderPassContext& context)
+		{
+			// The fullscreen pass writes every rendered pixel, so the colour target doesn't need a clear
+			BindSceneFramebuffer(context);
+			RendererAPI::SetPipelineState(s_FullscreenState);
+			BindEnvironmentLighting();
+			BindShadowAtlas();
+			context.BindTexture(albedo, GBufferAlbedoSlot);
+			context.BindTexture(normal, GBufferNormalSlot);
+			context.BindTexture(metallic, GBufferMetallicSlot);
+			context.BindTexture(sceneDepth, GBufferDepthSlot);
+
+			s_RendererData.DeferredLightingShader->Bind();
+			DrawFullscreenQuad();
+
+			uint32_t lightCount = (uint32_t)s_RendererData.Lights.size();
+			if (lightCount == 0)
+				return;
+
+			GPUProfilerScope pass("Light Volumes");
+
+			RendererAPI::SetPipelineState(s_LightVolumeState);
+			s_RendererData.LightVolumeShader->Bind();
+			s_RendererData.QuadVertexArray->Bind();
+
+			RendererAPI::DrawIndexedInstanced(6, lightCount, 0, 0, 0);
+			s_RendererData.Stats.DrawCalls += 1;
+		});
+	}
+
+	// Exposure, tonemapping and gamma correction of the resolved HDR colour, the following passes work on display colours
+	static RenderGraphResource AddTonemapPass(RenderGraphResource color)
+	{
+		RenderGraph& graph = s_RendererData.Graph;
+		const RenderTargetDesc& desc = graph.GetDesc(color);
+
+		RenderGraphResource output = graph.CreateTexture("Tonemapped Color", { desc.Width, desc.Height });
+		graph.AddPass("Tonemap", { color }, { output }, [color](const RenderPassContext& context)
+		{
+			BindSceneFramebuffer(context);
+			RendererAPI::SetPipelineState(s_FullscreenState);
+			context.BindTexture(color, 0);
+
+			s_RendererData.TonemapShader->Bind();
+			s_RendererData.TonemapShader->SetFloat("u_Exposure", s_RendererData.Exposure);
+			s_RendererData.TonemapShader->SetFloat("u_Gamma", s_RendererData.Gamma);
+			DrawFullscreenQuad();
+		});
+
+		return output;
+	}
+
+	// Moves the rendered part of the tonemapped colour into an output sized texture, scaled up and sharpened with dynamic resolution
+	static RenderGraphResource AddUpscalePass(RenderGraphResource color)
+	{
+		RenderGraph& graph = s_RendererData.Graph;
+		uint32_t width = s_RendererData.Width, height = s_RendererData.Height;
+		bool scaled = s_RendererData.RenderWidth != width || s_RendererData.RenderHeight != height;
+		if (!scaled && s_RendererData.TargetWidth == width && s_RendererData.TargetHeight == height)
+			return color;
+
+		RenderGraphResource output = graph.CreateTexture("Output Color", { width, height });
+		if (!scaled)
+		{
+			graph.AddPass("Copy Output", { color }, { output }, [color, width, height](const RenderPassContext& context)
+			{
+				RendererAPI::BlitFramebuffer(context.GetFramebuffer({ color }), context.GetFramebuffer(), width, height);
+			});
+
+			return output;
+		}
+
+		graph.AddPass("Upscale", { color }, { output }, [color](const RenderPassContext& context)
+		{
+			context.BindFramebuffer();
+			RendererAPI::SetPipelineState(s_FullscreenState);
+			context.BindTexture(color, 0);
+
+			s_RendererData.UpscaleShader->Bind();
+			s_RendererData.UpscaleShader->SetFloat2("u_RenderScale", GetRenderScale());
+			s_RendererData.UpscaleShader->SetFloat("u_Sharpness", s_RendererData.DynamicResolution.GetSettings().Sharpness);
+			DrawFullscreenQuad();
+		});
+
+		return output;
+	}
+
+	// Filters the tonemapped scene colour with the post process anti-aliasing of the current mode, returns the filtered colour
+	static RenderGraphResource AddAntiAliasingPasses(RenderGraphResource color, RenderGraphResource depth)
+	{
+		RenderGraph& graph = s_RendererData.Graph;
+		RenderTargetDesc desc = graph.GetDesc(color);
+
+		switch (s_RendererData.AntiAliasingMode)
+		{
+		case AntiAliasingMode::FXAA:
+		{
+			RenderGraphResource output = graph.CreateTexture("FXAA Color", desc);
+			graph.AddPass("FXAA", { color }, { output }, [color](const RenderPassContext& context)
+			{
+				context.BindFramebuffer();
+				RendererAPI::SetPipelineState(s_FullscreenState);
+				context.BindTexture(color, 0);
+				s_RendererData.FXAAShader->Bind();
+				DrawFullscreenQuad();
+			});
+
+			return output;
+		}
+		case AntiAliasingMode::SMAA:
+		{
+			// The edges are dead once the weights exist, so the output can take their place in the pool
+			RenderGraphResource edges = graph.CreateTexture("SMAA Edges", desc);
+			RenderGraphResource weights = graph.CreateTexture("SMAA Weights", desc);
+			RenderGraphResource output = graph.CreateTexture("SMAA Color", desc);
+
+			graph.AddPass("SMAA Edge Detection", { color }, { edges }, [color](const RenderPassContext& context)
+			{
+				context.BindFramebuffer();
+				RendererAPI::SetPipelineState(s_FullscreenState);
+				context.BindTexture(color, 0);
+				s_RendererData.SMAAEdgeShader->Bind();
+				DrawFullscreenQuad();
+			});
+
+			graph.AddPass("SMAA Blending Weights", { edges }, { weights }, [edges](const RenderPassContext& context)
+			{
+				context.BindFramebuffer();
+				RendererAPI::SetPipelineState(s_FullscreenState);
+				context.BindTexture(edges, 0);
+				s_RendererData.SMAAWeightShader->Bind();
+				DrawFullscreenQuad();
+			});
+
+			graph.AddPass("SMAA Neighbourhood Blending", { color, weights }, { output }, [color, weights](const RenderPassContext& context)
+			{
+				context.BindFramebuffer();
+				RendererAPI::SetPipelineState(s_FullscreenState);
+				context.BindTexture(color, 0);
+				context.BindTexture(weights, 1);
+				s_RendererData.SMAABlendShader->Bind();
+				DrawFullscreenQuad();
+			});
+
+			return output;
+		}
+		case AntiAliasingMode::TAA:
+		{
+			// The target of this frame is the history of the next one
+			TemporalAntiAliasing& taa = s_RendererData.TemporalAntiAliasing;
+			RenderGraphResource history = graph.ImportTexture("TAA History", taa.GetHistoryTexture(), taa.GetDesc());
+			RenderGraphResource output = graph.ImportTexture("TAA Color", taa.GetTargetTexture(), taa.GetDesc());
+
+			graph.AddPass("TAA Resolve", { color, depth, history }, { output }, [color, depth, history](const RenderPassContext& context)
+			{
+				TemporalAntiAliasing& taa = s_RendererData.TemporalAntiAliasing;
+
+				context.BindFramebuffer();
+				RendererAPI::SetPipelineState(s_FullscreenState);
+				context.BindTexture(color, 0);
+				context.BindTexture(depth, 1);
+				context.BindTexture(history, 2);
+
+				s_RendererData.TAAShader->Bind();
+				s_RendererData.TAAShader->SetMat4("u_Reprojection", taa.GetReprojection());
+				s_RendererData.TAAShader->SetFloat("u_HistoryWeight", taa.GetHistoryWeight());
+				s_RendererData.TAAShader->SetFloat2("u_RenderScale", { (float)s_RendererData.RenderWidth / (float)s_RendererData.Width, (float)s_RendererData.RenderHeight / (float)s_RendererData.Height });
+				DrawFullscreenQuad();
+			});
+
+			return output;
+		}
+		default:
+			return color;
+		}
+	}
+
+	// Both shading paths read the visible lights from the storage buffer
+	static void CullLights()
+	{
+		OGL_PROFILE_FUNCTION();
+
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+		const glm::mat4& view = s_RendererData.Camera->GetViewMatrix();
+		std::vector<LightData>& lights = s_RendererData.Lights;
+		std::vector<glm::vec4>& spheres = s_RendererData.LightSpheres;
+		lights.clear();
+		spheres.clear();
+
+		for (const LightData& light : s_RendererData.SubmittedLights)
+		{
+			glm::vec3 position = light.PositionRadius;
+			float radius = light.PositionRadius.w;
+			if (s_RendererData.FrustumCulling && !s_RendererData.Frustum.Intersects(BoundingSphere{ position, radius }))
+				continue;
+
+			lights.push_back(light);
+			spheres.push_back(glm::vec4(glm::vec3(view * glm::vec4(position, 1.0f)), radius));
+		}
+
+		uint32_t lightDataSize = (uint32_t)(lights.size() * sizeof(LightData));
+		ReserveBufferSize(s_RendererData.LightBuffer, lightDataSize);
+		if (lightDataSize)
+			s_RendererData.LightBuffer->SetData(lights.data(), lightDataSize);
+
+		glm::uvec4 lightCounts = { (uint32_t)lights.size(), 0, 0, 0 };
+		s_RendererData.FrameUniformBuffer->SetData(&lightCounts, sizeof(glm::uvec4), offsetof(FrameData, LightCounts));
+
+		s_RendererData.Stats.SubmittedLights = (uint32_t)s_RendererData.SubmittedLights.size();
+		s_RendererData.Stats.Lights = (uint32_t)lights.size();
+		s_RendererData.Stats.LightCullingTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	static void AssignLightClusters()
+	{
+		OGL_PROFILE_FUNCTION();
+
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+		const Ref<Camera>& camera = s_RendererData.Camera;
+		LightClusterGrid& clusters = *s_RendererData.LightClusters;
+		clusters.Assign(s_RendererData.LightSpheres, s_RendererData.Projection, camera->GetNearClip(), camera->GetFarClip());
+
+		s_RendererData.ClusterRangeBuffer->SetData(clusters.GetRanges().data(), LightClusterGrid::ClusterCount * (uint32_t)sizeof(ClusterRange));
+
+		const std::vector<uint32_t>& indices = clusters.GetIndices();
+		uint32_t indexDataSize = (uint32_t)(indices.size() * sizeof(uint32_t));
+		ReserveBufferSize(s_RendererData.LightIndexBuffer, indexDataSize);
+		if (indexDataSize)
+			s_RendererData.LightIndexBuffer->SetData(indices.data(), indexDataSize);
+
+		s_RendererData.Stats.LightIndices = (uint32_t)indices.size();
+		s_RendererData.Stats.LightAssignmentTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	void Renderer::EndScene()
+	{
+		OGL_PROFILE_FUNCTION();
+
+		RenderQueue& queue = s_RendererData.Queue;
+		{
+			OGL_PROFILE_SCOPE("Sort Render Queue");
+			queue.Sort();
+		}
+
+		// Draws are sorted by shader, material and geometry, so identical submissions are adjacent and can be merged into one instanced draw
+		{
+			OGL_PROFILE_SCOPE("Build Batches");
+
+			std::vector<InstanceData>& instances = s_RendererData.Instances;
+			std::vector<DrawBatch>& batches = s_RendererData.Batches;
+			instances.clear();
+			batches.clear();
+			s_RendererData.Materials.clear();
+			s_RendererData.MaterialIndices.clear();
+
+			for (uint32_t i = 0; i < queue.GetSize(); i++)
+			{
+				const MeshInfo& mesh = queue[i];
+
+				bool sameBatch = false;
+				if (!batches.empty())
+				{
+					const MeshInfo& batchMesh = queue[batches.back().First];
+					sameBatch = mesh.VertexArray == batchMesh.VertexArray && mesh.Geometry.Id == batchMesh.Geometry.Id && mesh.Material == batchMesh.Material && mesh.Shader == batchMesh.Shader;
+				}
+
+				if (sameBatch)
+					batches.back().InstanceCount++;
+				else
+					batches.push_back({ i, 1, (uint32_t)instances.size(), 0 });
+
+				instances.push_back({ mesh.ModelMatrix, GetMaterialIndex(mesh.Material) });
+			}
+		}
+
+		// The shadow casters are appended to the instances of the queue
+		PrepareShadows();
+
+		{
+			OGL_PROFILE_SCOPE("Upload Instances");
+
+			// Upload all instance and material data of the frame at once
+			const std::vector<InstanceData>& instances = s_RendererData.Instances;
+			uint32_t instanceDataSize = (uint32_t)(instances.size() * sizeof(InstanceData));
+			ReserveBufferSize(s_RendererData.InstanceBuffer, instanceDataSize);
+			if (instanceDataSize)
+				s_RendererData.InstanceBuffer->SetData(instances.data(), instanceDataSize);
+
+			uint32_t materialDataSize = (uint32_t)(s_RendererData.Materials.size() * sizeof(MaterialData));
+			ReserveBufferSize(s_RendererData.MaterialBuffer, materialDataSize);
+			if (materialDataSize)
+				s_RendererData.MaterialBuffer->SetData(s_RendererData.Materials.data(), materialDataSize);
+		}
+
+		if (s_RendererData.IndirectDrawing)
+			BuildIndirectCommands();
+
+		bool deferred = s_RendererData.ShadingPath == ShadingPath::Deferred;
+		CullLights();
+		if (!deferred)
+			AssignLightClusters();
+
+		// Overdraw makes the expensive PBR shading run several times per pixel, a depth only pass lets early-Z reject hidden fragments
+		s_RendererData.Stats.DepthPrePass = s_RendererData.DepthPrePassMode == DepthPrePassMode::On
+			|| (s_RendererData.DepthPrePassMode == DepthPrePassMode::Auto && s_RendererData.Stats.EstimatedDepthComplexity > s_AutoDepthPrePassComplexity);
+
+		// The multisampled targets only live until the resolve, the depth buffer isn't needed after the skybox (or TAA)
+		RenderGraph& graph = s_RendererData.Graph;
+		uint32_t width = s_RendererData.TargetWidth, height = s_RendererData.TargetHeight;
+		// The deferred path doesn't support MSAA, a multisampled G-buffer would have to be lit per sample
+		uint8_t samples = deferred ? 1 : GetAntiAliasingSamples(s_RendererData.AntiAliasingMode);
+
+		RenderTargetFormat colorFormat = s_RendererData.SceneColorFormat;
+
+		RenderGraphResource sceneColor = graph.CreateTexture("Scene Color", { width, height, colorFormat, samples });
+		RenderGraphResource sceneDepth = graph.CreateTexture("Scene Depth", { width, height, RenderTargetFormat::Depth24Stencil8, samples });
+
+		std::vector<RenderGraphResource> shadowReads = AddShadowPasses();
+		if (deferred)
+			AddDeferredPasses(sceneColor, sceneDepth, shadowReads);
+		else
+			graph.AddPass("Scene", shadowReads, { sceneColor, sceneDepth }, ExecuteScenePass);
+
+		graph.AddPass("Skybox", {}, { sceneColor, sceneDepth }, ExecuteSkyboxPass);
+
+		RenderGraphResource color = sceneColor;
+		if (samples > 1)
+		{
+			color = graph.CreateTexture("Resolved Scene Color", { width, height, colorFormat });
+			graph.AddPass("MSAA Resolve", { sceneColor }, { color }, [sceneColor](const RenderPassContext& context)
+			{
+				RendererAPI::BlitFramebuffer(context.GetFramebuffer({ sceneColor }), context.GetFramebuffer(), s_RendererData.RenderWidth, s_RendererData.RenderHeight);
+			});
+		}
+
+		s_RendererData.FrameColor = AddAntiAliasingPasses(AddUpscalePass(AddTonemapPass(color)), sceneDepth);
+	}
+
+	void Renderer::EndFrame()
+	{
+		OGL_PROFILE_FUNCTION();
+
+		RenderGraph& graph = s_RendererData.Graph;
+		graph.SetOutput(s_RendererData.FrameColor);
+		graph.Compile();
+		graph.Execute();
+
+		StateCache::BindFramebuffer(0);
+		s_RendererData.Queue.Clear();
+	}
+
+	// The sphere test is cheap and rejects most invisible meshes, the box test catches long thin meshes
+	static bool IsVisible(const Mesh& mesh, const glm::mat4& modelMatrix)
+	{
+		if (!s_RendererData.FrustumCulling)
+			return true;
+
+		s_RendererData.Stats.BoundsTests++;
+		if (!s_RendererData.Frustum.Intersects(mesh.GetBoundingSphere().Transform(modelMatrix)))
+			return false;
+
+		s_RendererData.Stats.BoundsTests++;
+		return s_RendererData.Frustum.Intersects(mesh.GetBoundingBox().Transform(modelMatrix));
+	}
+
+	static void PushMesh(const Mesh& mesh, const glm::mat4& modelMatrix)
+	{
+		s_RendererData.Stats.DrawnMeshes++;
+
+		const Ref<Material>& material = mesh.GetMaterial();
+		bool textured = material->IsUsingTextures();
+		const Ref<Shader>& shader = textured ? s_RendererData.PBRShaderTextured : s_RendererData.PBRShader;
+
+		// Camera distance of the mesh bounds, normalized to the far clip plane
+		const Ref<Camera>& camera = s_RendererData.Camera;
+		BoundingSphere sphere = mesh.GetBoundingSphere().Transform(modelMatrix);
+		float distance = glm::length(sphere.Center - camera->GetPosition());
+		float depth = distance / camera->GetFarClip();
+
+		// Screen coverage of the bounding sphere, summed up as a rough estimate of the depth complexity
+		const glm::mat4& projection = camera->GetProjectionMatrix();
+		float projectedRadius = sphere.Radius / std::max(distance, camera->GetNearClip());
+		float coverage = 0.25f * glm::pi<float>() * projectedRadius * projectedRadius * projection[0][0] * projection[1][1];
+		s_RendererData.Stats.EstimatedDepthComplexity += std::min(coverage, 1.0f);
+
+		uint64_t key = RenderQueue::GenerateSortKey(RenderPass::Opaque, textured ? PBRShaderTextured : PBRShaderStatic, material->GetId(), mesh.GetGeometryFormat(), mesh.GetGeometry().Id, depth);
+		s_RendererData.Queue.Push({ mesh.GetVertexArray(), mesh.GetPositionVertexArray(), mesh.GetGeometry(), material, shader, modelMatrix }, key);
+
+		s_RendererData.Stats.VertexCount += mesh.GetVertexCount();
+		s_RendererData.Stats.FaceCount += mesh.GetFaceCount();
+	}
+
+	// FNV-1a of the geometry and the transform, summed over the static casters so the submission order doesn't matter
+	static uint64_t HashShadowCaster(const ShadowCaster& caster)
+	{
+		const VertexArray* vertexArray = caster.VertexArray.get();
+		uint64_t hash = 14695981039346656037ull;
+		auto add = [&hash](const void* data, size_t size)
+		{
+			for (size_t i = 0; i < size; i++)
+				hash = (hash ^ ((const uint8_t*)data)[i]) * 1099511628211ull;
+		};
+
+		add(&vertexArray, sizeof(vertexArray));
+		add(&caster.Geometry.Id, sizeof(caster.Geometry.Id));
+		add(&caster.ModelMatrix, sizeof(glm::mat4));
+
+		return hash;
+	}
+
+	// Casters are collected independent of the camera, meshes outside of the view still throw shadows into it
+	static void PushShadowCaster(const Mesh& mesh, const glm::mat4& modelMatrix, Mobility mobility)
+	{
+		if (!s_RendererData.ShadowSettings.Enabled)
+			return;
+
+		ShadowCaster caster = { mesh.GetPositionVertexArray(), mesh.GetGeometry(), modelMatrix, mesh.GetBoundingSphere().Transform(modelMatrix) };
+		if (mobility == Mobility::Static)
+		{
+			s_RendererData.StaticCasterHash += HashShadowCaster(caster);
+			s_RendererData.StaticCasters.push_back(caster);
+		}
+		else
+		{
+			s_RendererData.DynamicCasters.push_back(caster);
+		}
+	}
+
+	// Projected size of the bounding sphere relative to the viewport height
+	static float GetScreenSize(const BoundingSphere& sphere)
+	{
+		const Ref<Camera>& camera = s_RendererData.Camera;
+		float distance = glm::length(sphere.Center - camera->GetPosition());
+
+		return sphere.Radius * camera->GetProjectionMatrix()[1][1] / std::max(distance, camera->GetNearClip());
+	}
+
+	// Level i is used while the screen size is above s_LodScreenSize * 0.5^i, the hysteresis band around every
+	// threshold keeps groups close to a threshold from switching back and forth every frame
+	static uint32_t SelectLodLevel(const LodGroup& group, float screenSize)
+	{
+		uint32_t level = 0;
+		float threshold = s_LodScreenSize;
+
+		for (uint32_t i = 0; i + 1 < (uint32_t)group.Levels.size(); i++, threshold *= 0.5f)
+		{
+			float hysteresis = group.CurrentLevel > i ? 1.0f + s_LodHysteresis : 1.0f - s_LodHysteresis;
+			if (screenSize >= threshold * hysteresis)
+				break;
+
+			level = i + 1;
+		}
+
+		return level;
+	}
+
+	static void PushLodGroup(Model& model, uint32_t groupIndex)
+	{
+		const LodGroup& group = model.GetLodGroups()[groupIndex];
+
+		if (s_RendererData.AutomaticLod && group.Levels.size() > 1)
+		{
+			float screenSize = GetScreenSize(group.Sphere.Transform(model.GetModelMatrix())) * s_RendererData.LodBias;
+			uint32_t level = SelectLodLevel(group, screenSize);
+
+			if (level != group.CurrentLevel)
+				s_RendererData.Stats.LodSwitches++;
+
+			model.SelectLodLevel(groupIndex, level);
+		}
+
+		const LodLevel& level = group.Levels[group.CurrentLevel];
+		const std::vector<Mesh>& meshes = model.GetMeshes();
+		for (uint32_t i = level.FirstMesh; i < level.FirstMesh + level.MeshCount; i++)
+			PushMesh(meshes[i], model.GetModelMatrix());
+	}
+
+	// Culls the LOD groups of the model and pushes the meshes of the selected level of every visible group
+	static void PushModel(Model& model, Mobility mobility)
+	{
+		const std::vector<LodGroup>& groups = model.GetLodGroups();
+		uint32_t drawnMeshes = s_RendererData.Stats.DrawnMeshes;
+
+		if (!s_RendererData.FrustumCulling || model.GetBoundingVolumeHierarchy().IsEmpty())
+		{
+			for (uint32_t i = 0; i < (uint32_t)groups.size(); i++)
+				PushLodGroup(model, i);
+		}
+		else
+		{
+			// The hierarchy is kept in world space by the model, its leaves are the LOD group bounds
+			std::vector<uint32_t>& visibleGroups = s_RendererData.VisibleMeshes;
+			visibleGroups.clear();
+			s_RendererData.Stats.BoundsTests += model.GetBoundingVolumeHierarchy().Query(s_RendererData.Frustum, visibleGroups);
+
+			for (uint32_t index : visibleGroups)
+				PushLodGroup(model, index);
+		}
+
+		// Every group casts shadows with its selected level, culled groups with the level of the last frame they were visible
+		const std::vector<Mesh>& meshes = model.GetMeshes();
+		for (const LodGroup& group : groups)
+		{
+			const LodLevel& level = group.Levels[group.CurrentLevel];
+			for (uint32_t i = level.FirstMesh; i < level.FirstMesh + level.MeshCount; i++)
+				PushShadowCaster(meshes[i], model.GetModelMatrix(), mobility);
+		}
+
+		// Counted after the selection, culled groups keep the level of the last frame they were visible
+		uint32_t submittedMeshes = model.GetSelectedMeshCount();
+		s_RendererData.Stats.SubmittedMeshes += submittedMeshes;
+		s_RendererData.Stats.CulledMeshes += submittedMeshes - (s_RendererData.Stats.DrawnMeshes - drawnMeshes);
+	}
+
+	void Renderer::Submit(Ref<Mesh>& mesh, const glm::mat4& modelMatrix, Mobility mobility)
+	{
+		s_RendererData.Stats.SubmittedMeshes++;
+		PushShadowCaster(*mesh, modelMatrix, mobility);
+
+		if (IsVisible(*mesh, modelMatrix))
+			PushMesh(*mesh, modelMatrix);
+		else
+			s_RendererData.Stats.CulledMeshes++;
+	}
+
+	void Renderer::Submit(Ref<Model>& model, uint16_t lod, uint16_t meshesPerLod, Mobility mobility)
+	{
+		// Fixed level, the meshes are culled one by one since the hierarchy is built over the LOD groups
+		const std::vector<Mesh>& meshes = model->GetMeshes();
+		uint32_t first = std::min((uint32_t)lod * meshesPerLod, (uint32_t)meshes.size());
+		uint32_t last = std::min((uint32_t)(lod + 1) * meshesPerLod, (uint32_t)meshes.size());
+
+		for (uint32_t i = first; i < last; i++)
+		{
+			s_RendererData.Stats.SubmittedMeshes++;
+			PushShadowCaster(meshes[i], model->GetModelMatrix(), mobility);
+
+			if (IsVisible(meshes[i], model->GetModelMatrix()))
+				PushMesh(meshes[i], model->GetModelMatrix());
+			else
+				s_RendererData.Stats.CulledMeshes++;
+		}
+	}
+
+	void Renderer::Submit(Ref<Model>& model, Mobility mobility)
+	{
+		PushModel(*model, mobility);
+	}
+
+	void Renderer::SubmitLight(const PointLight& light)
+	{
+		s_RendererData.SubmittedLights.push_back({ glm::vec4(light.Position, light.Radius), glm::vec4(light.Color, 1.0f), glm::vec4(0.0f) });
+	}
+
+	void Renderer::SubmitLight(const SpotLight& light)
+	{
+		// Full intensity inside the inner cone, fading out towards the outer cone
+		float cosInner = std::cos(light.InnerAngle), cosOuter = std::cos(light.OuterAngle);
+		float scale = 1.0f / std::max(cosInner - cosOuter, 0.001f);
+
+		s_RendererData.SubmittedLights.push_back({ glm::vec4(light.Position, light.Radius), glm::vec4(light.Color, -cosOuter * scale), glm::vec4(glm::normalize(light.Direction), scale) });
+	}
+
+	void Renderer::SetDepthPrePassMode(DepthPrePassMode mode)
+	{
+		s_RendererData.DepthPrePassMode = mode;
+	}
+
+	DepthPrePassMode Renderer::GetDepthPrePassMode()
+	{
+		return s_RendererData.DepthPrePassMode;
+	}
+
+	void Renderer::SetFrustumCulling(bool enabled)
+	{
+		s_RendererData.FrustumCulling = enabled;
+	}
+
+	bool Renderer::IsFrustumCulling()
+	{
+		return s_RendererData.FrustumCulling;
+	}
+
+	void Renderer::SetIndirectDrawing(bool enabled)
+	{
+		s_RendererData.IndirectDrawing = enabled;
+	}
+
+	bool Renderer::IsIndirectDrawing()
+	{
+		return s_RendererData.IndirectDrawing;
+	}
+
+	void Renderer::SetAutomaticLod(bool enabled)
+	{
+		s_RendererData.AutomaticLod = enabled;
+	}
+
+	bool Renderer::IsAutomaticLod()
+	{
+		return s_RendererData.AutomaticLod;
+	}
+
+	void Renderer::SetLodBias(float bias)
+	{
+		s_RendererData.LodBias = std::max(bias, 0.01f);
+	}
+
+	float Renderer::GetLodBias()
+	{
+		return s_RendererData.LodBias;
+	}
+
+	void Renderer::SetShadingPath(ShadingPath path)
+	{
+		s_RendererData.ShadingPath = path;
+	}
+
+	ShadingPath Renderer::GetShadingPath()
+	{
+		return s_RendererData.ShadingPath;
+	}
+
+	void Renderer::SetAntiAliasingMode(AntiAliasingMode mode)
+	{
+		s_RendererData.AntiAliasingMode = mode;
+	}
+
+	AntiAliasingMode Renderer::GetAntiAliasingMode()
+	{
+		return s_RendererData.AntiAliasingMode;
+	}
+
+	void Renderer::SetSceneColorFormat(RenderTargetFormat format)
+	{
+		OGL_ASSERT(!IsDepthFormat(format), "The scene colour needs a colour format");
+		s_RendererData.SceneColorFormat = format;
+	}
+
+	RenderTargetFormat Renderer::GetSceneColorFormat()
+	{
+		return s_RendererData.SceneColorFormat;
+	}
+
+	void Renderer::SetExposure(float exposure)
+	{
+		s_RendererData.Exposure = exposure;
+	}
+
+	float Renderer::GetExposure()
+	{
+		return s_RendererData.Exposure;
+	}
+
+	void Renderer::SetGamma(float gamma)
+	{
+		s_RendererData.Gamma = gamma;
+	}
+
+	float Renderer::GetGamma()
+	{
+		return s_RendererData.Gamma;
+	}
+
+	void Renderer::SetShadowSettings(const ShadowSettings& settings)
+	{
+		OGL_ASSERT(settings.CascadeCount <= ShadowSettings::MaxCascades, "Too many shadow cascades");
+
+		const ShadowSettings& current = s_RendererData.ShadowSettings;
+		if (settings.AtlasSize != current.AtlasSize || settings.Caching != current.Caching || settings.CascadeCount != current.CascadeCount
+			|| settings.CascadeSize != current.CascadeSize || settings.PointLightSize != current.PointLightSize)
+			s_RendererData.ShadowTilesValid = false;
+
+		s_RendererData.ShadowSettings = settings;
+	}
+
+	const ShadowSettings& Renderer::GetShadowSettings()
+	{
+		return s_RendererData.ShadowSettings;
+	}
+
+	void Renderer::SetDynamicResolution(const DynamicResolutionSettings& settings)
+	{
+		s_RendererData.DynamicResolution.SetSettings(settings);
+	}
+
+	const DynamicResolutionSettings& Renderer::GetDynamicResolution()
+	{
+		return s_RendererData.DynamicResolution.GetSettings();
+	}
+
+	void Renderer::PostProcess(const PostProcessStack& stack)
+	{
+		OGL_PROFILE_FUNCTION();
+
+		if (stack.Effects.empty())
+			return;
+
+		RenderGraph& graph = s_RendererData.Graph;
+		RenderGraphResource source = s_RendererData.FrameColor;
+		RenderGraphResource target = graph.CreateTexture("Post Processed Color", graph.GetDesc(source));
+
+		// The whole stack is one fullscreen pass, the resolved frame is read once and the result written once
+		// The quad covers every pixel and blending is off, so the target doesn't need a clear
+		graph.AddPass("Post Processing", { source }, { target }, [source, stack](const RenderPassContext& context)
+		{
+			context.BindFramebuffer();
+			RendererAPI::SetPipelineState(s_FullscreenState);
+
+			context.BindTexture(source, 0);
+
+			const Ref<Shader>& shader = s_RendererData.PostProcessShaders.GetShader(stack.Effects);
+			shader->Bind();
+			s_RendererData.PostProcessShaders.SetUniforms(shader, stack);
+
+			DrawFullscreenQuad();
+		});
+
+		s_RendererData.FrameColor = target;
+	}
+
+	const RendererStats& Renderer::GetStatistics()
+	{
+		const StateCacheStats& stateStats = StateCache::GetStats();
+		s_RendererData.Stats.StateChangesIssued = stateStats.Issued;
+		s_RendererData.Stats.StateChangesFiltered = stateStats.Filtered;
+		s_RendererData.Stats.GPUFrameTime = GPUProfiler::GetFrameTime();
+		s_RendererData.Stats.GPUPassTimings = GPUProfiler::GetPassTimings();
+		s_RendererData.Stats.Graph = s_RendererData.Graph.GetStats();
+		s_RendererData.Stats.RenderWidth = s_RendererData.RenderWidth;
+		s_RendererData.Stats.RenderHeight = s_RendererData.RenderHeight;
+		s_RendererData.Stats.TargetWidth = s_RendererData.TargetWidth;
+		s_RendererData.Stats.TargetHeight = s_RendererData.TargetHeight;
+		s_RendererData.Stats.ResolutionScale = s_RendererData.DynamicResolution.GetScale();
+
+		return s_RendererData.Stats;
+	}
+
+	uint32_t Renderer::GetFrameTextureId()
+	{
+		return s_RendererData.Graph.GetOutputTexture();
+	}
+
+	void Renderer::CaptureFrame(FrameCapture& capture)
 	{
-		return s_RendererData.RenderedToFinalBuffer ? s_RendererData.FinalFramebuffer->GetColorTextureId() : s_RendererData.IntermediateFramebuffer->GetColorTextureId();
+		const RenderGraph& graph = s_RendererData.Graph;
+		capture.Capture(graph.GetOutputTexture(), graph.GetOutputDesc().Width, graph.GetOutputDesc().Height);
 	}
 }
\ No newline at end of file
@@ -2,6 +2,13 @@
 
 #include "Core/Camera.h"
 #include "Renderer/Cubemap.h"
+#include "Renderer/GPUProfiler.h"
+#include "Renderer/FrameCapture.h"
+#include "Renderer/PostProcess.h"
+#include "Renderer/RenderGraph.h"
+#include "Renderer/AntiAliasing.h"
+#include "Renderer/DynamicResolution.h"
+#include "Renderer/Shadows.h"
 
 #include "Utilities/Mesh.h"
 #include "Utilities/Model.h"
@@ -12,33 +19,152 @@ namespace OpenGLRendering {
 	{
 		glm::vec3 LightPos;
 		glm::vec3 LightColor;
+		glm::vec3 SunDirection; // Direction the sunlight travels in
+		glm::vec3 SunColor;
+	};
+
+	// Static meshes are expected to keep their transform, their shadows are cached until the set of static meshes changes
+	enum class Mobility : uint8_t
+	{
+		Static = 0, Dynamic
+	};
+
+	// Light with an inverse square falloff that reaches zero at the radius
+	struct PointLight
+	{
+		glm::vec3 Position;
+		float Radius;
+		glm::vec3 Color;
+	};
+
+	struct SpotLight
+	{
+		glm::vec3 Position;
+		float Radius;
+		glm::vec3 Color;
+		glm::vec3 Direction;
+		float InnerAngle; // Radians from the direction, full intensity inside
+		float OuterAngle; // No light outside
+	};
+
+	enum class ShadingPath : uint8_t
+	{
+		Forward = 0, // Every mesh fragment evaluates the lights of its light cluster
+		Deferred // Surfaces go into a G-buffer, lights are applied per pixel within their screen rectangle
+	};
+
+	enum class DepthPrePassMode : uint8_t
+	{
+		Off = 0, On, Auto // Auto uses the pre-pass when the estimated overdraw is high
 	};
 
 	struct RendererStats
 	{
-		uint32_t VertexCount;
+		uint32_t VertexCount; // Of the drawn meshes
 		uint32_t FaceCount;
+		uint32_t SubmittedMeshes;
+		uint32_t CulledMeshes;
+		uint32_t DrawnMeshes;
+		uint32_t BoundsTests; // Frustum tests of mesh and hierarchy bounds
+		uint32_t LodSwitches; // LOD groups that changed their level this frame
+		uint32_t SubmittedLights;
+		uint32_t Lights; // Inside the frustum
+		uint32_t LightIndices; // Entries of the cluster light lists (forward path)
+		float LightCullingTime; // CPU milliseconds
+		float LightAssignmentTime;
+
+		uint32_t ShadowViews; // Cascades and cube faces that are sampled
+		uint32_t CachedShadowViews; // Whose static casters were not rendered this frame
+		uint32_t ShadowCasters; // Instances drawn into shadow views
+
+		bool DepthPrePass;
+		float EstimatedDepthComplexity; // Summed screen coverage of the drawn meshes
+		uint64_t PrePassFragments; // Fragment shader invocations, a few frames old (0 if not supported)
+		uint64_t ShadedFragments;
 		uint32_t DrawCalls;
+		uint32_t StateChangesIssued;
+		uint32_t StateChangesFiltered;
+
+		float GPUFrameTime; // Milliseconds, a few frames old
+		std::vector<GPUPassTiming> GPUPassTimings;
+
+		RenderGraphStats Graph;
+
+		uint32_t RenderWidth, RenderHeight; // Resolution of the scene passes
+		uint32_t TargetWidth, TargetHeight; // Allocated size of the scene targets
+		float ResolutionScale;
 	};
 
 	class Renderer {
 	public:
 
 		static void Init();
-		static void OnResize(uint32_t width, uint32_t height);
+		static void Shutdown(); // Releases the GPU resources that outlive the scene, has to run while the context exists
+		static void OnResize(uint32_t width, uint32_t height); // Takes effect once the size stopped changing for a moment
 
 		static void BeginScene(Ref<Camera>& camera, Ref<Cubemap>& cubemap, const LightInfo& lightInfo);
-		static void EndScene();
+		static void EndScene(); // Adds the scene passes to the render graph of the frame
+		static void EndFrame(); // Compiles and executes the render graph, the frame texture is ready afterwards
 		
-		static void Submit(Ref<Mesh>& mesh, const glm::mat4& modelMatrix = glm::identity<glm::mat4>());
-		static void Submit(Ref<Model>& model);
-		static void Submit(Ref<Model>& model, uint16_t lod, uint16_t meshesPerLod);
+		static void Submit(Ref<Mesh>& mesh, const glm::mat4& modelMatrix = glm::identity<glm::mat4>(), Mobility mobility = Mobility::Static);
+		static void Submit(Ref<Model>& model, Mobility mobility = Mobility::Static);
+		static void Submit(Ref<Model>& model, uint16_t lod, uint16_t meshesPerLod, Mobility mobility = Mobility::Static);
+		static void SubmitLight(const PointLight& light); // Lights outside of the frustum are dropped in EndScene
+		static void SubmitLight(const SpotLight& light);
+
+		// The deferred path ignores the MSAA anti-aliasing modes
+		static void SetShadingPath(ShadingPath path);
+		static ShadingPath GetShadingPath();
+
+		static void SetDepthPrePassMode(DepthPrePassMode mode);
+		static DepthPrePassMode GetDepthPrePassMode();
+
+		// Meshes whose bounds are outside of the camera frustum are rejected in Submit
+		static void SetFrustumCulling(bool enabled);
+		static bool IsFrustumCulling();
+
+		// Issue one glMultiDrawElementsIndirect per shader / vertex format / textured material instead of one draw per batch
+		static void SetIndirectDrawing(bool enabled);
+		static bool IsIndirectDrawing();
+
+		// Picks the level of every LOD group of a submitted model from its projected screen size
+		// The bias scales the screen size, values above 1 keep the detailed levels longer
+		static void SetAutomaticLod(bool enabled);
+		static bool IsAutomaticLod();
+		static void SetLodBias(float bias);
+		static float GetLodBias();
+
+		// MSAA multiplies the memory and bandwidth of the scene targets, the post process modes filter the resolved image instead
+		static void SetAntiAliasingMode(AntiAliasingMode mode);
+		static AntiAliasingMode GetAntiAliasingMode();
+
+		// Format of the HDR scene target, R11G11B10F has the size of RGBA8, RGBA16F doubles it, RGB10A2 clamps the radiance to [0, 1]
+		static void SetSceneColorFormat(RenderTargetFormat format);
+		static RenderTargetFormat GetSceneColorFormat();
+
+		// Applied by the tonemap pass between the resolve and the anti-aliasing
+		static void SetExposure(float exposure);
+		static float GetExposure();
+		static void SetGamma(float gamma);
+		static float GetGamma();
+
+		// Shadows of the sun and the main light, changing the atlas or tile sizes drops the cached shadows
+		static void SetShadowSettings(const ShadowSettings& settings);
+		static const ShadowSettings& GetShadowSettings();
+
+		// Renders the scene at a fraction of the viewport size that follows the GPU frame time, see DynamicResolution
+		static void SetDynamicResolution(const DynamicResolutionSettings& settings);
+		static const DynamicResolutionSettings& GetDynamicResolution();
+
+		// Applies the colour effects of the stack to the frame in a single pass (between EndScene and EndFrame)
+		static void PostProcess(const PostProcessStack& stack);
 
-		static void ColorGrade(const glm::vec4& color);
-		static void InvertColor();
+		// Shared vertex and index storage of all meshes with the format, created on first use and released in Shutdown
+		static const Ref<GeometryArena>& GetGeometryArena(GeometryFormat format);
 
 		static const RendererStats& GetStatistics();
 		static uint32_t GetFrameTextureId();
+		static void CaptureFrame(FrameCapture& capture); // Queues an asynchronous readback of the final image of the frame
 	};
 
 }
\ No newline at end of file
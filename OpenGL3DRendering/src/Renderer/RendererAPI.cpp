@@ -1,6 +1,8 @@
 #include "oglpch.h"
 
 #include "RendererAPI.h"
+#include "IndirectBuffer.h"
+#include "StateCache.h"
 
 #include <glad/glad.h>
 
@@ -34,21 +36,38 @@ namespace OpenGLRendering {
 		glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DEBUG_SEVERITY_NOTIFICATION, 0, NULL, GL_FALSE);
 #endif
 
-		glEnable(GL_BLEND);
-		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-		glEnable(GL_DEPTH_TEST);
-		glEnable(GL_CULL_FACE);
 		glEnable(GL_MULTISAMPLE);
+
+		StateCache::Invalidate();
+		SetPipelineState(PipelineState());
 		//glEnable(GL_FRAMEBUFFER_SRGB);
 	}
 
+	bool RendererAPI::IsExtensionSupported(const char* name)
+	{
+		GLint count = 0;
+		glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+
+		for (GLint i = 0; i < count; i++)
+		{
+			if (strcmp((const char*)glGetStringi(GL_EXTENSIONS, i), name) == 0)
+				return true;
+		}
+
+		return false;
+	}
+
 	void RendererAPI::SetDepthTesting(bool enable)
 	{
-		if (enable)
-			glEnable(GL_DEPTH_TEST);
-		else
-			glDisable(GL_DEPTH_TEST);
+		PipelineState state = StateCache::GetPipelineState();
+		state.DepthTest = enable;
+
+		StateCache::SetPipelineState(state);
+	}
+
+	void RendererAPI::SetPipelineState(const PipelineState& state)
+	{
+		StateCache::SetPipelineState(state);
 	}
 
 	void RendererAPI::SetClearColor(const glm::vec4& color)
@@ -63,7 +82,7 @@ namespace OpenGLRendering {
 
 	void RendererAPI::SetViewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height)
 	{
-		glViewport(x, y, width, height);
+		StateCache::SetViewport(x, y, width, height);
 	}
 
 	void RendererAPI::DrawIndexed(const std::shared_ptr<VertexArray>& vertexArray, uint32_t indexCount)
@@ -74,13 +93,34 @@ namespace OpenGLRendering {
 		glDrawElements(GL_TRIANGLES, count, GL_UNSIGNED_INT, nullptr);
 	}
 
-	void RendererAPI::BlitFramebuffer(const Ref<Framebuffer>& src, const Ref<Framebuffer>& dest)
+	void RendererAPI::DrawIndexed(uint32_t indexCount)
 	{
-		src->BindForRead();
-		dest->BindForWrite();
+		glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, nullptr);
+	}
+
+	void RendererAPI::DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, uint32_t baseVertex, uint32_t baseInstance)
+	{
+		const void* offset = (const void*)((size_t)firstIndex * sizeof(uint32_t));
+		glDrawElementsInstancedBaseVertexBaseInstance(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, offset, instanceCount, baseVertex, baseInstance);
+	}
+
+	void RendererAPI::MultiDrawIndexedIndirect(uint32_t firstCommand, uint32_t drawCount)
+	{
+		const void* offset = (const void*)((size_t)firstCommand * sizeof(DrawIndexedIndirectCommand));
+		glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, offset, drawCount, 0);
+	}
+
+	void RendererAPI::BlitFramebuffer(uint32_t src, uint32_t dest, uint32_t width, uint32_t height)
+	{
+		StateCache::BindReadFramebuffer(src);
+		StateCache::BindDrawFramebuffer(dest);
 
-		glBlitFramebuffer(0, 0, src->GetSettings().Width, src->GetSettings().Height, 0, 0, dest->GetSettings().Width, dest->GetSettings().Height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+		glBlitFramebuffer(0, 0, width, height, 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+	}
 
-		src->Unbind();
+	void RendererAPI::Finish()
+	{
+		glFinish();
 	}
-}
\ No newline at end of file
+
+}
@@ -1,7 +1,7 @@
 #pragma once
 
 #include "VertexArray.h"
-#include "Framebuffer.h"
+#include "StateCache.h"
 
 #include <memory>
 #include <glm/glm.hpp>
@@ -13,12 +13,18 @@ namespace OpenGLRendering {
 	{
 	public:
 		static void Init();
+		static bool IsExtensionSupported(const char* name);
 		static void SetDepthTesting(bool enable);
+		static void SetPipelineState(const PipelineState& state);
 		static void SetViewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height);
 		static void SetClearColor(const glm::vec4& color);
 		static void Clear();
 		static void DrawIndexed(const std::shared_ptr<VertexArray>& vertexArray, uint32_t indexCount);
-		static void BlitFramebuffer(const Ref<Framebuffer>& src, const Ref<Framebuffer>& dest);
+		static void DrawIndexed(uint32_t indexCount); // Draws with the currently bound vertex array
+		static void DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, uint32_t baseVertex, uint32_t baseInstance); // Draws with the currently bound vertex array
+		static void MultiDrawIndexedIndirect(uint32_t firstCommand, uint32_t drawCount); // Draws with the currently bound vertex array and indirect buffer
+		static void BlitFramebuffer(uint32_t src, uint32_t dest, uint32_t width, uint32_t height); // Colour only, both of the same size
+		static void Finish(); // Blocks until all submitted commands are done
 	};
 
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include "oglpch.h"
 
 #include "Shader.h"
+#include "StateCache.h"
 
 #include <glad/glad.h>
 
@@ -8,6 +9,8 @@ namespace OpenGLRendering {
 
 	Shader::Shader(const std::string& vertexFile, const std::string& fragmentFile)
 	{
+		OGL_PROFILE_FUNCTION();
+
 		std::unordered_map<GLenum, std::string> shaderSources;
 		shaderSources[GL_VERTEX_SHADER] = ReadFile(vertexFile);
 		shaderSources[GL_FRAGMENT_SHADER] = ReadFile(fragmentFile);
@@ -15,19 +18,33 @@ namespace OpenGLRendering {
 		Compile(shaderSources);
 	}
 
+	Ref<Shader> Shader::CreateFromSource(const std::string& vertexSource, const std::string& fragmentSource)
+	{
+		OGL_PROFILE_FUNCTION();
+
+		std::unordered_map<GLenum, std::string> shaderSources;
+		shaderSources[GL_VERTEX_SHADER] = vertexSource;
+		shaderSources[GL_FRAGMENT_SHADER] = fragmentSource;
+
+		Ref<Shader> shader(new Shader());
+		shader->Compile(shaderSources);
+		return shader;
+	}
+
 	Shader::~Shader()
 	{
 		glDeleteProgram(m_RendererID);
+		StateCache::ForgetProgram(m_RendererID);
 	}
 
 	void Shader::Bind() const
 	{
-		glUseProgram(m_RendererID);
+		StateCache::UseProgram(m_RendererID);
 	}
 
 	void Shader::Unbind() const
 	{
-		glUseProgram(0);
+		StateCache::UseProgram(0);
 	}
 
 	std::string Shader::ReadFile(const std::string& filePath)
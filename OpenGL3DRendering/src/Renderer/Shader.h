@@ -6,6 +6,8 @@
 #include <glm/gtc/type_ptr.hpp>
 #include <glm/glm.hpp>
 
+#include "Core/Core.h"
+
 namespace OpenGLRendering {
 
 	// Shader wrapper class (handles compilation, linking and error checking) 
@@ -15,9 +17,15 @@ namespace OpenGLRendering {
 		Shader(const std::string& vertexFile, const std::string& fragmentFile);
 		~Shader();
 
+		// For generated shaders
+		static Ref<Shader> CreateFromSource(const std::string& vertexSource, const std::string& fragmentSource);
+		static std::string ReadFile(const std::string& filePath);
+
 		void Bind() const;
 		void Unbind() const;
 
+		uint32_t GetRendererID() const { return m_RendererID; }
+
 		// Uniforms
 		void SetInt(const std::string& name, int value);
 		void SetIntArray(const std::string& name, int* values, uint32_t count);
@@ -30,12 +38,13 @@ namespace OpenGLRendering {
 		void SetQuat(const std::string& name, const glm::quat& value);
 
 	private:
-		std::string ReadFile(const std::string& filePath);
+		Shader() = default;
+
 		void Compile(const std::unordered_map<uint32_t, std::string>& shaderSources);
 		int32_t GetUniformLocation(const std::string& name);
 
 	private:
-		uint32_t m_RendererID;
+		uint32_t m_RendererID = 0;
 		std::unordered_map<std::string, int32_t> m_UniformLocations;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,209 @@
+#include "oglpch.h"
+
+#include "Shadows.h"
+#include "StateCache.h"
+
+#include <glad/glad.h>
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace OpenGLRendering {
+
+	// The cascades reach this far towards the sun beyond their slice, casters in between still shadow the slice
+	static const float s_CascadeCasterDistance = 100.0f;
+
+	static const float s_PointShadowNearClip = 0.05f;
+
+	ShadowAtlas::~ShadowAtlas()
+	{
+		for (uint32_t texture : m_Textures)
+		{
+			if (texture)
+			{
+				glDeleteTextures(1, &texture);
+				StateCache::ForgetTexture(texture);
+			}
+		}
+	}
+
+	bool ShadowAtlas::Update(RenderGraph& graph, uint32_t size, bool caching)
+	{
+		OGL_ASSERT(size > 0 && (size & (size - 1)) == 0, "The shadow atlas size has to be a power of two");
+
+		if (size == m_Size && caching == IsCaching())
+			return false;
+
+		Release(graph);
+
+		// The atlas is sampled with hardware comparisons, the cache only copied
+		glCreateTextures(GL_TEXTURE_2D, caching ? 2 : 1, m_Textures);
+		for (uint32_t i = 0; i < (caching ? 2u : 1u); i++)
+		{
+			GLenum filter = i == 0 ? GL_LINEAR : GL_NEAREST;
+			glTextureStorage2D(m_Textures[i], 1, GL_DEPTH_COMPONENT32F, size, size);
+			glTextureParameteri(m_Textures[i], GL_TEXTURE_MIN_FILTER, filter);
+			glTextureParameteri(m_Textures[i], GL_TEXTURE_MAG_FILTER, filter);
+			glTextureParameteri(m_Textures[i], GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+			glTextureParameteri(m_Textures[i], GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+			glObjectLabel(GL_TEXTURE, m_Textures[i], -1, i == 0 ? "Shadow Atlas" : "Shadow Cache");
+		}
+
+		glTextureParameteri(m_Textures[0], GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+		glTextureParameteri(m_Textures[0], GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+
+		m_Size = size;
+		ReleaseTiles();
+
+		OGL_INFO("Shadow atlas resized to {0}x{0}{1}", size, caching ? " with static caster cache" : "");
+		return true;
+	}
+
+	void ShadowAtlas::Release(RenderGraph& graph)
+	{
+		for (uint32_t& texture : m_Textures)
+		{
+			if (texture)
+			{
+				graph.ForgetTexture(texture);
+				glDeleteTextures(1, &texture);
+				StateCache::ForgetTexture(texture);
+				texture = 0;
+			}
+		}
+	}
+
+	void ShadowAtlas::ReleaseTiles()
+	{
+		m_FreeTiles.clear();
+		m_FreeTiles.push_back({ 0, 0, m_Size });
+	}
+
+	bool ShadowAtlas::Allocate(uint32_t size, ShadowAtlasTile& tile)
+	{
+		OGL_ASSERT(size > 0 && (size & (size - 1)) == 0, "Shadow tile sizes have to be powers of two");
+
+		// Smallest free square that fits, split into quarters until it has the requested size
+		int32_t best = -1;
+		for (uint32_t i = 0; i < (uint32_t)m_FreeTiles.size(); i++)
+		{
+			if (m_FreeTiles[i].Size >= size && (best < 0 || m_FreeTiles[i].Size < m_FreeTiles[best].Size))
+				best = (int32_t)i;
+		}
+
+		if (best < 0)
+			return false;
+
+		tile = m_FreeTiles[best];
+		m_FreeTiles[best] = m_FreeTiles.back();
+		m_FreeTiles.pop_back();
+
+		while (tile.Size > size)
+		{
+			uint32_t half = tile.Size / 2;
+			m_FreeTiles.push_back({ tile.X + half, tile.Y, half });
+			m_FreeTiles.push_back({ tile.X, tile.Y + half, half });
+			m_FreeTiles.push_back({ tile.X + half, tile.Y + half, half });
+			tile.Size = half;
+		}
+
+		return true;
+	}
+
+	glm::mat4 ShadowAtlas::GetTileMatrix(const ShadowAtlasTile& tile) const
+	{
+		float scale = (float)tile.Size / (float)m_Size;
+
+		glm::mat4 matrix(1.0f);
+		matrix[0][0] = 0.5f * scale;
+		matrix[1][1] = 0.5f * scale;
+		matrix[2][2] = 0.5f;
+		matrix[3][0] = (float)tile.X / (float)m_Size + 0.5f * scale;
+		matrix[3][1] = (float)tile.Y / (float)m_Size + 0.5f * scale;
+		matrix[3][2] = 0.5f;
+
+		return matrix;
+	}
+
+	glm::vec4 ShadowAtlas::GetTileRect(const ShadowAtlasTile& tile) const
+	{
+		float texel = 1.0f / (float)m_Size;
+		return { ((float)tile.X + 0.5f) * texel, ((float)tile.Y + 0.5f) * texel, ((float)(tile.X + tile.Size) - 0.5f) * texel, ((float)(tile.Y + tile.Size) - 0.5f) * texel };
+	}
+
+	void ShadowAtlas::ClearTile(uint32_t texture, const ShadowAtlasTile& tile)
+	{
+		float farDepth = 1.0f;
+		glClearTexSubImage(texture, 0, tile.X, tile.Y, 0, tile.Size, tile.Size, 1, GL_DEPTH_COMPONENT, GL_FLOAT, &farDepth);
+	}
+
+	void ShadowAtlas::CopyTile(uint32_t source, uint32_t destination, const ShadowAtlasTile& tile)
+	{
+		glCopyImageSubData(source, GL_TEXTURE_2D, 0, tile.X, tile.Y, 0, destination, GL_TEXTURE_2D, 0, tile.X, tile.Y, 0, tile.Size, tile.Size, 1);
+	}
+
+	void ComputeShadowCascades(const glm::mat4& viewProjection, float nearClip, float farClip, const glm::vec3& sunDirection, const ShadowSettings& settings, ShadowCascade* cascades)
+	{
+		// Corners of the near and far plane, the corners of a slice lie on the lines between them
+		glm::mat4 inverse = glm::inverse(viewProjection);
+		glm::vec3 nearCorners[4], farCorners[4];
+		for (uint32_t i = 0; i < 4; i++)
+		{
+			float x = (i & 1) ? 1.0f : -1.0f, y = (i & 2) ? 1.0f : -1.0f;
+			glm::vec4 nearCorner = inverse * glm::vec4(x, y, -1.0f, 1.0f);
+			glm::vec4 farCorner = inverse * glm::vec4(x, y, 1.0f, 1.0f);
+			nearCorners[i] = glm::vec3(nearCorner) / nearCorner.w;
+			farCorners[i] = glm::vec3(farCorner) / farCorner.w;
+		}
+
+		// Only the rotation of the light view, the cascades are placed inside it
+		glm::vec3 direction = glm::normalize(sunDirection);
+		glm::vec3 up = std::abs(direction.y) > 0.99f ? glm::vec3(1.0f, 0.0f, 0.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+		glm::mat4 lightView = glm::lookAt(glm::vec3(0.0f), direction, up);
+
+		float distance = std::min(settings.Distance, farClip);
+		float splitNear = nearClip;
+
+		for (uint32_t c = 0; c < settings.CascadeCount; c++)
+		{
+			float fraction = (float)(c + 1) / (float)settings.CascadeCount;
+			float logarithmicSplit = nearClip * std::pow(distance / nearClip, fraction);
+			float uniformSplit = nearClip + (distance - nearClip) * fraction;
+			float splitFar = uniformSplit + (logarithmicSplit - uniformSplit) * settings.SplitLambda;
+
+			glm::vec3 corners[8];
+			glm::vec3 center(0.0f);
+			for (uint32_t i = 0; i < 4; i++)
+			{
+				corners[i] = glm::mix(nearCorners[i], farCorners[i], (splitNear - nearClip) / (farClip - nearClip));
+				corners[i + 4] = glm::mix(nearCorners[i], farCorners[i], (splitFar - nearClip) / (farClip - nearClip));
+				center += (corners[i] + corners[i + 4]) * 0.125f;
+			}
+
+			// Rounded up, so the float noise of a turning camera doesn't change the radius
+			float radius = 0.0f;
+			for (const glm::vec3& corner : corners)
+				radius = std::max(radius, glm::length(corner - center));
+			radius = std::ceil(radius * 16.0f) / 16.0f;
+
+			float texelSize = 2.0f * radius / (float)settings.CascadeSize;
+			glm::vec3 lightCenter = glm::floor(glm::vec3(lightView * glm::vec4(center, 1.0f)) / texelSize) * texelSize;
+
+			// The light view looks along the sunlight, the center is at the view depth -z
+			float depth = -lightCenter.z;
+			glm::mat4 projection = glm::ortho(lightCenter.x - radius, lightCenter.x + radius, lightCenter.y - radius, lightCenter.y + radius, depth - radius - s_CascadeCasterDistance, depth + radius);
+
+			cascades[c] = { projection * lightView, splitFar, texelSize };
+			splitNear = splitFar;
+		}
+	}
+
+	void ComputePointShadowFaces(const glm::vec3& position, float range, glm::mat4* viewProjections)
+	{
+		static const glm::vec3 directions[6] = { { 1.0f, 0.0f, 0.0f }, { -1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }, { 0.0f, -1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f }, { 0.0f, 0.0f, -1.0f } };
+		static const glm::vec3 ups[6] = { { 0.0f, -1.0f, 0.0f }, { 0.0f, -1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f }, { 0.0f, 0.0f, -1.0f }, { 0.0f, -1.0f, 0.0f }, { 0.0f, -1.0f, 0.0f } };
+
+		glm::mat4 projection = glm::perspective(glm::radians(90.0f), 1.0f, s_PointShadowNearClip, range);
+		for (uint32_t i = 0; i < 6; i++)
+			viewProjections[i] = projection * glm::lookAt(position, position + directions[i], ups[i]);
+	}
+
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include <stdint.h>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "Renderer/RenderGraph.h"
+
+// Shadow maps of the sun (cascades fitted around slices of the view frustum) and of the main point light (one view per cube face)
+// Every view renders into a tile of one depth atlas. With caching, the static casters of a view are kept in a second atlas that is only
+// re-rendered when the view or the static casters change, the live tile is a copy of it with the dynamic casters drawn on top
+
+namespace OpenGLRendering {
+
+	struct ShadowSettings
+	{
+		static const uint32_t MaxCascades = 4;
+
+		bool Enabled = true;
+		bool Caching = true;
+		uint32_t AtlasSize = 4096; // Power of two, so are the tile sizes
+		uint32_t CascadeCount = 4;
+		uint32_t CascadeSize = 1024;
+		uint32_t PointLightSize = 512; // Per cube face
+		float Distance = 60.0f; // View depth covered by the cascades
+		float SplitLambda = 0.75f; // Blend between uniform (0) and logarithmic (1) cascade splits
+		float PointLightRange = 30.0f; // Far plane of the cube faces
+		float SlopeBias = 2.0f;
+		float NormalBias = 1.5f; // Texels along the surface normal
+	};
+
+	// Square area of the atlas in texels
+	struct ShadowAtlasTile
+	{
+		uint32_t X, Y;
+		uint32_t Size;
+	};
+
+	struct ShadowCascade
+	{
+		glm::mat4 ViewProjection;
+		float SplitDepth; // View depth where the cascade ends
+		float TexelSize; // World size of a texel
+	};
+
+	// Tiles are split off a quadtree of free squares, they stay valid until the tiles are released or the atlas is recreated
+	class ShadowAtlas
+	{
+	public:
+		ShadowAtlas() = default;
+		~ShadowAtlas();
+
+		ShadowAtlas(const ShadowAtlas&) = delete;
+		ShadowAtlas& operator=(const ShadowAtlas&) = delete;
+
+		// The textures are imported into the graph, so it has to forget them when they are recreated
+		// Returns true if the textures were recreated, all tiles are released then
+		bool Update(RenderGraph& graph, uint32_t size, bool caching);
+		void ReleaseTiles();
+		bool Allocate(uint32_t size, ShadowAtlasTile& tile); // False if no free square is large enough
+
+		glm::mat4 GetTileMatrix(const ShadowAtlasTile& tile) const; // Clip space of a view to texture coordinates and depth of its tile
+		glm::vec4 GetTileRect(const ShadowAtlasTile& tile) const; // Texture coordinates (xy: min, zw: max), shrunk by half a texel
+
+		static void ClearTile(uint32_t texture, const ShadowAtlasTile& tile);
+		static void CopyTile(uint32_t source, uint32_t destination, const ShadowAtlasTile& tile);
+
+		uint32_t GetTexture() const { return m_Textures[0]; } // Sampled with depth comparison
+		uint32_t GetCacheTexture() const { return m_Textures[1]; } // Static casters, 0 without caching
+		bool IsCaching() const { return m_Textures[1] != 0; }
+		RenderTargetDesc GetDesc() const { return { m_Size, m_Size, RenderTargetFormat::Depth32F }; }
+
+	private:
+		void Release(RenderGraph& graph);
+
+	private:
+		uint32_t m_Textures[2] = {};
+		uint32_t m_Size = 0;
+		std::vector<ShadowAtlasTile> m_FreeTiles;
+	};
+
+	// The cascades are bounding spheres of the slices, so their size doesn't change when the camera turns, and they are
+	// moved in whole texels only, so the shadow edges don't crawl and the cached tiles stay valid while the camera stands still
+	// The view projection has to be the one of the camera without jitter
+	void ComputeShadowCascades(const glm::mat4& viewProjection, float nearClip, float farClip, const glm::vec3& sunDirection, const ShadowSettings& settings, ShadowCascade* cascades);
+
+	// Cube faces in the order +X, -X, +Y, -Y, +Z, -Z
+	void ComputePointShadowFaces(const glm::vec3& position, float range, glm::mat4* viewProjections);
+
+}
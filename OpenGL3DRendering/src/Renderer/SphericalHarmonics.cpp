@@ -0,0 +1,144 @@
+#include "oglpch.h"
+
+#include "SphericalHarmonics.h"
+
+#include <thread>
+#include <emmintrin.h>
+#include <glm/gtc/constants.hpp>
+
+namespace OpenGLRendering {
+
+	static const uint32_t s_MinRowsPerJob = 16;
+
+	// Band factors of the cosine lobe convolution divided by pi: 1, 2 / 3, 1 / 4
+	static const float s_BandFactors[9] = { 1.0f, 2.0f / 3.0f, 2.0f / 3.0f, 2.0f / 3.0f, 0.25f, 0.25f, 0.25f, 0.25f, 0.25f };
+
+	// Weighted radiance of four pixels, the lanes past the end of the row are zero
+	static void LoadPixels(const float* row, uint32_t column, uint32_t width, uint32_t channels, __m128 weight, __m128 radiance[3])
+	{
+		float values[3][4] = {};
+		for (uint32_t lane = 0; lane < 4 && column + lane < width; lane++)
+		{
+			const float* pixel = row + (size_t)(column + lane) * channels;
+			for (uint32_t c = 0; c < 3; c++)
+				values[c][lane] = pixel[c];
+		}
+
+		for (uint32_t c = 0; c < 3; c++)
+			radiance[c] = _mm_mul_ps(_mm_loadu_ps(values[c]), weight);
+	}
+
+	static float HorizontalSum(__m128 value)
+	{
+		float lanes[4];
+		_mm_storeu_ps(lanes, value);
+		return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+	}
+
+	// Sums of a range of rows, accumulated per row in floats and across rows in doubles
+	static void ProjectRows(const float* pixels, uint32_t width, uint32_t height, uint32_t channels, const std::vector<float>& cosPhi, const std::vector<float>& sinPhi,
+		uint32_t firstRow, uint32_t lastRow, double sums[9][3])
+	{
+		const float pi = glm::pi<float>();
+
+		for (uint32_t y = firstRow; y < lastRow; y++)
+		{
+			// The bottom row looks down, the solid angle of a pixel shrinks towards the poles
+			float latitude = ((y + 0.5f) / (float)height - 0.5f) * pi;
+			float cosLatitude = std::cos(latitude);
+			float solidAngle = (2.0f * pi / (float)width) * (pi / (float)height) * cosLatitude;
+
+			const float* row = pixels + (size_t)y * width * channels;
+			__m128 dirY = _mm_set1_ps(std::sin(latitude));
+			__m128 weight = _mm_set1_ps(solidAngle);
+			__m128 cosLat = _mm_set1_ps(cosLatitude);
+
+			__m128 rowSums[9][3];
+			for (uint32_t i = 0; i < 9; i++)
+				for (uint32_t c = 0; c < 3; c++)
+					rowSums[i][c] = _mm_setzero_ps();
+
+			for (uint32_t x = 0; x < width; x += 4)
+			{
+				__m128 dirX = _mm_mul_ps(cosLat, _mm_loadu_ps(&cosPhi[x]));
+				__m128 dirZ = _mm_mul_ps(cosLat, _mm_loadu_ps(&sinPhi[x]));
+
+				__m128 basis[9];
+				basis[0] = _mm_set1_ps(0.282095f);
+				basis[1] = _mm_mul_ps(_mm_set1_ps(0.488603f), dirY);
+				basis[2] = _mm_mul_ps(_mm_set1_ps(0.488603f), dirZ);
+				basis[3] = _mm_mul_ps(_mm_set1_ps(0.488603f), dirX);
+				basis[4] = _mm_mul_ps(_mm_set1_ps(1.092548f), _mm_mul_ps(dirX, dirY));
+				basis[5] = _mm_mul_ps(_mm_set1_ps(1.092548f), _mm_mul_ps(dirY, dirZ));
+				basis[6] = _mm_mul_ps(_mm_set1_ps(0.315392f), _mm_sub_ps(_mm_mul_ps(_mm_set1_ps(3.0f), _mm_mul_ps(dirZ, dirZ)), _mm_set1_ps(1.0f)));
+				basis[7] = _mm_mul_ps(_mm_set1_ps(1.092548f), _mm_mul_ps(dirX, dirZ));
+				basis[8] = _mm_mul_ps(_mm_set1_ps(0.546274f), _mm_sub_ps(_mm_mul_ps(dirX, dirX), _mm_mul_ps(dirY, dirY)));
+
+				__m128 radiance[3];
+				LoadPixels(row, x, width, channels, weight, radiance);
+
+				for (uint32_t i = 0; i < 9; i++)
+					for (uint32_t c = 0; c < 3; c++)
+						rowSums[i][c] = _mm_add_ps(rowSums[i][c], _mm_mul_ps(basis[i], radiance[c]));
+			}
+
+			for (uint32_t i = 0; i < 9; i++)
+				for (uint32_t c = 0; c < 3; c++)
+					sums[i][c] += HorizontalSum(rowSums[i][c]);
+		}
+	}
+
+	IrradianceSH ComputeIrradianceSH(const float* pixels, uint32_t width, uint32_t height, uint32_t channels)
+	{
+		OGL_PROFILE_FUNCTION();
+
+		OGL_ASSERT(channels >= 3, "The environment image needs RGB channels");
+
+		// Longitude of every column, padded to whole groups of four
+		uint32_t paddedWidth = (width + 3) & ~3u;
+		std::vector<float> cosPhi(paddedWidth, 0.0f), sinPhi(paddedWidth, 0.0f);
+		for (uint32_t x = 0; x < width; x++)
+		{
+			float phi = ((x + 0.5f) / (float)width - 0.5f) * 2.0f * glm::pi<float>();
+			cosPhi[x] = std::cos(phi);
+			sinPhi[x] = std::sin(phi);
+		}
+
+		uint32_t hardwareThreads = std::max(std::thread::hardware_concurrency(), 1u);
+		uint32_t jobCount = std::max(std::min(hardwareThreads, height / s_MinRowsPerJob), 1u);
+
+		// Every job sums its own rows, the partial sums are added in job order so the result doesn't depend on the timing
+		std::vector<std::array<std::array<double, 3>, 9>> partialSums(jobCount);
+		auto runJob = [&](uint32_t job)
+		{
+			double sums[9][3] = {};
+			ProjectRows(pixels, width, height, channels, cosPhi, sinPhi, height * job / jobCount, height * (job + 1) / jobCount, sums);
+
+			for (uint32_t i = 0; i < 9; i++)
+				for (uint32_t c = 0; c < 3; c++)
+					partialSums[job][i][c] = sums[i][c];
+		};
+
+		std::vector<std::thread> workers;
+		for (uint32_t job = 1; job < jobCount; job++)
+			workers.emplace_back(runJob, job);
+
+		runJob(0);
+		for (std::thread& worker : workers)
+			worker.join();
+
+		IrradianceSH result = {};
+		for (uint32_t i = 0; i < 9; i++)
+		{
+			double sum[3] = {};
+			for (uint32_t job = 0; job < jobCount; job++)
+				for (uint32_t c = 0; c < 3; c++)
+					sum[c] += partialSums[job][i][c];
+
+			result.Coefficients[i] = glm::vec4((float)sum[0], (float)sum[1], (float)sum[2], 0.0f) * s_BandFactors[i];
+		}
+
+		return result;
+	}
+
+}
@@ -0,0 +1,21 @@
+#pragma once
+#include <stdint.h>
+#include <glm/glm.hpp>
+
+// Diffuse environment lighting as second order spherical harmonics: the HDR image is projected onto the 9 basis functions on the CPU and
+// the projection is convolved with the cosine lobe, so the shaders get the irradiance of a normal from a short polynomial instead of
+// a convolved cube map. The rows are split between threads, the pixels of a row are processed four at a time with SSE
+
+namespace OpenGLRendering {
+
+	// Coefficients in the order (l, m) = (0, 0), (1, -1), (1, 0), (1, 1), (2, -2), (2, -1), (2, 0), (2, 1), (2, 2)
+	// Already convolved and divided by pi, the basis functions of a normal sum up to irradiance / pi (std140 vec4 array, rgb)
+	struct IrradianceSH
+	{
+		glm::vec4 Coefficients[9];
+	};
+
+	// Equirectangular RGB or RGBA float image, rows from bottom to top as uploaded to OpenGL
+	IrradianceSH ComputeIrradianceSH(const float* pixels, uint32_t width, uint32_t height, uint32_t channels);
+
+}
@@ -0,0 +1,256 @@
+#include "oglpch.h"
+
+#include "StateCache.h"
+
+#include <glad/glad.h>
+
+namespace OpenGLRendering {
+
+	static const uint32_t s_Unknown = 0xFFFFFFFF;
+	static const uint32_t s_MaxTextureUnits = 32;
+
+	struct StateCacheData
+	{
+		uint32_t Program;
+		uint32_t VertexArray;
+		uint32_t Textures[s_MaxTextureUnits];
+		uint32_t DrawFramebuffer;
+		uint32_t ReadFramebuffer;
+		uint32_t Viewport[4];
+
+		PipelineState Pipeline;
+		bool PipelineKnown;
+
+		StateCacheStats Stats;
+	};
+
+	static StateCacheData s_StateCache;
+
+	// Returns true if the value changed, counts the call either way
+	static bool Update(uint32_t& cached, uint32_t value)
+	{
+		if (cached == value)
+		{
+			s_StateCache.Stats.Filtered++;
+			return false;
+		}
+
+		cached = value;
+		s_StateCache.Stats.Issued++;
+		return true;
+	}
+
+	static void SetCapability(GLenum capability, bool enable)
+	{
+		if (enable)
+			glEnable(capability);
+		else
+			glDisable(capability);
+	}
+
+	static GLenum DepthFunctionToOpenGL(DepthFunction function)
+	{
+		switch (function)
+		{
+		case DepthFunction::Less:		return GL_LESS;
+		case DepthFunction::LessEqual:	return GL_LEQUAL;
+		case DepthFunction::Equal:		return GL_EQUAL;
+		case DepthFunction::Always:		return GL_ALWAYS;
+		}
+
+		OGL_ASSERT(false, "Unknown DepthFunction");
+		return 0;
+	}
+
+	void StateCache::Invalidate()
+	{
+		s_StateCache.Program = s_Unknown;
+		s_StateCache.VertexArray = s_Unknown;
+		for (uint32_t& texture : s_StateCache.Textures)
+			texture = s_Unknown;
+		s_StateCache.DrawFramebuffer = s_Unknown;
+		s_StateCache.ReadFramebuffer = s_Unknown;
+		for (uint32_t& value : s_StateCache.Viewport)
+			value = s_Unknown;
+
+		s_StateCache.PipelineKnown = false;
+	}
+
+	void StateCache::ResetStats()
+	{
+		s_StateCache.Stats = {};
+	}
+
+	void StateCache::ForgetProgram(uint32_t program)
+	{
+		if (s_StateCache.Program == program)
+			s_StateCache.Program = s_Unknown;
+	}
+
+	void StateCache::ForgetVertexArray(uint32_t vertexArray)
+	{
+		if (s_StateCache.VertexArray == vertexArray)
+			s_StateCache.VertexArray = s_Unknown;
+	}
+
+	void StateCache::ForgetTexture(uint32_t texture)
+	{
+		for (uint32_t& bound : s_StateCache.Textures)
+		{
+			if (bound == texture)
+				bound = s_Unknown;
+		}
+	}
+
+	void StateCache::ForgetFramebuffer(uint32_t framebuffer)
+	{
+		if (s_StateCache.DrawFramebuffer == framebuffer)
+			s_StateCache.DrawFramebuffer = s_Unknown;
+		if (s_StateCache.ReadFramebuffer == framebuffer)
+			s_StateCache.ReadFramebuffer = s_Unknown;
+	}
+
+	void StateCache::UseProgram(uint32_t program)
+	{
+		if (Update(s_StateCache.Program, program))
+			glUseProgram(program);
+	}
+
+	void StateCache::BindVertexArray(uint32_t vertexArray)
+	{
+		if (Update(s_StateCache.VertexArray, vertexArray))
+			glBindVertexArray(vertexArray);
+	}
+
+	void StateCache::BindTexture(uint32_t unit, uint32_t texture)
+	{
+		if (unit >= s_MaxTextureUnits)
+		{
+			glBindTextureUnit(unit, texture);
+			s_StateCache.Stats.Issued++;
+			return;
+		}
+
+		if (Update(s_StateCache.Textures[unit], texture))
+			glBindTextureUnit(unit, texture);
+	}
+
+	void StateCache::BindFramebuffer(uint32_t framebuffer)
+	{
+		if (s_StateCache.DrawFramebuffer == framebuffer && s_StateCache.ReadFramebuffer == framebuffer)
+		{
+			s_StateCache.Stats.Filtered++;
+			return;
+		}
+
+		s_StateCache.DrawFramebuffer = framebuffer;
+		s_StateCache.ReadFramebuffer = framebuffer;
+		s_StateCache.Stats.Issued++;
+		glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+	}
+
+	void StateCache::BindDrawFramebuffer(uint32_t framebuffer)
+	{
+		if (Update(s_StateCache.DrawFramebuffer, framebuffer))
+			glBindFramebuffer(GL_DRAW_FRAMEBUFFER, framebuffer);
+	}
+
+	void StateCache::BindReadFramebuffer(uint32_t framebuffer)
+	{
+		if (Update(s_StateCache.ReadFramebuffer, framebuffer))
+			glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+	}
+
+	void StateCache::SetViewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height)
+	{
+		uint32_t* viewport = s_StateCache.Viewport;
+		if (viewport[0] == x && viewport[1] == y && viewport[2] == width && viewport[3] == height)
+		{
+			s_StateCache.Stats.Filtered++;
+			return;
+		}
+
+		viewport[0] = x;
+		viewport[1] = y;
+		viewport[2] = width;
+		viewport[3] = height;
+		s_StateCache.Stats.Issued++;
+		glViewport(x, y, width, height);
+	}
+
+	void StateCache::SetPipelineState(const PipelineState& state)
+	{
+		// Every field is compared on its own, so switching between similar blocks only touches what differs
+		PipelineState& current = s_StateCache.Pipeline;
+		bool known = s_StateCache.PipelineKnown;
+		uint32_t issued = 0;
+
+		if (!known || current.DepthTest != state.DepthTest)
+		{
+			SetCapability(GL_DEPTH_TEST, state.DepthTest);
+			issued++;
+		}
+
+		if (!known || current.DepthWrite != state.DepthWrite)
+		{
+			glDepthMask(state.DepthWrite ? GL_TRUE : GL_FALSE);
+			issued++;
+		}
+
+		if (!known || current.DepthFunc != state.DepthFunc)
+		{
+			glDepthFunc(DepthFunctionToOpenGL(state.DepthFunc));
+			issued++;
+		}
+
+		if (!known || current.Blend != state.Blend)
+		{
+			SetCapability(GL_BLEND, state.Blend != BlendMode::None);
+			if (state.Blend == BlendMode::Alpha)
+				glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+			else if (state.Blend == BlendMode::Additive)
+				glBlendFunc(GL_ONE, GL_ONE);
+			issued++;
+		}
+
+		if (!known || current.Cull != state.Cull)
+		{
+			SetCapability(GL_CULL_FACE, state.Cull != CullMode::None);
+			if (state.Cull != CullMode::None)
+				glCullFace(state.Cull == CullMode::Back ? GL_BACK : GL_FRONT);
+			issued++;
+		}
+
+		if (!known || current.ColorWrite != state.ColorWrite)
+		{
+			GLboolean write = state.ColorWrite ? GL_TRUE : GL_FALSE;
+			glColorMask(write, write, write, write);
+			issued++;
+		}
+
+		if (!known || current.DepthBias != state.DepthBias)
+		{
+			SetCapability(GL_POLYGON_OFFSET_FILL, state.DepthBias != 0.0f);
+			if (state.DepthBias != 0.0f)
+				glPolygonOffset(state.DepthBias, 1.0f);
+			issued++;
+		}
+
+		s_StateCache.Stats.Issued += issued;
+		s_StateCache.Stats.Filtered += 7 - issued;
+
+		current = state;
+		s_StateCache.PipelineKnown = true;
+	}
+
+	const PipelineState& StateCache::GetPipelineState()
+	{
+		return s_StateCache.Pipeline;
+	}
+
+	const StateCacheStats& StateCache::GetStats()
+	{
+		return s_StateCache.Stats;
+	}
+
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include <stdint.h>
+
+// Tracks the OpenGL state that is bound by the renderer and filters out calls that would not change anything
+// Code that calls into OpenGL directly (resource creation, ImGui) has to run outside of a scene, BeginScene invalidates the cache
+
+namespace OpenGLRendering {
+
+	enum class DepthFunction : uint8_t
+	{
+		Less = 0, LessEqual, Equal, Always
+	};
+
+	enum class CullMode : uint8_t
+	{
+		None = 0, Back, Front
+	};
+
+	enum class BlendMode : uint8_t
+	{
+		None = 0,
+		Alpha, // src alpha, one minus src alpha
+		Additive // one, one (light accumulation)
+	};
+
+	// Fixed function state of a draw, applied as a whole but only the differing parts reach OpenGL
+	struct PipelineState
+	{
+		bool DepthTest = true;
+		bool DepthWrite = true;
+		DepthFunction DepthFunc = DepthFunction::LessEqual;
+		BlendMode Blend = BlendMode::Alpha;
+		CullMode Cull = CullMode::Back;
+		bool ColorWrite = true;
+		float DepthBias = 0.0f; // Slope scaled polygon offset, shadow maps use it against self shadowing
+	};
+
+	struct StateCacheStats
+	{
+		uint32_t Issued; // State calls that reached OpenGL
+		uint32_t Filtered; // State calls that were skipped because the state was already set
+	};
+
+	class StateCache
+	{
+	public:
+		static void Invalidate(); // Forget all tracked state, the next call of every kind reaches OpenGL
+		static void ResetStats();
+
+		// Deleted objects are unbound by OpenGL and their names can be reused, so the cache must not keep them
+		static void ForgetProgram(uint32_t program);
+		static void ForgetVertexArray(uint32_t vertexArray);
+		static void ForgetTexture(uint32_t texture);
+		static void ForgetFramebuffer(uint32_t framebuffer);
+
+		static void UseProgram(uint32_t program);
+		static void BindVertexArray(uint32_t vertexArray);
+		static void BindTexture(uint32_t unit, uint32_t texture);
+		static void BindFramebuffer(uint32_t framebuffer); // Draw and read
+		static void BindDrawFramebuffer(uint32_t framebuffer);
+		static void BindReadFramebuffer(uint32_t framebuffer);
+		static void SetViewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height);
+		static void SetPipelineState(const PipelineState& state);
+
+		static const PipelineState& GetPipelineState(); // Last applied state, only meaningful after SetPipelineState
+		static const StateCacheStats& GetStats();
+	};
+
+}
@@ -0,0 +1,76 @@
+#include "oglpch.h"
+
+#include "StatisticsQuery.h"
+#include "RendererAPI.h"
+
+#include <glad/glad.h>
+
+namespace OpenGLRendering {
+
+	static GLenum StatisticsTypeToOpenGLTarget(StatisticsType type)
+	{
+		switch (type)
+		{
+		case StatisticsType::FragmentShaderInvocations:	return GL_FRAGMENT_SHADER_INVOCATIONS;
+		case StatisticsType::SamplesPassed:				return GL_SAMPLES_PASSED;
+		}
+
+		OGL_ASSERT(false, "Unknown StatisticsType");
+		return 0;
+	}
+
+	StatisticsQuery::StatisticsQuery(StatisticsType type)
+		: m_Target(StatisticsTypeToOpenGLTarget(type))
+	{
+		glCreateQueries(m_Target, s_RingSize, m_Queries);
+	}
+
+	StatisticsQuery::~StatisticsQuery()
+	{
+		glDeleteQueries(s_RingSize, m_Queries);
+	}
+
+	void StatisticsQuery::Begin()
+	{
+		// The query that is about to be reused was issued s_RingSize frames ago and is normally finished
+		// If the GPU is further behind its result is dropped and the previous one is kept
+		if (m_Serials[m_Current])
+		{
+			GLint available = 0;
+			glGetQueryObjectiv(m_Queries[m_Current], GL_QUERY_RESULT_AVAILABLE, &available);
+
+			if (available)
+			{
+				GLuint64 result = 0;
+				glGetQueryObjectui64v(m_Queries[m_Current], GL_QUERY_RESULT, &result);
+
+				m_Result = result;
+				m_ResultSerial = m_Serials[m_Current];
+			}
+
+			m_Serials[m_Current] = 0;
+		}
+
+		glBeginQuery(m_Target, m_Queries[m_Current]);
+	}
+
+	void StatisticsQuery::End()
+	{
+		glEndQuery(m_Target);
+
+		m_Serials[m_Current] = m_NextSerial++;
+		m_Current = (m_Current + 1) % s_RingSize;
+	}
+
+	bool StatisticsQuery::IsSupported(StatisticsType type)
+	{
+		switch (type)
+		{
+		case StatisticsType::FragmentShaderInvocations:	return GLAD_GL_VERSION_4_6 || RendererAPI::IsExtensionSupported("GL_ARB_pipeline_statistics_query");
+		case StatisticsType::SamplesPassed:				return true;
+		}
+
+		return false;
+	}
+
+}
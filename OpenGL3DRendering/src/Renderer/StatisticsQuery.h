@@ -0,0 +1,40 @@
+#pragma once
+#include <stdint.h>
+
+// Pipeline statistics query (OpenGL abstraction)
+// Results are read from a small ring of query objects a few frames later and only once they are available, so reading them never stalls the pipeline
+
+namespace OpenGLRendering {
+
+	enum class StatisticsType : uint8_t
+	{
+		FragmentShaderInvocations = 0, SamplesPassed
+	};
+
+	class StatisticsQuery
+	{
+	public:
+		StatisticsQuery(StatisticsType type);
+		~StatisticsQuery();
+
+		void Begin();
+		void End();
+
+		uint64_t GetResult() const { return m_Result; } // Latest available result
+		uint64_t GetResultSerial() const { return m_ResultSerial; } // Number of the Begin / End pair the result belongs to, starting at 1
+
+		static bool IsSupported(StatisticsType type);
+
+	private:
+		static const uint32_t s_RingSize = 3;
+
+		uint32_t m_Target;
+		uint32_t m_Queries[s_RingSize];
+		uint64_t m_Serials[s_RingSize] = {}; // 0 if the query has no pending result
+		uint32_t m_Current = 0;
+		uint64_t m_Result = 0;
+		uint64_t m_ResultSerial = 0;
+		uint64_t m_NextSerial = 1;
+	};
+
+}
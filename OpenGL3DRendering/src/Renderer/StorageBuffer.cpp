@@ -0,0 +1,38 @@
+#include "oglpch.h"
+
+#include "StorageBuffer.h"
+
+#include <glad/glad.h>
+
+namespace OpenGLRendering {
+
+	StorageBuffer::StorageBuffer(uint32_t size, uint32_t binding)
+		: m_Size(size), m_Binding(binding)
+	{
+		glCreateBuffers(1, &m_RendererID);
+		glNamedBufferData(m_RendererID, size, nullptr, GL_DYNAMIC_DRAW);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, m_Binding, m_RendererID);
+	}
+
+	StorageBuffer::~StorageBuffer()
+	{
+		glDeleteBuffers(1, &m_RendererID);
+	}
+
+	void StorageBuffer::SetData(const void* data, uint32_t size, uint32_t offset)
+	{
+		glNamedBufferSubData(m_RendererID, offset, size, data);
+	}
+
+	void StorageBuffer::Resize(uint32_t size)
+	{
+		glNamedBufferData(m_RendererID, size, nullptr, GL_DYNAMIC_DRAW);
+		m_Size = size;
+	}
+
+	void StorageBuffer::Bind() const
+	{
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, m_Binding, m_RendererID);
+	}
+
+}
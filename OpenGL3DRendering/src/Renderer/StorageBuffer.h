@@ -0,0 +1,28 @@
+#pragma once
+#include <stdint.h>
+
+// ShaderStorageBuffer wrapper class (OpenGL abstraction)
+// The buffer is bound to a fixed binding point, shaders reference it via layout(std430, binding = x)
+
+namespace OpenGLRendering {
+
+	class StorageBuffer
+	{
+	public:
+		StorageBuffer(uint32_t size, uint32_t binding);
+		~StorageBuffer();
+
+		void SetData(const void* data, uint32_t size, uint32_t offset = 0);
+		void Resize(uint32_t size); // Reallocates the storage (contents are lost)
+		void Bind() const;
+
+		uint32_t GetSize() const { return m_Size; }
+		uint32_t GetBinding() const { return m_Binding; }
+
+	private:
+		uint32_t m_RendererID;
+		uint32_t m_Size;
+		uint32_t m_Binding;
+	};
+
+}
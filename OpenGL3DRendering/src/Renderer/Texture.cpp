@@ -1,6 +1,7 @@
 #include "oglpch.h"
 
 #include "Texture.h"
+#include "StateCache.h"
 
 #include <stb_image.h>
 #include <glad/glad.h>
@@ -10,6 +11,8 @@ namespace OpenGLRendering {
 	Texture2D::Texture2D(const std::string& filePath)
 		: m_Path(filePath)
 	{
+		OGL_PROFILE_FUNCTION();
+
 		int width, height, channels;
 		stbi_set_flip_vertically_on_load(1);
 
@@ -92,6 +95,7 @@ namespace OpenGLRendering {
 	Texture2D::~Texture2D()
 	{
 		glDeleteTextures(1, &m_RendererID);
+		StateCache::ForgetTexture(m_RendererID);
 	}
 
 	void Texture2D::SetData(void* data, uint32_t size)
@@ -106,7 +110,7 @@ namespace OpenGLRendering {
 
 	void Texture2D::Bind(uint32_t slot) const
 	{
-		glBindTextureUnit(slot, m_RendererID);
+		StateCache::BindTexture(slot, m_RendererID);
 	}
 
 
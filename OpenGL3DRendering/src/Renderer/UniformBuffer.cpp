@@ -0,0 +1,32 @@
+#include "oglpch.h"
+
+#include "UniformBuffer.h"
+
+#include <glad/glad.h>
+
+namespace OpenGLRendering {
+
+	UniformBuffer::UniformBuffer(uint32_t size, uint32_t binding)
+		: m_Binding(binding)
+	{
+		glCreateBuffers(1, &m_RendererID);
+		glNamedBufferData(m_RendererID, size, nullptr, GL_DYNAMIC_DRAW);
+		glBindBufferBase(GL_UNIFORM_BUFFER, m_Binding, m_RendererID);
+	}
+
+	UniformBuffer::~UniformBuffer()
+	{
+		glDeleteBuffers(1, &m_RendererID);
+	}
+
+	void UniformBuffer::SetData(const void* data, uint32_t size, uint32_t offset)
+	{
+		glNamedBufferSubData(m_RendererID, offset, size, data);
+	}
+
+	void UniformBuffer::Bind() const
+	{
+		glBindBufferBase(GL_UNIFORM_BUFFER, m_Binding, m_RendererID);
+	}
+
+}
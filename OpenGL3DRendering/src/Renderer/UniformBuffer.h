@@ -0,0 +1,25 @@
+#pragma once
+#include <stdint.h>
+
+// UniformBuffer wrapper class (OpenGL abstraction)
+// The buffer is bound to a fixed binding point, shaders reference it via layout(std140, binding = x)
+
+namespace OpenGLRendering {
+
+	class UniformBuffer
+	{
+	public:
+		UniformBuffer(uint32_t size, uint32_t binding);
+		~UniformBuffer();
+
+		void SetData(const void* data, uint32_t size, uint32_t offset = 0);
+		void Bind() const;
+
+		uint32_t GetBinding() const { return m_Binding; }
+
+	private:
+		uint32_t m_RendererID;
+		uint32_t m_Binding;
+	};
+
+}
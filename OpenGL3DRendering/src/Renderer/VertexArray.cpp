@@ -1,6 +1,7 @@
 #include "oglpch.h"
 
 #include "VertexArray.h"
+#include "StateCache.h"
 
 #include <glad/glad.h>
 
@@ -35,45 +36,69 @@ namespace OpenGLRendering {
 	VertexArray::~VertexArray()
 	{
 		glDeleteVertexArrays(1, &m_RendererID);
+		StateCache::ForgetVertexArray(m_RendererID);
 	}
 
 	void VertexArray::Bind() const
 	{
-		glBindVertexArray(m_RendererID);
+		StateCache::BindVertexArray(m_RendererID);
 	}
 
 	void VertexArray::Unbind() const
 	{
-		glBindVertexArray(0);
+		StateCache::BindVertexArray(0);
 	}
 
 	void VertexArray::AddVertexBuffer(const std::shared_ptr<VertexBuffer>& vertexBuffer)
+	{
+		AddVertexBuffer(vertexBuffer, m_VertexBufferIndex);
+	}
+
+	void VertexArray::AddVertexBuffer(const std::shared_ptr<VertexBuffer>& vertexBuffer, uint32_t firstLocation)
 	{
 		OGL_ASSERT(vertexBuffer->GetLayout().GetElements().size(), "Vertex Buffer has no layout!");
 
-		glBindVertexArray(m_RendererID);
+		StateCache::BindVertexArray(m_RendererID);
 		vertexBuffer->Bind();
 
+		uint32_t location = firstLocation;
 		const auto& layout = vertexBuffer->GetLayout();
 		for (const auto& element : layout.GetElements())
 		{
-			glEnableVertexAttribArray(m_VertexBufferIndex);
-			glVertexAttribPointer(m_VertexBufferIndex,
-				element.GetComponentCount(),
-				ShaderDataTypeToOpenGLType(element.Type),
-				element.Normalized ? GL_TRUE : GL_FALSE,
-				layout.GetStride(),
-				(const void*)element.Offset);
-
-			m_VertexBufferIndex++;
+			GLenum type = ShaderDataTypeToOpenGLType(element.Type);
+			uint32_t locationCount = element.GetLocationCount();
+			uint32_t componentCount = element.GetComponentCount() / locationCount;
+			uint32_t columnSize = element.Size / locationCount;
+
+			for (uint32_t i = 0; i < locationCount; i++)
+			{
+				const void* offset = (const void*)(element.Offset + (size_t)i * columnSize);
+
+				glEnableVertexAttribArray(location);
+
+				if (type == GL_INT)
+					glVertexAttribIPointer(location, componentCount, type, layout.GetStride(), offset);
+				else
+					glVertexAttribPointer(location, componentCount, type, element.Normalized ? GL_TRUE : GL_FALSE, layout.GetStride(), offset);
+
+				glVertexAttribDivisor(location, element.PerInstance ? 1 : 0);
+
+				location++;
+			}
 		}
 
+		m_VertexBufferIndex = std::max(m_VertexBufferIndex, location);
 		m_VertexBuffers.push_back(vertexBuffer);
 	}
 
+	bool VertexArray::HasVertexBuffer(const std::shared_ptr<VertexBuffer>& vertexBuffer) const
+	{
+		return std::find(m_VertexBuffers.begin(), m_VertexBuffers.end(), vertexBuffer) != m_VertexBuffers.end();
+	}
+
 	void VertexArray::SetIndexBuffer(const std::shared_ptr<IndexBuffer>& indexBuffer)
 	{
-		glBindVertexArray(m_RendererID);
+		StateCache::BindVertexArray(m_RendererID);
 		indexBuffer->Bind();
 
 		m_IndexBuffer = indexBuffer;
@@ -18,10 +18,13 @@ namespace OpenGLRendering {
 		void Unbind() const;
 
 		void AddVertexBuffer(const std::shared_ptr<VertexBuffer>& vertexBuffer);
+		void AddVertexBuffer(const std::shared_ptr<VertexBuffer>& vertexBuffer, uint32_t firstLocation); // Starts at an explicit attribute location
+		bool HasVertexBuffer(const std::shared_ptr<VertexBuffer>& vertexBuffer) const;
 		void SetIndexBuffer(const std::shared_ptr<IndexBuffer>& indexBuffer);
 
 		const std::vector<std::shared_ptr<VertexBuffer>>& GetVertexBuffers() const { return m_VertexBuffers; }
 		const std::shared_ptr<IndexBuffer>& GetIndexBuffer() const { return m_IndexBuffer; }
+		uint32_t GetRendererID() const { return m_RendererID; }
 
 	private:
 		uint32_t m_RendererID;
@@ -41,12 +41,13 @@ namespace OpenGLRendering {
 		uint32_t Size;
 		size_t Offset;
 		bool Normalized;
+		bool PerInstance; // Advances once per instance instead of once per vertex (attribute divisor 1)
 
 
 		VertexBufferElement() = default;
 
-		VertexBufferElement(ShaderDataType type, const std::string& name, bool normalized = false)
-			: Name(name), Type(type), Size(GetShaderDataTypeSize(type)), Offset(0), Normalized(normalized)
+		VertexBufferElement(ShaderDataType type, const std::string& name, bool normalized = false, bool perInstance = false)
+			: Name(name), Type(type), Size(GetShaderDataTypeSize(type)), Offset(0), Normalized(normalized), PerInstance(perInstance)
 		{
 
 		}
@@ -71,6 +72,17 @@ namespace OpenGLRendering {
 			OGL_ASSERT(false, "Unknown ShaderDataType");
 			return 0;
 		}
+
+		// Matrices occupy one attribute location per column
+		uint32_t GetLocationCount() const
+		{
+			switch (Type)
+			{
+				case ShaderDataType::Mat3:		return 3;
+				case ShaderDataType::Mat4:		return 4;
+				default:						return 1;
+			}
+		}
 	};
 
 	class VertexBufferLayout
@@ -120,12 +132,17 @@ namespace OpenGLRendering {
 		void Bind() const;
 		void Unbind() const;
 
-		void SetData(const void* data, uint32_t size);
+		void SetData(const void* data, uint32_t size, uint32_t offset = 0); // Offset in bytes
+		void Resize(uint32_t size); // Reallocates the storage (contents are lost), attachments to vertex arrays stay valid
 		const VertexBufferLayout& GetLayout() const { return m_Layout; }
 		void SetLayout(const VertexBufferLayout& layout) { m_Layout = layout; }
 
+		uint32_t GetSize() const { return m_Size; }
+		uint32_t GetRendererID() const { return m_RendererID; }
+
 	private:
 		uint32_t m_RendererID;
+		uint32_t m_Size;
 		VertexBufferLayout m_Layout;
 	};
 
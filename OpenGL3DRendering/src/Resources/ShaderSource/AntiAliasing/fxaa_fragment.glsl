@@ -0,0 +1,142 @@
+#version 450 core
+
+// FXAA 3.11 quality preset: finds the edge through the centre pixel, walks along it to both ends
+// and shifts the sample position towards the other side of the edge depending on the distance to the closer end
+
+layout(location = 0) out vec4 color;
+
+in vec2 v_TexCoords;
+
+layout(binding = 0) uniform sampler2D u_Frame;
+
+const float c_EdgeThresholdMin = 0.0312;
+const float c_EdgeThreshold = 0.125;
+const float c_SubpixelQuality = 0.75;
+const int c_SearchSteps = 12;
+const float c_SearchStepSizes[c_SearchSteps] = float[](1.0, 1.0, 1.0, 1.0, 1.0, 1.5, 2.0, 2.0, 2.0, 2.0, 4.0, 8.0);
+
+// The frame is tonemapped and gamma corrected already, so this is perceptual luma
+float Luma(vec3 rgb)
+{
+	return dot(rgb, vec3(0.299, 0.587, 0.114));
+}
+
+float LumaAt(vec2 texCoords)
+{
+	return Luma(textureLod(u_Frame, texCoords, 0.0).rgb);
+}
+
+void main()
+{
+	vec2 texelSize = 1.0 / vec2(textureSize(u_Frame, 0));
+
+	vec4 center = textureLod(u_Frame, v_TexCoords, 0.0);
+	float lumaCenter = Luma(center.rgb);
+	float lumaDown = Luma(textureLodOffset(u_Frame, v_TexCoords, 0.0, ivec2(0, -1)).rgb);
+	float lumaUp = Luma(textureLodOffset(u_Frame, v_TexCoords, 0.0, ivec2(0, 1)).rgb);
+	float lumaLeft = Luma(textureLodOffset(u_Frame, v_TexCoords, 0.0, ivec2(-1, 0)).rgb);
+	float lumaRight = Luma(textureLodOffset(u_Frame, v_TexCoords, 0.0, ivec2(1, 0)).rgb);
+
+	// Low contrast areas are left alone, that's most of the image
+	float lumaMin = min(lumaCenter, min(min(lumaDown, lumaUp), min(lumaLeft, lumaRight)));
+	float lumaMax = max(lumaCenter, max(max(lumaDown, lumaUp), max(lumaLeft, lumaRight)));
+	float lumaRange = lumaMax - lumaMin;
+	if (lumaRange < max(c_EdgeThresholdMin, lumaMax * c_EdgeThreshold))
+	{
+		color = center;
+		return;
+	}
+
+	float lumaDownLeft = Luma(textureLodOffset(u_Frame, v_TexCoords, 0.0, ivec2(-1, -1)).rgb);
+	float lumaUpRight = Luma(textureLodOffset(u_Frame, v_TexCoords, 0.0, ivec2(1, 1)).rgb);
+	float lumaUpLeft = Luma(textureLodOffset(u_Frame, v_TexCoords, 0.0, ivec2(-1, 1)).rgb);
+	float lumaDownRight = Luma(textureLodOffset(u_Frame, v_TexCoords, 0.0, ivec2(1, -1)).rgb);
+
+	float lumaDownUp = lumaDown + lumaUp;
+	float lumaLeftRight = lumaLeft + lumaRight;
+	float lumaLeftCorners = lumaDownLeft + lumaUpLeft;
+	float lumaDownCorners = lumaDownLeft + lumaDownRight;
+	float lumaRightCorners = lumaDownRight + lumaUpRight;
+	float lumaUpCorners = lumaUpRight + lumaUpLeft;
+
+	float edgeHorizontal = abs(-2.0 * lumaLeft + lumaLeftCorners) + abs(-2.0 * lumaCenter + lumaDownUp) * 2.0 + abs(-2.0 * lumaRight + lumaRightCorners);
+	float edgeVertical = abs(-2.0 * lumaUp + lumaUpCorners) + abs(-2.0 * lumaCenter + lumaLeftRight) * 2.0 + abs(-2.0 * lumaDown + lumaDownCorners);
+	bool horizontal = edgeHorizontal >= edgeVertical;
+
+	// The edge lies on the side with the larger gradient
+	float luma1 = horizontal ? lumaDown : lumaLeft;
+	float luma2 = horizontal ? lumaUp : lumaRight;
+	float gradient1 = luma1 - lumaCenter;
+	float gradient2 = luma2 - lumaCenter;
+	bool steepest1 = abs(gradient1) >= abs(gradient2);
+	float gradientScaled = 0.25 * max(abs(gradient1), abs(gradient2));
+
+	float stepLength = horizontal ? texelSize.y : texelSize.x;
+	float lumaLocalAverage;
+	if (steepest1)
+	{
+		stepLength = -stepLength;
+		lumaLocalAverage = 0.5 * (luma1 + lumaCenter);
+	}
+	else
+	{
+		lumaLocalAverage = 0.5 * (luma2 + lumaCenter);
+	}
+
+	vec2 edgeCoords = v_TexCoords;
+	if (horizontal)
+		edgeCoords.y += stepLength * 0.5;
+	else
+		edgeCoords.x += stepLength * 0.5;
+
+	// Walk along the edge in both directions until the luma differs from the edge average
+	vec2 offset = horizontal ? vec2(texelSize.x, 0.0) : vec2(0.0, texelSize.y);
+	vec2 coords1 = edgeCoords - offset * c_SearchStepSizes[0];
+	vec2 coords2 = edgeCoords + offset * c_SearchStepSizes[0];
+	float lumaEnd1 = LumaAt(coords1) - lumaLocalAverage;
+	float lumaEnd2 = LumaAt(coords2) - lumaLocalAverage;
+	bool reached1 = abs(lumaEnd1) >= gradientScaled;
+	bool reached2 = abs(lumaEnd2) >= gradientScaled;
+
+	for (int i = 1; i < c_SearchSteps && !(reached1 && reached2); i++)
+	{
+		if (!reached1)
+		{
+			coords1 -= offset * c_SearchStepSizes[i];
+			lumaEnd1 = LumaAt(coords1) - lumaLocalAverage;
+			reached1 = abs(lumaEnd1) >= gradientScaled;
+		}
+
+		if (!reached2)
+		{
+			coords2 += offset * c_SearchStepSizes[i];
+			lumaEnd2 = LumaAt(coords2) - lumaLocalAverage;
+			reached2 = abs(lumaEnd2) >= gradientScaled;
+		}
+	}
+
+	float distance1 = horizontal ? v_TexCoords.x - coords1.x : v_TexCoords.y - coords1.y;
+	float distance2 = horizontal ? coords2.x - v_TexCoords.x : coords2.y - v_TexCoords.y;
+	bool closer1 = distance1 < distance2;
+	float edgeLength = distance1 + distance2;
+	float pixelOffset = 0.5 - min(distance1, distance2) / edgeLength;
+
+	// Only shift if the luma at the closer end varies in the opposite direction of the centre
+	bool centerSmaller = lumaCenter < lumaLocalAverage;
+	bool correctVariation = ((closer1 ? lumaEnd1 : lumaEnd2) < 0.0) != centerSmaller;
+	float finalOffset = correctVariation ? pixelOffset : 0.0;
+
+	// Sub-pixel aliasing: thin features that differ from the whole neighbourhood
+	float lumaAverage = (1.0 / 12.0) * (2.0 * (lumaDownUp + lumaLeftRight) + lumaLeftCorners + lumaRightCorners);
+	float subpixel = clamp(abs(lumaAverage - lumaCenter) / lumaRange, 0.0, 1.0);
+	subpixel = (-2.0 * subpixel + 3.0) * subpixel * subpixel;
+	finalOffset = max(finalOffset, subpixel * subpixel * c_SubpixelQuality);
+
+	vec2 finalCoords = v_TexCoords;
+	if (horizontal)
+		finalCoords.y += finalOffset * stepLength;
+	else
+		finalCoords.x += finalOffset * stepLength;
+
+	color = vec4(textureLod(u_Frame, finalCoords, 0.0).rgb, center.a);
+}
@@ -0,0 +1,42 @@
+#version 450 core
+
+// SMAA 1x neighbourhood blending: every pixel mixes with its neighbours by the weights of the four edges around it
+
+layout(location = 0) out vec4 color;
+
+in vec2 v_TexCoords;
+
+layout(binding = 0) uniform sampler2D u_Frame;
+layout(binding = 1) uniform sampler2D u_Weights;
+
+void main()
+{
+	ivec2 pixel = ivec2(gl_FragCoord.xy);
+	ivec2 maxPixel = textureSize(u_Frame, 0) - 1;
+
+	// Edges with the pixels above and to the right are stored by those pixels
+	vec4 weights = texelFetch(u_Weights, pixel, 0);
+	float down = weights.r;
+	float left = weights.b;
+	float up = pixel.y < maxPixel.y ? texelFetch(u_Weights, pixel + ivec2(0, 1), 0).g : 0.0;
+	float right = pixel.x < maxPixel.x ? texelFetch(u_Weights, pixel + ivec2(1, 0), 0).a : 0.0;
+
+	vec4 center = texelFetch(u_Frame, pixel, 0);
+	float total = down + up + left + right;
+	if (total == 0.0)
+	{
+		color = center;
+		return;
+	}
+
+	// Corners can collect more than full coverage from crossing edges
+	float scale = 1.0 / max(total, 1.0);
+
+	vec4 result = center * (1.0 - total * scale);
+	result += texelFetch(u_Frame, max(pixel - ivec2(0, 1), ivec2(0)), 0) * down * scale;
+	result += texelFetch(u_Frame, min(pixel + ivec2(0, 1), maxPixel), 0) * up * scale;
+	result += texelFetch(u_Frame, max(pixel - ivec2(1, 0), ivec2(0)), 0) * left * scale;
+	result += texelFetch(u_Frame, min(pixel + ivec2(1, 0), maxPixel), 0) * right * scale;
+
+	color = result;
+}
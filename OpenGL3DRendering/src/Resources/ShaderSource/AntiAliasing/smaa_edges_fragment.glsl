@@ -0,0 +1,53 @@
+#version 450 core
+
+// SMAA 1x edge detection: luma edges with the left and the bottom neighbour
+// Local contrast adaptation drops edges next to a much stronger one, they would only blur the strong edge
+
+layout(location = 0) out vec4 edges; // r: edge with the left neighbour, g: edge with the bottom neighbour
+
+in vec2 v_TexCoords;
+
+layout(binding = 0) uniform sampler2D u_Frame;
+
+const float c_Threshold = 0.1;
+const float c_LocalContrastFactor = 2.0;
+
+ivec2 g_Pixel;
+ivec2 g_MaxPixel;
+
+// The frame is tonemapped and gamma corrected already, so this is perceptual luma
+float LumaAt(ivec2 offset)
+{
+	vec3 rgb = texelFetch(u_Frame, clamp(g_Pixel + offset, ivec2(0), g_MaxPixel), 0).rgb;
+	return dot(rgb, vec3(0.299, 0.587, 0.114));
+}
+
+void main()
+{
+	g_Pixel = ivec2(gl_FragCoord.xy);
+	g_MaxPixel = textureSize(u_Frame, 0) - 1;
+
+	float luma = LumaAt(ivec2(0, 0));
+	float lumaLeft = LumaAt(ivec2(-1, 0));
+	float lumaBottom = LumaAt(ivec2(0, -1));
+
+	vec2 delta = abs(luma - vec2(lumaLeft, lumaBottom));
+	vec2 edge = step(c_Threshold, delta);
+
+	// The target isn't cleared, pixels without edges have to be written as well
+	if (edge.x + edge.y == 0.0)
+	{
+		edges = vec4(0.0);
+		return;
+	}
+
+	float deltaRight = abs(luma - LumaAt(ivec2(1, 0)));
+	float deltaTop = abs(luma - LumaAt(ivec2(0, 1)));
+	float deltaLeftLeft = abs(lumaLeft - LumaAt(ivec2(-2, 0)));
+	float deltaBottomBottom = abs(lumaBottom - LumaAt(ivec2(0, -2)));
+
+	float maxDelta = max(max(max(delta.x, delta.y), max(deltaRight, deltaTop)), max(deltaLeftLeft, deltaBottomBottom));
+	edge *= step(maxDelta, c_LocalContrastFactor * delta);
+
+	edges = vec4(edge, 0.0, 0.0);
+}
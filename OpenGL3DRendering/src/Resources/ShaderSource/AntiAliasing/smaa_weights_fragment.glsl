@@ -0,0 +1,93 @@
+#version 450 core
+
+// SMAA 1x blending weights: every edge is followed to both of its ends, the crossing edges at the ends give the shape
+// of the silhouette (L, Z or U) and the line that separates the two sides. Its coverage of the pixel is computed
+// analytically in place of the precomputed area texture of the reference implementation
+
+layout(location = 0) out vec4 weights; // r: this pixel with the one below, g: the one below with this pixel, b: this pixel with the left one, a: the left one with this pixel
+
+in vec2 v_TexCoords;
+
+layout(binding = 0) uniform sampler2D u_Edges; // r: edge with the left neighbour, g: edge with the bottom neighbour
+
+const int c_MaxSearchSteps = 16;
+
+ivec2 g_Size;
+
+bool Edge(ivec2 pixel, int channel)
+{
+	if (any(lessThan(pixel, ivec2(0))) || any(greaterThanEqual(pixel, g_Size)))
+		return false;
+
+	return texelFetch(u_Edges, pixel, 0)[channel] > 0.5;
+}
+
+// Number of pixels the edge continues in the direction
+int Search(ivec2 pixel, ivec2 direction, int channel)
+{
+	int distance = 0;
+	while (distance < c_MaxSearchSteps && Edge(pixel + direction * (distance + 1), channel))
+		distance++;
+
+	return distance;
+}
+
+// Crossing edge at an end: 0.5 if the other side reaches into the row (column) of the pixel, -0.5 if the pixel's side reaches over, 0 for none or both
+float Crossing(bool ownSide, bool otherSide)
+{
+	return ownSide == otherSide ? 0.0 : (ownSide ? 0.5 : -0.5);
+}
+
+// The separating line starts at height1 at one end, passes through the middle of the edge and ends at height2
+// Returns the area above and below the edge that the line covers within [start, start + 1]
+vec2 Coverage(float start, float edgeLength, float height1, float height2)
+{
+	float center = 0.5 * edgeLength;
+	vec2 coverage = vec2(0.0);
+
+	for (int i = 0; i < 4; i++)
+	{
+		float x = start + (float(i) + 0.5) * 0.25;
+		float height = x < center ? height1 * (1.0 - x / center) : height2 * (x - center) / (edgeLength - center);
+		coverage += vec2(max(height, 0.0), max(-height, 0.0));
+	}
+
+	return coverage * 0.25;
+}
+
+void main()
+{
+	g_Size = textureSize(u_Edges, 0);
+	ivec2 pixel = ivec2(gl_FragCoord.xy);
+	vec2 edges = texelFetch(u_Edges, pixel, 0).rg;
+
+	weights = vec4(0.0);
+
+	// Horizontal edge with the pixel below, followed to the left and right
+	if (edges.g > 0.5)
+	{
+		int left = Search(pixel, ivec2(-1, 0), 1);
+		int right = Search(pixel, ivec2(1, 0), 1);
+
+		ivec2 leftEnd = pixel - ivec2(left, 0);
+		ivec2 rightEnd = pixel + ivec2(right, 0);
+		float height1 = Crossing(Edge(leftEnd, 0), Edge(leftEnd + ivec2(0, -1), 0));
+		float height2 = Crossing(Edge(rightEnd + ivec2(1, 0), 0), Edge(rightEnd + ivec2(1, -1), 0));
+
+		weights.rg = Coverage(float(left), float(left + right + 1), height1, height2);
+	}
+
+	// Vertical edge with the pixel to the left, followed down and up
+	if (edges.r > 0.5)
+	{
+		int down = Search(pixel, ivec2(0, -1), 0);
+		int up = Search(pixel, ivec2(0, 1), 0);
+
+		ivec2 bottomEnd = pixel - ivec2(0, down);
+		ivec2 topEnd = pixel + ivec2(0, up);
+		float height1 = Crossing(Edge(bottomEnd, 1), Edge(bottomEnd + ivec2(-1, 0), 1));
+		float height2 = Crossing(Edge(topEnd + ivec2(0, 1), 1), Edge(topEnd + ivec2(-1, 1), 1));
+
+		weights.ba = Coverage(float(down), float(down + up + 1), height1, height2);
+	}
+}
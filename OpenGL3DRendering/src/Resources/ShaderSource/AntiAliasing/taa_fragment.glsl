@@ -0,0 +1,46 @@
+#version 450 core
+
+// TAA resolve: the history is reprojected with the depth of the pixel and clamped to the colour range of the current
+// neighbourhood, which rejects most of the history that isn't valid anymore (disocclusion, moving objects)
+
+layout(location = 0) out vec4 color;
+
+in vec2 v_TexCoords;
+
+layout(binding = 0) uniform sampler2D u_Frame;
+layout(binding = 1) uniform sampler2D u_Depth;
+layout(binding = 2) uniform sampler2D u_History;
+
+uniform mat4 u_Reprojection; // Clip space of this frame to clip space of the last frame
+uniform float u_HistoryWeight;
+uniform vec2 u_RenderScale; // Rendered size / output size, the depth only covers the rendered part
+
+void main()
+{
+	ivec2 pixel = ivec2(gl_FragCoord.xy);
+	ivec2 maxPixel = textureSize(u_Frame, 0) - 1;
+
+	vec3 current = texelFetch(u_Frame, pixel, 0).rgb;
+	vec3 neighbourhoodMin = current;
+	vec3 neighbourhoodMax = current;
+	for (int y = -1; y <= 1; y++)
+	{
+		for (int x = -1; x <= 1; x++)
+		{
+			vec3 neighbour = texelFetch(u_Frame, clamp(pixel + ivec2(x, y), ivec2(0), maxPixel), 0).rgb;
+			neighbourhoodMin = min(neighbourhoodMin, neighbour);
+			neighbourhoodMax = max(neighbourhoodMax, neighbour);
+		}
+	}
+
+	float depth = texelFetch(u_Depth, ivec2(gl_FragCoord.xy * u_RenderScale), 0).r;
+	vec4 previous = u_Reprojection * vec4(v_TexCoords * 2.0 - 1.0, depth * 2.0 - 1.0, 1.0);
+	vec2 previousCoords = previous.xy / previous.w * 0.5 + 0.5;
+
+	float weight = u_HistoryWeight;
+	if (any(lessThan(previousCoords, vec2(0.0))) || any(greaterThan(previousCoords, vec2(1.0))))
+		weight = 0.0;
+
+	vec3 history = clamp(textureLod(u_History, previousCoords, 0.0).rgb, neighbourhoodMin, neighbourhoodMax);
+	color = vec4(mix(current, history, weight), 1.0);
+}
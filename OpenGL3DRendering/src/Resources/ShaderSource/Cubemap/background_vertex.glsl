@@ -1,9 +1,22 @@
-#version 330 core
+#version 450 core
 
 layout(location = 0) in vec3 a_Position;
 
-uniform mat4 u_Projection;
-uniform mat4 u_View;
+layout(std140, binding = 0) uniform FrameData
+{
+	mat4 u_View;
+	mat4 u_Projection;
+	mat4 u_ViewProjection;
+	vec4 u_CameraPos;
+	vec4 u_LightPos;
+	vec4 u_LightColor;
+	vec4 u_ViewportSize;
+	vec4 u_EnvironmentParams;
+	uvec4 u_LightCounts; // x: lights
+	mat4 u_InverseViewProjection;
+	uvec4 u_ClusterCounts; // xyz: tiles x, tiles y, depth slices
+	vec4 u_ClusterParams; // Depth slice = log(view depth) * x + y
+};
 
 out vec3 v_WorldPos;
 
@@ -0,0 +1,269 @@
+#version 450 core
+
+// Deferred path: image based ambient light and the main light of every G-buffer pixel, the point and spot lights are added by their light volumes
+
+layout(location = 0) out vec4 color;
+
+in vec2 v_TexCoords;
+
+layout(binding = 1) uniform samplerCube u_PrefilterMap;
+layout(binding = 2) uniform sampler2D u_BrdfLutTexture;
+layout(binding = 3) uniform sampler2D u_GBufferAlbedo;
+layout(binding = 4) uniform sampler2D u_GBufferNormal;
+layout(binding = 5) uniform sampler2D u_GBufferDepth;
+layout(binding = 6) uniform sampler2D u_GBufferMetallic;
+
+layout(std140, binding = 0) uniform FrameData
+{
+	mat4 u_View;
+	mat4 u_Projection;
+	mat4 u_ViewProjection;
+	vec4 u_CameraPos;
+	vec4 u_LightPos;
+	vec4 u_LightColor;
+	vec4 u_ViewportSize;
+	vec4 u_EnvironmentParams;
+	uvec4 u_LightCounts; // x: lights
+	mat4 u_InverseViewProjection;
+	uvec4 u_ClusterCounts; // xyz: tiles x, tiles y, depth slices
+	vec4 u_ClusterParams; // Depth slice = log(view depth) * x + y
+};
+
+// Sun and shadow views, the matrices map world positions to texture coordinates and depth of their atlas tile
+layout(std140, binding = 1) uniform ShadowData
+{
+	mat4 u_CascadeMatrices[4];
+	vec4 u_CascadeRects[4]; // Tile in texture coordinates, xy: min, zw: max
+	vec4 u_CascadeSplits; // View depth where every cascade ends
+	vec4 u_CascadeTexelSizes; // World size of a texel
+	mat4 u_PointShadowMatrices[6]; // Cube faces +X, -X, +Y, -Y, +Z, -Z of the main light
+	vec4 u_PointShadowRects[6];
+	vec4 u_SunDirection; // xyz: towards the sun
+	vec4 u_SunColor;
+	vec4 u_ShadowParams; // x: cascades (0: no sun shadows), y: point light shadows, z: normal offset in texels, w: 2 / cube face size
+};
+
+layout(binding = 7) uniform sampler2DShadow u_ShadowAtlas;
+
+// Spherical harmonics of the environment lighting, convolved with the cosine lobe and divided by pi
+layout(std140, binding = 2) uniform EnvironmentData
+{
+	vec4 u_IrradianceSH[9]; // rgb
+};
+
+const float PI = 3.14159265359;
+
+struct Surface
+{
+	vec3 Position;
+	vec3 Normal;
+	vec3 Albedo;
+	float Occlusion;
+	float Roughness;
+	float Metallic;
+};
+
+vec3 DecodeNormal(vec2 encoded)
+{
+	encoded = encoded * 2.0 - 1.0;
+	vec3 n = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+	float fold = clamp(-n.z, 0.0, 1.0);
+	n.xy += vec2(n.x >= 0.0 ? -fold : fold, n.y >= 0.0 ? -fold : fold);
+
+	return normalize(n);
+}
+
+// Decodes the G-buffer at the pixel, false for pixels without geometry
+bool ReadSurface(out Surface surface)
+{
+	ivec2 pixel = ivec2(gl_FragCoord.xy);
+	float depth = texelFetch(u_GBufferDepth, pixel, 0).r;
+	if (depth == 1.0)
+		return false;
+
+	// The viewport only covers the rendered part of the targets, u_ViewportSize is its size
+	vec4 ndc = vec4(gl_FragCoord.xy * u_ViewportSize.zw * 2.0 - 1.0, depth * 2.0 - 1.0, 1.0);
+	vec4 world = u_InverseViewProjection * ndc;
+	surface.Position = world.xyz / world.w;
+
+	vec4 albedoOcclusion = texelFetch(u_GBufferAlbedo, pixel, 0);
+	vec4 normalRoughness = texelFetch(u_GBufferNormal, pixel, 0);
+	surface.Albedo = albedoOcclusion.rgb * albedoOcclusion.rgb;
+	surface.Occlusion = albedoOcclusion.a;
+	surface.Normal = DecodeNormal(normalRoughness.rg);
+	surface.Roughness = normalRoughness.b;
+	surface.Metallic = texelFetch(u_GBufferMetallic, pixel, 0).r;
+
+	return true;
+}
+
+float DistributionGGX(vec3 N, vec3 H, float roughness)
+{
+	float a = roughness * roughness;
+	float a2 = a * a;
+	float NdotH = max(dot(N, H), 0.0);
+	float NdotH2 = NdotH * NdotH;
+
+	float denom = (NdotH2 * (a2 - 1.0) + 1.0);
+	denom = PI * denom * denom;
+
+	return a2 / denom;
+}
+
+float GeometrySchlickGGX(float NdotV, float roughness)
+{
+	float r = roughness + 1.0;
+	float k = (r * r) / 8.0;
+
+	float denom = NdotV * (1.0 - k) + k;
+
+	return NdotV / denom;
+}
+
+float GeometrySmith(vec3 N, vec3 V, vec3 L, float roughness)
+{
+	float NdotV = max(dot(N, V), 0.0);
+	float NdotL = max(dot(N, L), 0.0);
+	float ggx1 = GeometrySchlickGGX(NdotV, roughness);
+	float ggx2 = GeometrySchlickGGX(NdotL, roughness);
+
+	return ggx1 * ggx2;
+}
+
+vec3 FresnelSchlickRoughness(float cosTheta, vec3 F0, float roughness)
+{
+	return F0 + (max(vec3(1.0 - roughness), F0) - F0) * pow(clamp(1.0 - cosTheta, 0.0, 1.0), 5.0);
+}
+
+vec3 FresnelSchlick(float cosTheta, vec3 F0)
+{
+	return F0 + (1.0 - F0) * pow(clamp(1.0 - cosTheta, 0.0, 1.0), 5.0);
+}
+
+// Diffuse irradiance / pi of the environment around the normal
+vec3 EvaluateIrradianceSH(vec3 n)
+{
+	vec3 irradiance = u_IrradianceSH[0].rgb * 0.282095
+		+ u_IrradianceSH[1].rgb * (0.488603 * n.y)
+		+ u_IrradianceSH[2].rgb * (0.488603 * n.z)
+		+ u_IrradianceSH[3].rgb * (0.488603 * n.x)
+		+ u_IrradianceSH[4].rgb * (1.092548 * n.x * n.y)
+		+ u_IrradianceSH[5].rgb * (1.092548 * n.y * n.z)
+		+ u_IrradianceSH[6].rgb * (0.315392 * (3.0 * n.z * n.z - 1.0))
+		+ u_IrradianceSH[7].rgb * (1.092548 * n.x * n.z)
+		+ u_IrradianceSH[8].rgb * (0.546274 * (n.x * n.x - n.y * n.y));
+
+	// The truncated series rings slightly negative opposite of bright lights
+	return max(irradiance, vec3(0.0));
+}
+
+// Direct light of one source, radiance is the attenuated light colour
+vec3 EvaluateLight(vec3 N, vec3 V, vec3 L, vec3 radiance, vec3 albedo, float metallic, float roughness, vec3 F0)
+{
+	vec3 H = normalize(V + L);
+
+	float NDF = DistributionGGX(N, H, roughness);
+	float G = GeometrySmith(N, V, L, roughness);
+	vec3 F = FresnelSchlick(max(dot(H, V), 0.0), F0);
+
+	vec3 nominator = NDF * G * F;
+	float denominator = 4 * max(dot(N, V), 0.0) * max(dot(N, L), 0.0) + 0.001;
+	vec3 specular = nominator / denominator;
+
+	vec3 kS = F;
+	vec3 kD = vec3(1.0) - kS;
+	kD *= 1.0 - metallic;
+
+	float NdotL = max(dot(N, L), 0.0);
+	return (kD * albedo / PI + specular) * radiance * NdotL;
+}
+
+// 3x3 taps of hardware filtered comparisons, clamped to the tile so the neighbouring tiles don't bleed in
+float SampleShadowAtlas(vec3 coords, vec4 rect)
+{
+	if (coords.z >= 1.0)
+		return 1.0;
+
+	vec2 texelSize = 1.0 / vec2(textureSize(u_ShadowAtlas, 0));
+	float lit = 0.0;
+	for (int y = -1; y <= 1; y++)
+	{
+		for (int x = -1; x <= 1; x++)
+		{
+			vec2 uv = clamp(coords.xy + vec2(x, y) * texelSize, rect.xy, rect.zw);
+			lit += texture(u_ShadowAtlas, vec3(uv, coords.z));
+		}
+	}
+
+	return lit / 9.0;
+}
+
+// The first cascade whose slice contains the position, offset along the normal by the texel size of the cascade
+float GetSunShadow(vec3 position, vec3 normal)
+{
+	float depth = -(u_View * vec4(position, 1.0)).z;
+	for (uint i = 0; i < uint(u_ShadowParams.x); i++)
+	{
+		if (depth < u_CascadeSplits[i])
+		{
+			vec4 coords = u_CascadeMatrices[i] * vec4(position + normal * u_ShadowParams.z * u_CascadeTexelSizes[i], 1.0);
+			return SampleShadowAtlas(coords.xyz / coords.w, u_CascadeRects[i]);
+		}
+	}
+
+	return 1.0;
+}
+
+// The cube face is picked by the major axis of the light to position vector
+float GetPointShadow(vec3 position, vec3 normal)
+{
+	if (u_ShadowParams.y == 0.0)
+		return 1.0;
+
+	vec3 toPosition = position - u_LightPos.xyz;
+	vec3 a = abs(toPosition);
+	uint face = a.x >= a.y && a.x >= a.z ? (toPosition.x >= 0.0 ? 0u : 1u) : a.y >= a.z ? (toPosition.y >= 0.0 ? 2u : 3u) : (toPosition.z >= 0.0 ? 4u : 5u);
+
+	float texelSize = max(a.x, max(a.y, a.z)) * u_ShadowParams.w;
+	vec4 coords = u_PointShadowMatrices[face] * vec4(position + normal * u_ShadowParams.z * texelSize, 1.0);
+	return SampleShadowAtlas(coords.xyz / coords.w, u_PointShadowRects[face]);
+}
+
+void main()
+{
+	Surface surface;
+	if (!ReadSurface(surface))
+	{
+		// The skybox is drawn over the empty pixels
+		color = vec4(0.0, 0.0, 0.0, 1.0);
+		return;
+	}
+
+	vec3 N = surface.Normal;
+	vec3 V = normalize(u_CameraPos.xyz - surface.Position);
+	vec3 R = reflect(-V, N);
+
+	vec3 F0 = vec3(0.04);
+	F0 = mix(F0, surface.Albedo, surface.Metallic);
+
+	vec3 L = normalize(u_LightPos.xyz - surface.Position);
+	float distance = length(u_LightPos.xyz - surface.Position) / 3.0;
+	float attenuation = 1.0 / (distance * distance);
+	vec3 Lo = EvaluateLight(N, V, L, u_LightColor.rgb * attenuation * GetPointShadow(surface.Position, N), surface.Albedo, surface.Metallic, surface.Roughness, F0);
+	Lo += EvaluateLight(N, V, u_SunDirection.xyz, u_SunColor.rgb * GetSunShadow(surface.Position, N), surface.Albedo, surface.Metallic, surface.Roughness, F0);
+
+	// ambient
+	vec3 F = FresnelSchlickRoughness(max(dot(N, V), 0.0), F0, surface.Roughness);
+	vec3 kD = (1.0 - F) * (1.0 - surface.Metallic);
+	vec3 irradiance = EvaluateIrradianceSH(N);
+	vec3 diffuse = irradiance * surface.Albedo;
+
+	float maxReflectionLod = u_EnvironmentParams.x;
+	vec3 prefilteredColor = textureLod(u_PrefilterMap, R, surface.Roughness * maxReflectionLod).rgb;
+	vec2 brdf = texture(u_BrdfLutTexture, vec2(max(dot(N, V), 0.0), surface.Roughness)).rg;
+	vec3 specular = prefilteredColor * (F * brdf.x + brdf.y);
+
+	vec3 ambient = (kD * diffuse + specular) * surface.Occlusion;
+
+	color = vec4(ambient + Lo, 1.0);
+}
@@ -0,0 +1,187 @@
+#version 450 core
+
+// Adds one deferred light to the lit G-buffer pixels inside its screen rectangle (additive blending)
+
+layout(location = 0) out vec4 color;
+
+flat in int v_LightIndex;
+
+layout(binding = 3) uniform sampler2D u_GBufferAlbedo;
+layout(binding = 4) uniform sampler2D u_GBufferNormal;
+layout(binding = 5) uniform sampler2D u_GBufferDepth;
+layout(binding = 6) uniform sampler2D u_GBufferMetallic;
+
+layout(std140, binding = 0) uniform FrameData
+{
+	mat4 u_View;
+	mat4 u_Projection;
+	mat4 u_ViewProjection;
+	vec4 u_CameraPos;
+	vec4 u_LightPos;
+	vec4 u_LightColor;
+	vec4 u_ViewportSize;
+	vec4 u_EnvironmentParams;
+	uvec4 u_LightCounts; // x: lights
+	mat4 u_InverseViewProjection;
+	uvec4 u_ClusterCounts; // xyz: tiles x, tiles y, depth slices
+	vec4 u_ClusterParams; // Depth slice = log(view depth) * x + y
+};
+
+// Point and spot lights, point lights have a spot scale of 0 and an offset of 1
+struct LightData
+{
+	vec4 PositionRadius; // xyz: world position, w: radius
+	vec4 Color; // rgb: colour, w: spot offset
+	vec4 Direction; // xyz: spot direction, w: spot scale
+};
+
+layout(std430, binding = 1) readonly buffer Lights
+{
+	LightData u_Lights[];
+};
+
+const float PI = 3.14159265359;
+
+struct Surface
+{
+	vec3 Position;
+	vec3 Normal;
+	vec3 Albedo;
+	float Occlusion;
+	float Roughness;
+	float Metallic;
+};
+
+vec3 DecodeNormal(vec2 encoded)
+{
+	encoded = encoded * 2.0 - 1.0;
+	vec3 n = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+	float fold = clamp(-n.z, 0.0, 1.0);
+	n.xy += vec2(n.x >= 0.0 ? -fold : fold, n.y >= 0.0 ? -fold : fold);
+
+	return normalize(n);
+}
+
+// Decodes the G-buffer at the pixel, false for pixels without geometry
+bool ReadSurface(out Surface surface)
+{
+	ivec2 pixel = ivec2(gl_FragCoord.xy);
+	float depth = texelFetch(u_GBufferDepth, pixel, 0).r;
+	if (depth == 1.0)
+		return false;
+
+	// The viewport only covers the rendered part of the targets, u_ViewportSize is its size
+	vec4 ndc = vec4(gl_FragCoord.xy * u_ViewportSize.zw * 2.0 - 1.0, depth * 2.0 - 1.0, 1.0);
+	vec4 world = u_InverseViewProjection * ndc;
+	surface.Position = world.xyz / world.w;
+
+	vec4 albedoOcclusion = texelFetch(u_GBufferAlbedo, pixel, 0);
+	vec4 normalRoughness = texelFetch(u_GBufferNormal, pixel, 0);
+	surface.Albedo = albedoOcclusion.rgb * albedoOcclusion.rgb;
+	surface.Occlusion = albedoOcclusion.a;
+	surface.Normal = DecodeNormal(normalRoughness.rg);
+	surface.Roughness = normalRoughness.b;
+	surface.Metallic = texelFetch(u_GBufferMetallic, pixel, 0).r;
+
+	return true;
+}
+
+float DistributionGGX(vec3 N, vec3 H, float roughness)
+{
+	float a = roughness * roughness;
+	float a2 = a * a;
+	float NdotH = max(dot(N, H), 0.0);
+	float NdotH2 = NdotH * NdotH;
+
+	float denom = (NdotH2 * (a2 - 1.0) + 1.0);
+	denom = PI * denom * denom;
+
+	return a2 / denom;
+}
+
+float GeometrySchlickGGX(float NdotV, float roughness)
+{
+	float r = roughness + 1.0;
+	float k = (r * r) / 8.0;
+
+	float denom = NdotV * (1.0 - k) + k;
+
+	return NdotV / denom;
+}
+
+float GeometrySmith(vec3 N, vec3 V, vec3 L, float roughness)
+{
+	float NdotV = max(dot(N, V), 0.0);
+	float NdotL = max(dot(N, L), 0.0);
+	float ggx1 = GeometrySchlickGGX(NdotV, roughness);
+	float ggx2 = GeometrySchlickGGX(NdotL, roughness);
+
+	return ggx1 * ggx2;
+}
+
+vec3 FresnelSchlickRoughness(float cosTheta, vec3 F0, float roughness)
+{
+	return F0 + (max(vec3(1.0 - roughness), F0) - F0) * pow(clamp(1.0 - cosTheta, 0.0, 1.0), 5.0);
+}
+
+vec3 FresnelSchlick(float cosTheta, vec3 F0)
+{
+	return F0 + (1.0 - F0) * pow(clamp(1.0 - cosTheta, 0.0, 1.0), 5.0);
+}
+
+// Direct light of one source, radiance is the attenuated light colour
+vec3 EvaluateLight(vec3 N, vec3 V, vec3 L, vec3 radiance, vec3 albedo, float metallic, float roughness, vec3 F0)
+{
+	vec3 H = normalize(V + L);
+
+	float NDF = DistributionGGX(N, H, roughness);
+	float G = GeometrySmith(N, V, L, roughness);
+	vec3 F = FresnelSchlick(max(dot(H, V), 0.0), F0);
+
+	vec3 nominator = NDF * G * F;
+	float denominator = 4 * max(dot(N, V), 0.0) * max(dot(N, L), 0.0) + 0.001;
+	vec3 specular = nominator / denominator;
+
+	vec3 kS = F;
+	vec3 kD = vec3(1.0) - kS;
+	kD *= 1.0 - metallic;
+
+	float NdotL = max(dot(N, L), 0.0);
+	return (kD * albedo / PI + specular) * radiance * NdotL;
+}
+
+// Inverse square falloff that reaches 0 at the radius of the light
+float LightAttenuation(float distance, float radius)
+{
+	float falloff = clamp(1.0 - pow(distance / radius, 4.0), 0.0, 1.0);
+	return falloff * falloff / (distance * distance + 1.0);
+}
+
+// Radiance of the light at the position, L is the direction towards the light
+vec3 GetLightRadiance(LightData light, vec3 position, out vec3 L)
+{
+	vec3 toLight = light.PositionRadius.xyz - position;
+	float distance = length(toLight);
+	L = toLight / max(distance, 0.0001);
+	if (distance >= light.PositionRadius.w)
+		return vec3(0.0);
+
+	float spot = clamp(dot(-L, light.Direction.xyz) * light.Direction.w + light.Color.w, 0.0, 1.0);
+	return light.Color.rgb * LightAttenuation(distance, light.PositionRadius.w) * spot * spot;
+}
+
+void main()
+{
+	Surface surface;
+	if (!ReadSurface(surface))
+		discard;
+
+	vec3 lightDirection;
+	vec3 radiance = GetLightRadiance(u_Lights[v_LightIndex], surface.Position, lightDirection);
+
+	vec3 N = surface.Normal;
+	vec3 V = normalize(u_CameraPos.xyz - surface.Position);
+	vec3 F0 = mix(vec3(0.04), surface.Albedo, surface.Metallic);
+
+	color = vec4(EvaluateLight(N, V, lightDirection, radiance, surface.Albedo, surface.Metallic, surface.Roughness, F0), 0.0);
+}
@@ -0,0 +1,69 @@
+#version 450 core
+
+// Light volume of a deferred light: the fullscreen quad is shrunk to the screen rectangle that encloses the light sphere,
+// one instance per light, so every pixel only evaluates the lights that can reach it
+
+layout(location = 0) in vec3 a_Position;
+
+layout(std140, binding = 0) uniform FrameData
+{
+	mat4 u_View;
+	mat4 u_Projection;
+	mat4 u_ViewProjection;
+	vec4 u_CameraPos;
+	vec4 u_LightPos;
+	vec4 u_LightColor;
+	vec4 u_ViewportSize;
+	vec4 u_EnvironmentParams;
+	uvec4 u_LightCounts; // x: lights
+	mat4 u_InverseViewProjection;
+	uvec4 u_ClusterCounts; // xyz: tiles x, tiles y, depth slices
+	vec4 u_ClusterParams; // Depth slice = log(view depth) * x + y
+};
+
+// Point and spot lights, point lights have a spot scale of 0 and an offset of 1
+struct LightData
+{
+	vec4 PositionRadius; // xyz: world position, w: radius
+	vec4 Color; // rgb: colour, w: spot offset
+	vec4 Direction; // xyz: spot direction, w: spot scale
+};
+
+layout(std430, binding = 1) readonly buffer Lights
+{
+	LightData u_Lights[];
+};
+
+flat out int v_LightIndex;
+
+void main()
+{
+	v_LightIndex = gl_InstanceID;
+
+	vec4 light = u_Lights[gl_InstanceID].PositionRadius;
+	vec3 center = (u_View * vec4(light.xyz, 1.0)).xyz;
+	float radius = light.w;
+	float nearClip = u_Projection[3][2] / (u_Projection[2][2] - 1.0);
+
+	// A sphere that reaches the near plane may cover any part of the screen
+	vec2 minCorner = vec2(-1.0);
+	vec2 maxCorner = vec2(1.0);
+	if (center.z + radius < -nearClip)
+	{
+		// The projected corners of the view space bounding box enclose the projected sphere
+		minCorner = vec2(1.0);
+		maxCorner = vec2(-1.0);
+		for (int i = 0; i < 8; i++)
+		{
+			vec3 offset = vec3((i & 1) != 0 ? 1.0 : -1.0, (i & 2) != 0 ? 1.0 : -1.0, (i & 4) != 0 ? 1.0 : -1.0);
+			vec4 corner = u_Projection * vec4(center + offset * radius, 1.0);
+			minCorner = min(minCorner, corner.xy / corner.w);
+			maxCorner = max(maxCorner, corner.xy / corner.w);
+		}
+
+		minCorner = max(minCorner, vec2(-1.0));
+		maxCorner = min(maxCorner, vec2(1.0));
+	}
+
+	gl_Position = vec4(mix(minCorner, maxCorner, a_Position.xy * 0.5 + 0.5), 0.0, 1.0);
+}
@@ -0,0 +1,45 @@
+#version 450 core
+
+// G-buffer of the deferred path, the lighting shaders in Deferred decode it
+// 0 (RGBA8): sqrt(albedo), ambient occlusion
+// 1 (RGB10A2): octahedral normal, roughness
+// 2 (R8): metallic
+
+layout(location = 0) out vec4 o_AlbedoOcclusion;
+layout(location = 1) out vec4 o_NormalRoughness;
+layout(location = 2) out float o_Metallic;
+
+in vec3 v_WorldPos;
+in vec3 v_Normal;
+flat in int v_MaterialIndex;
+
+struct MaterialData
+{
+	vec4 Albedo; // rgb: albedo
+	vec4 Params; // x: roughness, y: metallic, z: ambient occlusion
+};
+
+layout(std430, binding = 0) readonly buffer Materials
+{
+	MaterialData u_Materials[];
+};
+
+// Maps the unit sphere onto the [-1, 1] square, the lower hemisphere is folded over the diagonals
+vec2 EncodeNormal(vec3 n)
+{
+	n /= abs(n.x) + abs(n.y) + abs(n.z);
+	if (n.z < 0.0)
+		n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+
+	return n.xy * 0.5 + 0.5;
+}
+
+void main()
+{
+	MaterialData material = u_Materials[v_MaterialIndex];
+
+	// The square root spends the 8 bits where dark albedos need them
+	o_AlbedoOcclusion = vec4(sqrt(material.Albedo.rgb), material.Params.z);
+	o_NormalRoughness = vec4(EncodeNormal(normalize(v_Normal)), material.Params.x, 0.0);
+	o_Metallic = material.Params.y;
+}
@@ -1,22 +1,86 @@
-#version 330 core
+#version 450 core
 
 layout(location = 0) out vec4 color;
 
 in vec3 v_WorldPos;
 in vec3 v_Normal;
+flat in int v_MaterialIndex;
 
-uniform vec3 u_Albedo;
-uniform float u_Roughness;
-uniform float u_Metallic;
-uniform float u_Ambient;
+struct MaterialData
+{
+	vec4 Albedo; // rgb: albedo
+	vec4 Params; // x: roughness, y: metallic, z: ambient occlusion
+};
+
+layout(std430, binding = 0) readonly buffer Materials
+{
+	MaterialData u_Materials[];
+};
+
+layout(binding = 1) uniform samplerCube u_PrefilterMap;
+layout(binding = 2) uniform sampler2D u_BrdfLutTexture;
+
+layout(std140, binding = 0) uniform FrameData
+{
+	mat4 u_View;
+	mat4 u_Projection;
+	mat4 u_ViewProjection;
+	vec4 u_CameraPos;
+	vec4 u_LightPos;
+	vec4 u_LightColor;
+	vec4 u_ViewportSize;
+	vec4 u_EnvironmentParams;
+	uvec4 u_LightCounts; // x: lights
+	mat4 u_InverseViewProjection;
+	uvec4 u_ClusterCounts; // xyz: tiles x, tiles y, depth slices
+	vec4 u_ClusterParams; // Depth slice = log(view depth) * x + y
+};
+
+// Sun and shadow views, the matrices map world positions to texture coordinates and depth of their atlas tile
+layout(std140, binding = 1) uniform ShadowData
+{
+	mat4 u_CascadeMatrices[4];
+	vec4 u_CascadeRects[4]; // Tile in texture coordinates, xy: min, zw: max
+	vec4 u_CascadeSplits; // View depth where every cascade ends
+	vec4 u_CascadeTexelSizes; // World size of a texel
+	mat4 u_PointShadowMatrices[6]; // Cube faces +X, -X, +Y, -Y, +Z, -Z of the main light
+	vec4 u_PointShadowRects[6];
+	vec4 u_SunDirection; // xyz: towards the sun
+	vec4 u_SunColor;
+	vec4 u_ShadowParams; // x: cascades (0: no sun shadows), y: point light shadows, z: normal offset in texels, w: 2 / cube face size
+};
+
+layout(binding = 7) uniform sampler2DShadow u_ShadowAtlas;
 
-uniform samplerCube u_IrradianceMap;
-uniform samplerCube u_PrefilterMap;
-uniform sampler2D u_BrdfLutTexture;
+// Spherical harmonics of the environment lighting, convolved with the cosine lobe and divided by pi
+layout(std140, binding = 2) uniform EnvironmentData
+{
+	vec4 u_IrradianceSH[9]; // rgb
+};
 
-uniform vec3 u_LightPos;
-uniform vec3 u_LightColor;
-uniform vec3 u_CameraPos;
+// Point and spot lights, point lights have a spot scale of 0 and an offset of 1
+struct LightData
+{
+	vec4 PositionRadius; // xyz: world position, w: radius
+	vec4 Color; // rgb: colour, w: spot offset
+	vec4 Direction; // xyz: spot direction, w: spot scale
+};
+
+layout(std430, binding = 1) readonly buffer Lights
+{
+	LightData u_Lights[];
+};
+
+// Lights of every cluster, assigned on the CPU every frame
+layout(std430, binding = 2) readonly buffer LightClusters
+{
+	uvec2 u_ClusterRanges[]; // x: first entry in u_LightIndices, y: light count
+};
+
+layout(std430, binding = 3) readonly buffer LightIndices
+{
+	uint u_LightIndices[];
+};
 
 const float PI = 3.14159265359;
 
@@ -55,36 +119,35 @@ float GeometrySmith(vec3 N, vec3 V, vec3 L, float roughness)
 
 vec3 FresnelSchlickRoughness(float cosTheta, vec3 F0, float roughness)
 {
-	return F0 + (max(vec3(1.0 - roughness), F0) - F0) * pow(1.0 - cosTheta, 5.0);
+	return F0 + (max(vec3(1.0 - roughness), F0) - F0) * pow(clamp(1.0 - cosTheta, 0.0, 1.0), 5.0);
 }
 
 vec3 FresnelSchlick(float cosTheta, vec3 F0)
 {
-	return F0 + (1.0 - F0) * pow(1.0 - cosTheta, 5.0);
+	return F0 + (1.0 - F0) * pow(clamp(1.0 - cosTheta, 0.0, 1.0), 5.0);
 }
 
-void main()
+// Diffuse irradiance / pi of the environment around the normal
+vec3 EvaluateIrradianceSH(vec3 n)
 {
-	vec3 albedo = u_Albedo;
-	float metallic = u_Metallic;
-	float roughness = u_Roughness;
-	float ao = u_Ambient;
+	vec3 irradiance = u_IrradianceSH[0].rgb * 0.282095
+		+ u_IrradianceSH[1].rgb * (0.488603 * n.y)
+		+ u_IrradianceSH[2].rgb * (0.488603 * n.z)
+		+ u_IrradianceSH[3].rgb * (0.488603 * n.x)
+		+ u_IrradianceSH[4].rgb * (1.092548 * n.x * n.y)
+		+ u_IrradianceSH[5].rgb * (1.092548 * n.y * n.z)
+		+ u_IrradianceSH[6].rgb * (0.315392 * (3.0 * n.z * n.z - 1.0))
+		+ u_IrradianceSH[7].rgb * (1.092548 * n.x * n.z)
+		+ u_IrradianceSH[8].rgb * (0.546274 * (n.x * n.x - n.y * n.y));
 
-	vec3 N = v_Normal;
-	vec3 V = normalize(u_CameraPos - v_WorldPos);
-	vec3 R = reflect(-V, N);
-
-	vec3 F0 = vec3(0.04);
-	F0 = mix(F0, albedo, metallic);
-
-	// light sources
-	vec3 Lo = vec3(0.0);
+	// The truncated series rings slightly negative opposite of bright lights
+	return max(irradiance, vec3(0.0));
+}
 
-	vec3 L = normalize(u_LightPos - v_WorldPos);
+// Direct light of one source, radiance is the attenuated light colour
+vec3 EvaluateLight(vec3 N, vec3 V, vec3 L, vec3 radiance, vec3 albedo, float metallic, float roughness, vec3 F0)
+{
 	vec3 H = normalize(V + L);
-	float distance = length(u_LightPos - v_WorldPos) / 3.0;
-	float attenuation = 1.0 / (distance * distance);
-	vec3 radiance = u_LightColor * attenuation;
 
 	float NDF = DistributionGGX(N, H, roughness);
 	float G = GeometrySmith(N, V, L, roughness);
@@ -99,27 +162,140 @@ void main()
 	kD *= 1.0 - metallic;
 
 	float NdotL = max(dot(N, L), 0.0);
-	Lo += (kD * albedo / PI + specular) * radiance * NdotL;
+	return (kD * albedo / PI + specular) * radiance * NdotL;
+}
+
+// Inverse square falloff that reaches 0 at the radius of the light
+float LightAttenuation(float distance, float radius)
+{
+	float falloff = clamp(1.0 - pow(distance / radius, 4.0), 0.0, 1.0);
+	return falloff * falloff / (distance * distance + 1.0);
+}
+
+// Radiance of the light at the position, L is the direction towards the light
+vec3 GetLightRadiance(LightData light, vec3 position, out vec3 L)
+{
+	vec3 toLight = light.PositionRadius.xyz - position;
+	float distance = length(toLight);
+	L = toLight / max(distance, 0.0001);
+	if (distance >= light.PositionRadius.w)
+		return vec3(0.0);
+
+	float spot = clamp(dot(-L, light.Direction.xyz) * light.Direction.w + light.Color.w, 0.0, 1.0);
+	return light.Color.rgb * LightAttenuation(distance, light.PositionRadius.w) * spot * spot;
+}
+
+// Screen tile and exponential depth slice of the fragment
+uint GetClusterIndex(vec3 worldPos)
+{
+	uvec2 tile = min(uvec2(gl_FragCoord.xy * u_ViewportSize.zw * vec2(u_ClusterCounts.xy)), u_ClusterCounts.xy - 1u);
+	float depth = -(u_View * vec4(worldPos, 1.0)).z;
+	uint slice = uint(clamp(log(depth) * u_ClusterParams.x + u_ClusterParams.y, 0.0, float(u_ClusterCounts.z - 1u)));
+
+	return tile.x + u_ClusterCounts.x * (tile.y + u_ClusterCounts.y * slice);
+}
+
+// 3x3 taps of hardware filtered comparisons, clamped to the tile so the neighbouring tiles don't bleed in
+float SampleShadowAtlas(vec3 coords, vec4 rect)
+{
+	if (coords.z >= 1.0)
+		return 1.0;
+
+	vec2 texelSize = 1.0 / vec2(textureSize(u_ShadowAtlas, 0));
+	float lit = 0.0;
+	for (int y = -1; y <= 1; y++)
+	{
+		for (int x = -1; x <= 1; x++)
+		{
+			vec2 uv = clamp(coords.xy + vec2(x, y) * texelSize, rect.xy, rect.zw);
+			lit += texture(u_ShadowAtlas, vec3(uv, coords.z));
+		}
+	}
+
+	return lit / 9.0;
+}
+
+// The first cascade whose slice contains the position, offset along the normal by the texel size of the cascade
+float GetSunShadow(vec3 position, vec3 normal)
+{
+	float depth = -(u_View * vec4(position, 1.0)).z;
+	for (uint i = 0; i < uint(u_ShadowParams.x); i++)
+	{
+		if (depth < u_CascadeSplits[i])
+		{
+			vec4 coords = u_CascadeMatrices[i] * vec4(position + normal * u_ShadowParams.z * u_CascadeTexelSizes[i], 1.0);
+			return SampleShadowAtlas(coords.xyz / coords.w, u_CascadeRects[i]);
+		}
+	}
+
+	return 1.0;
+}
+
+// The cube face is picked by the major axis of the light to position vector
+float GetPointShadow(vec3 position, vec3 normal)
+{
+	if (u_ShadowParams.y == 0.0)
+		return 1.0;
+
+	vec3 toPosition = position - u_LightPos.xyz;
+	vec3 a = abs(toPosition);
+	uint face = a.x >= a.y && a.x >= a.z ? (toPosition.x >= 0.0 ? 0u : 1u) : a.y >= a.z ? (toPosition.y >= 0.0 ? 2u : 3u) : (toPosition.z >= 0.0 ? 4u : 5u);
+
+	float texelSize = max(a.x, max(a.y, a.z)) * u_ShadowParams.w;
+	vec4 coords = u_PointShadowMatrices[face] * vec4(position + normal * u_ShadowParams.z * texelSize, 1.0);
+	return SampleShadowAtlas(coords.xyz / coords.w, u_PointShadowRects[face]);
+}
+
+void main()
+{
+	MaterialData material = u_Materials[v_MaterialIndex];
+	vec3 albedo = material.Albedo.rgb;
+	float roughness = material.Params.x;
+	float metallic = material.Params.y;
+	float ao = material.Params.z;
+
+	vec3 N = v_Normal;
+	vec3 V = normalize(u_CameraPos.xyz - v_WorldPos);
+	vec3 R = reflect(-V, N);
+
+	vec3 F0 = vec3(0.04);
+	F0 = mix(F0, albedo, metallic);
+
+	// light sources
+	vec3 Lo = vec3(0.0);
+
+	vec3 L = normalize(u_LightPos.xyz - v_WorldPos);
+	float distance = length(u_LightPos.xyz - v_WorldPos) / 3.0;
+	float attenuation = 1.0 / (distance * distance);
+	Lo += EvaluateLight(N, V, L, u_LightColor.rgb * attenuation * GetPointShadow(v_WorldPos, normalize(v_Normal)), albedo, metallic, roughness, F0);
+	Lo += EvaluateLight(N, V, u_SunDirection.xyz, u_SunColor.rgb * GetSunShadow(v_WorldPos, normalize(v_Normal)), albedo, metallic, roughness, F0);
+
+	// Only the lights assigned to the cluster of the fragment can reach it
+	uvec2 cluster = u_ClusterRanges[GetClusterIndex(v_WorldPos)];
+	for (uint i = cluster.x; i < cluster.x + cluster.y; i++)
+	{
+		vec3 lightDirection;
+		vec3 radiance = GetLightRadiance(u_Lights[u_LightIndices[i]], v_WorldPos, lightDirection);
+		Lo += EvaluateLight(N, V, lightDirection, radiance, albedo, metallic, roughness, F0);
+	}
 	
 	// ambient
-	F = FresnelSchlickRoughness(max(dot(N, V), 0.0), F0, roughness);
-	kS = F;
-	kD = 1.0 - kS;
+	vec3 F = FresnelSchlickRoughness(max(dot(N, V), 0.0), F0, roughness);
+	vec3 kS = F;
+	vec3 kD = 1.0 - kS;
 	kD *= 1.0 - metallic;
-	vec3 irradiance = texture(u_IrradianceMap, N).rgb;
+	vec3 irradiance = EvaluateIrradianceSH(N);
 	vec3 diffuse = irradiance * albedo;
 
-	const float MAX_REFLECTION_LOD = 4.0;
-	vec3 prefilteredColor = textureLod(u_PrefilterMap, R, roughness * MAX_REFLECTION_LOD).rgb;
+	float maxReflectionLod = u_EnvironmentParams.x;
+	vec3 prefilteredColor = textureLod(u_PrefilterMap, R, roughness * maxReflectionLod).rgb;
 	vec2 brdf = texture(u_BrdfLutTexture, vec2(max(dot(N, V), 0.0), roughness)).rg;
-	specular = prefilteredColor * (F * brdf.x + brdf.y);
+	vec3 specular = prefilteredColor * (F * brdf.x + brdf.y);
 
 	vec3 ambient = (kD * diffuse + specular) * ao;
 
+	// Linear HDR radiance, the tonemap pass maps it to the display once per pixel
 	vec3 col = ambient + Lo;
 
-	col = col / (col + vec3(1.0));
-	col = pow(col, vec3(1.0 / 2.2));
-
 	color = vec4(col, 1.0);
 }
\ No newline at end of file
@@ -0,0 +1,55 @@
+#version 450 core
+
+// G-buffer of the deferred path, see fragment_static_gbuffer.glsl for the layout
+
+layout(location = 0) out vec4 o_AlbedoOcclusion;
+layout(location = 1) out vec4 o_NormalRoughness;
+layout(location = 2) out float o_Metallic;
+
+in vec3 v_WorldPos;
+in vec2 v_TextureCoords;
+in vec3 v_Normal;
+
+layout(binding = 3) uniform sampler2D u_TextureAlbedo;
+layout(binding = 4) uniform sampler2D u_TextureNormal;
+layout(binding = 5) uniform sampler2D u_TextureMetallicSmooth;
+layout(binding = 6) uniform sampler2D u_TextureAmbient;
+
+vec3 GetNormalFromMap()
+{
+	vec3 tangentNormal = texture(u_TextureNormal, v_TextureCoords).xyz * 2.0 - 1.0;
+
+	vec3 q1 = dFdx(v_WorldPos);
+	vec3 q2 = dFdy(v_WorldPos);
+	vec2 st1 = dFdx(v_TextureCoords);
+	vec2 st2 = dFdy(v_TextureCoords);
+
+	vec3 N = normalize(v_Normal);
+	vec3 T = normalize(q1 * st2.t - q2 * st1.t);
+	vec3 B = -normalize(cross(N, T));
+	mat3 TBN = mat3(T, B, N);
+
+	return normalize(TBN * tangentNormal);
+}
+
+// Maps the unit sphere onto the [-1, 1] square, the lower hemisphere is folded over the diagonals
+vec2 EncodeNormal(vec3 n)
+{
+	n /= abs(n.x) + abs(n.y) + abs(n.z);
+	if (n.z < 0.0)
+		n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+
+	return n.xy * 0.5 + 0.5;
+}
+
+void main()
+{
+	// The albedo texture is sRGB, stored as sqrt(linear) like the untextured materials
+	vec3 albedo = pow(texture(u_TextureAlbedo, v_TextureCoords).rgb, vec3(2.2));
+	vec2 metallicSmooth = texture(u_TextureMetallicSmooth, v_TextureCoords).ra;
+	float ao = texture(u_TextureAmbient, v_TextureCoords).r;
+
+	o_AlbedoOcclusion = vec4(sqrt(albedo), ao);
+	o_NormalRoughness = vec4(EncodeNormal(GetNormalFromMap()), 1.0 - metallicSmooth.y, 0.0);
+	o_Metallic = metallicSmooth.x;
+}
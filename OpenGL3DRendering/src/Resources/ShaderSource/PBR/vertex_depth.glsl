@@ -0,0 +1,30 @@
+#version 450 core
+
+layout(location = 0) in vec3 a_Position;
+layout(location = 5) in mat4 a_ModelMatrix; // per instance
+
+layout(std140, binding = 0) uniform FrameData
+{
+	mat4 u_View;
+	mat4 u_Projection;
+	mat4 u_ViewProjection;
+	vec4 u_CameraPos;
+	vec4 u_LightPos;
+	vec4 u_LightColor;
+	vec4 u_ViewportSize;
+	vec4 u_EnvironmentParams;
+	uvec4 u_LightCounts; // x: lights
+	mat4 u_InverseViewProjection;
+	uvec4 u_ClusterCounts; // xyz: tiles x, tiles y, depth slices
+	vec4 u_ClusterParams; // Depth slice = log(view depth) * x + y
+};
+
+// Must match the PBR vertex shaders exactly, the shading pass tests against this depth with GL_EQUAL
+invariant gl_Position;
+
+void main()
+{
+	vec3 worldPos = vec3(a_ModelMatrix * vec4(a_Position, 1.0));
+
+	gl_Position = u_ViewProjection * vec4(worldPos, 1.0);
+}
@@ -1,19 +1,38 @@
-#version 330 core
+#version 450 core
 
 layout(location = 0) in vec3 a_Position;
 layout(location = 1) in vec3 a_Normal;
+layout(location = 5) in mat4 a_ModelMatrix; // per instance
+layout(location = 9) in int a_MaterialIndex; // per instance
 
-uniform mat4 u_View;
-uniform mat4 u_Projection;
-uniform mat4 u_Model;
+layout(std140, binding = 0) uniform FrameData
+{
+	mat4 u_View;
+	mat4 u_Projection;
+	mat4 u_ViewProjection;
+	vec4 u_CameraPos;
+	vec4 u_LightPos;
+	vec4 u_LightColor;
+	vec4 u_ViewportSize;
+	vec4 u_EnvironmentParams;
+	uvec4 u_LightCounts; // x: lights
+	mat4 u_InverseViewProjection;
+	uvec4 u_ClusterCounts; // xyz: tiles x, tiles y, depth slices
+	vec4 u_ClusterParams; // Depth slice = log(view depth) * x + y
+};
+
+// Must match the depth pre-pass shader exactly
+invariant gl_Position;
 
 out vec3 v_WorldPos;
 out vec3 v_Normal;
+flat out int v_MaterialIndex;
 
 void main()
 {
-	v_WorldPos = vec3(u_Model * vec4(a_Position, 1.0));
-	v_Normal = mat3(u_Model) * a_Normal;
+	v_WorldPos = vec3(a_ModelMatrix * vec4(a_Position, 1.0));
+	v_Normal = mat3(a_ModelMatrix) * a_Normal;
+	v_MaterialIndex = a_MaterialIndex;
 
-	gl_Position = u_Projection * u_View * vec4(v_WorldPos, 1.0);
+	gl_Position = u_ViewProjection * vec4(v_WorldPos, 1.0);
 }
\ No newline at end of file
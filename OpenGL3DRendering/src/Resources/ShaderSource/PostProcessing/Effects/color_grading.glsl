@@ -0,0 +1,6 @@
+uniform vec4 u_GradingColor;
+
+vec4 ColorGrading(vec4 color, vec2 texCoords)
+{
+	return color * u_GradingColor;
+}
@@ -0,0 +1,4 @@
+vec4 Invert(vec4 color, vec2 texCoords)
+{
+	return vec4(1.0 - color.rgb, 1.0);
+}
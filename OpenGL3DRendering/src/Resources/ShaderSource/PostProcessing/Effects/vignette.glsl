@@ -0,0 +1,9 @@
+uniform float u_VignetteStrength;
+uniform float u_VignetteRadius;
+
+vec4 Vignette(vec4 color, vec2 texCoords)
+{
+	float distance = length(texCoords - vec2(0.5)) * 1.41421356;
+	float falloff = smoothstep(u_VignetteRadius, 1.0, distance);
+	return vec4(color.rgb * (1.0 - falloff * u_VignetteStrength), color.a);
+}
@@ -0,0 +1,21 @@
+#version 450 core
+
+// Maps the linear HDR scene colour to the display: exposure, Reinhard and gamma correction
+// Pixels are fetched 1:1, so with dynamic resolution only the rendered part of the frame is mapped
+
+layout(location = 0) out vec4 color;
+
+in vec2 v_TexCoords;
+
+layout(binding = 0) uniform sampler2D u_Frame;
+
+uniform float u_Exposure;
+uniform float u_Gamma;
+
+void main()
+{
+	vec3 exposed = texelFetch(u_Frame, ivec2(gl_FragCoord.xy), 0).rgb * u_Exposure;
+	vec3 mapped = exposed / (exposed + vec3(1.0));
+
+	color = vec4(pow(mapped, vec3(1.0 / u_Gamma)), 1.0);
+}
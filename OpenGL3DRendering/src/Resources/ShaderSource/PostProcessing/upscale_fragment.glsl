@@ -0,0 +1,44 @@
+#version 450 core
+
+// Bilinear upscale of the rendered part of the frame to the whole target, followed by contrast adaptive sharpening:
+// a negative lobe on the four neighbours brings back some of the detail the lower resolution lost,
+// it is weakened where the local contrast is high already, so edges don't ring
+
+layout(location = 0) out vec4 color;
+
+in vec2 v_TexCoords;
+
+layout(binding = 0) uniform sampler2D u_Frame;
+
+uniform vec2 u_RenderScale; // Rendered part of the frame texture
+uniform float u_Sharpness; // 0 - 1
+
+vec3 SampleFrame(vec2 texCoords, vec2 minCoords, vec2 maxCoords)
+{
+	// Bilinear taps must not reach the stale texels outside of the rendered part
+	return textureLod(u_Frame, clamp(texCoords, minCoords, maxCoords), 0.0).rgb;
+}
+
+void main()
+{
+	vec2 texelSize = 1.0 / vec2(textureSize(u_Frame, 0));
+	vec2 minCoords = 0.5 * texelSize;
+	vec2 maxCoords = u_RenderScale - 0.5 * texelSize;
+	vec2 texCoords = v_TexCoords * u_RenderScale;
+
+	vec3 center = SampleFrame(texCoords, minCoords, maxCoords);
+	vec3 up = SampleFrame(texCoords + vec2(0.0, texelSize.y), minCoords, maxCoords);
+	vec3 down = SampleFrame(texCoords - vec2(0.0, texelSize.y), minCoords, maxCoords);
+	vec3 left = SampleFrame(texCoords - vec2(texelSize.x, 0.0), minCoords, maxCoords);
+	vec3 right = SampleFrame(texCoords + vec2(texelSize.x, 0.0), minCoords, maxCoords);
+
+	vec3 neighbourhoodMin = min(center, min(min(up, down), min(left, right)));
+	vec3 neighbourhoodMax = max(center, max(max(up, down), max(left, right)));
+
+	// Headroom of the neighbourhood towards black and white, flat areas get the full lobe
+	vec3 amount = sqrt(clamp(min(neighbourhoodMin, 1.0 - neighbourhoodMax) / max(neighbourhoodMax, vec3(0.0001)), 0.0, 1.0));
+	vec3 weight = -amount / mix(8.0, 5.0, u_Sharpness);
+
+	vec3 result = (center + (up + down + left + right) * weight) / (1.0 + 4.0 * weight);
+	color = vec4(clamp(result, 0.0, 1.0), 1.0);
+}
@@ -0,0 +1,12 @@
+#version 450 core
+
+layout(location = 0) in vec3 a_Position;
+layout(location = 5) in mat4 a_ModelMatrix; // per instance
+
+// Cascade or cube face view of the tile that is rendered
+uniform mat4 u_ShadowViewProjection;
+
+void main()
+{
+	gl_Position = u_ShadowViewProjection * a_ModelMatrix * vec4(a_Position, 1.0);
+}
@@ -0,0 +1,99 @@
+#include "oglpch.h"
+
+#include "BoundingVolume.h"
+
+namespace OpenGLRendering {
+
+	void AABB::Merge(const AABB& other)
+	{
+		Min = glm::min(Min, other.Min);
+		Max = glm::max(Max, other.Max);
+	}
+
+	AABB AABB::Transform(const glm::mat4& matrix) const
+	{
+		// Transform the center and project the extents onto the new axes (Arvo)
+		glm::vec3 center = glm::vec3(matrix * glm::vec4(GetCenter(), 1.0f));
+		glm::vec3 extents = GetExtents();
+
+		glm::vec3 newExtents(0.0f);
+		for (int column = 0; column < 3; column++)
+			newExtents += glm::abs(glm::vec3(matrix[column])) * extents[column];
+
+		return { center - newExtents, center + newExtents };
+	}
+
+	BoundingSphere BoundingSphere::Transform(const glm::mat4& matrix) const
+	{
+		float scale = std::max(std::max(glm::length(glm::vec3(matrix[0])), glm::length(glm::vec3(matrix[1]))), glm::length(glm::vec3(matrix[2])));
+
+		return { glm::vec3(matrix * glm::vec4(Center, 1.0f)), Radius * scale };
+	}
+
+	Frustum::Frustum(const glm::mat4& viewProjection)
+	{
+		// Gribb / Hartmann plane extraction, glm matrices are column major
+		glm::vec4 row0 = { viewProjection[0][0], viewProjection[1][0], viewProjection[2][0], viewProjection[3][0] };
+		glm::vec4 row1 = { viewProjection[0][1], viewProjection[1][1], viewProjection[2][1], viewProjection[3][1] };
+		glm::vec4 row2 = { viewProjection[0][2], viewProjection[1][2], viewProjection[2][2], viewProjection[3][2] };
+		glm::vec4 row3 = { viewProjection[0][3], viewProjection[1][3], viewProjection[2][3], viewProjection[3][3] };
+
+		m_Planes[0] = row3 + row0; // Left
+		m_Planes[1] = row3 - row0; // Right
+		m_Planes[2] = row3 + row1; // Bottom
+		m_Planes[3] = row3 - row1; // Top
+		m_Planes[4] = row3 + row2; // Near
+		m_Planes[5] = row3 - row2; // Far
+
+		for (glm::vec4& plane : m_Planes)
+			plane /= glm::length(glm::vec3(plane));
+	}
+
+	bool Frustum::Intersects(const BoundingSphere& sphere) const
+	{
+		for (const glm::vec4& plane : m_Planes)
+		{
+			if (glm::dot(glm::vec3(plane), sphere.Center) + plane.w < -sphere.Radius)
+				return false;
+		}
+
+		return true;
+	}
+
+	bool Frustum::Intersects(const AABB& box) const
+	{
+		glm::vec3 center = box.GetCenter();
+		glm::vec3 extents = box.GetExtents();
+
+		for (const glm::vec4& plane : m_Planes)
+		{
+			// Projected radius of the box onto the plane normal
+			float radius = glm::dot(extents, glm::abs(glm::vec3(plane)));
+			if (glm::dot(glm::vec3(plane), center) + plane.w < -radius)
+				return false;
+		}
+
+		return true;
+	}
+
+	FrustumTest Frustum::Classify(const AABB& box) const
+	{
+		glm::vec3 center = box.GetCenter();
+		glm::vec3 extents = box.GetExtents();
+
+		FrustumTest result = FrustumTest::Inside;
+		for (const glm::vec4& plane : m_Planes)
+		{
+			float radius = glm::dot(extents, glm::abs(glm::vec3(plane)));
+			float distance = glm::dot(glm::vec3(plane), center) + plane.w;
+
+			if (distance < -radius)
+				return FrustumTest::Outside;
+			if (distance < radius)
+				result = FrustumTest::Intersecting;
+		}
+
+		return result;
+	}
+
+}
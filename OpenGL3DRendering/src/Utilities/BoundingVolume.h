@@ -0,0 +1,49 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+// Bounding volumes and view frustum used for visibility culling
+
+namespace OpenGLRendering {
+
+	struct AABB
+	{
+		glm::vec3 Min = glm::vec3(0.0f);
+		glm::vec3 Max = glm::vec3(0.0f);
+
+		glm::vec3 GetCenter() const { return (Min + Max) * 0.5f; }
+		glm::vec3 GetExtents() const { return (Max - Min) * 0.5f; }
+
+		void Merge(const AABB& other);
+		AABB Transform(const glm::mat4& matrix) const; // Box that encloses the transformed box
+	};
+
+	struct BoundingSphere
+	{
+		glm::vec3 Center = glm::vec3(0.0f);
+		float Radius = 0.0f;
+
+		BoundingSphere Transform(const glm::mat4& matrix) const; // Radius is scaled by the largest axis scale
+	};
+
+	enum class FrustumTest : uint8_t
+	{
+		Outside = 0, Intersecting, Inside
+	};
+
+	// Six planes (xyz: normal pointing inside, w: distance) extracted from a view projection matrix
+	class Frustum
+	{
+	public:
+		Frustum() = default;
+		Frustum(const glm::mat4& viewProjection);
+
+		bool Intersects(const BoundingSphere& sphere) const;
+		bool Intersects(const AABB& box) const;
+		FrustumTest Classify(const AABB& box) const; // Distinguishes fully contained boxes, used to accept whole subtrees
+
+	private:
+		glm::vec4 m_Planes[6];
+	};
+
+}
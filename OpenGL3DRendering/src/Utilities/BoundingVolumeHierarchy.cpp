@@ -0,0 +1,111 @@
+#include "oglpch.h"
+
+#include "BoundingVolumeHierarchy.h"
+
+namespace OpenGLRendering {
+
+	void BoundingVolumeHierarchy::Build(const std::vector<AABB>& localBounds)
+	{
+		m_LocalBounds = localBounds;
+		m_Nodes.clear();
+		m_Items.resize(localBounds.size());
+
+		for (uint32_t i = 0; i < (uint32_t)m_Items.size(); i++)
+			m_Items[i] = i;
+
+		if (m_Items.empty())
+			return;
+
+		m_Nodes.reserve(m_Items.size() * 2 - 1);
+		BuildRecursive(0, (uint32_t)m_Items.size());
+
+		Refit(glm::mat4(1.0f));
+	}
+
+	uint32_t BoundingVolumeHierarchy::BuildRecursive(uint32_t firstItem, uint32_t itemCount)
+	{
+		uint32_t nodeIndex = (uint32_t)m_Nodes.size();
+		m_Nodes.push_back({ {}, 0, firstItem, itemCount });
+
+		if (itemCount == 1)
+			return nodeIndex;
+
+		// Median split along the axis with the largest spread of the item centers
+		AABB centerBounds = { m_LocalBounds[m_Items[firstItem]].GetCenter(), m_LocalBounds[m_Items[firstItem]].GetCenter() };
+		for (uint32_t i = firstItem + 1; i < firstItem + itemCount; i++)
+		{
+			glm::vec3 center = m_LocalBounds[m_Items[i]].GetCenter();
+			centerBounds.Min = glm::min(centerBounds.Min, center);
+			centerBounds.Max = glm::max(centerBounds.Max, center);
+		}
+
+		glm::vec3 spread = centerBounds.Max - centerBounds.Min;
+		int axis = spread.x > spread.y ? (spread.x > spread.z ? 0 : 2) : (spread.y > spread.z ? 1 : 2);
+
+		uint32_t leftCount = itemCount / 2;
+		std::nth_element(m_Items.begin() + firstItem, m_Items.begin() + firstItem + leftCount, m_Items.begin() + firstItem + itemCount, [this, axis](uint32_t a, uint32_t b)
+		{
+			return m_LocalBounds[a].GetCenter()[axis] < m_LocalBounds[b].GetCenter()[axis];
+		});
+
+		BuildRecursive(firstItem, leftCount);
+		uint32_t rightChild = BuildRecursive(firstItem + leftCount, itemCount - leftCount);
+		m_Nodes[nodeIndex].RightChild = rightChild;
+
+		return nodeIndex;
+	}
+
+	void BoundingVolumeHierarchy::Refit(const glm::mat4& transform)
+	{
+		// Children are always stored after their parent, so a reverse sweep visits them first
+		for (uint32_t i = (uint32_t)m_Nodes.size(); i-- > 0;)
+		{
+			Node& node = m_Nodes[i];
+
+			if (node.RightChild)
+			{
+				node.Bounds = m_Nodes[i + 1].Bounds;
+				node.Bounds.Merge(m_Nodes[node.RightChild].Bounds);
+			}
+			else
+			{
+				node.Bounds = m_LocalBounds[m_Items[node.FirstItem]].Transform(transform);
+			}
+		}
+	}
+
+	uint32_t BoundingVolumeHierarchy::Query(const Frustum& frustum, std::vector<uint32_t>& visibleItems) const
+	{
+		if (m_Nodes.empty())
+			return 0;
+
+		uint32_t tests = 0;
+		uint32_t stack[64];
+		uint32_t stackSize = 0;
+		stack[stackSize++] = 0;
+
+		while (stackSize)
+		{
+			const Node& node = m_Nodes[stack[--stackSize]];
+
+			tests++;
+			FrustumTest test = frustum.Classify(node.Bounds);
+			if (test == FrustumTest::Outside)
+				continue;
+
+			if (test == FrustumTest::Inside || !node.RightChild)
+			{
+				visibleItems.insert(visibleItems.end(), m_Items.begin() + node.FirstItem, m_Items.begin() + node.FirstItem + node.ItemCount);
+				continue;
+			}
+
+			// Median splits keep the depth logarithmic, 64 entries are never reached
+			uint32_t nodeIndex = (uint32_t)(&node - m_Nodes.data());
+			stack[stackSize++] = node.RightChild;
+			stack[stackSize++] = nodeIndex + 1;
+		}
+
+		return tests;
+	}
+
+}
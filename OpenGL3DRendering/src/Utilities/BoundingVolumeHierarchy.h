@@ -0,0 +1,43 @@
+#pragma once
+
+#include <vector>
+
+#include "Utilities/BoundingVolume.h"
+
+// Bounding volume hierarchy over the meshes of a model, lets culling reject or accept whole groups of meshes with one test
+// The tree is built once from the local bounds, a transform change only refits the node bounds
+
+namespace OpenGLRendering {
+
+	class BoundingVolumeHierarchy
+	{
+	public:
+		void Build(const std::vector<AABB>& localBounds);
+		void Refit(const glm::mat4& transform);
+
+		// Appends the indices of all items that intersect the frustum, returns the number of bounds tests
+		uint32_t Query(const Frustum& frustum, std::vector<uint32_t>& visibleItems) const;
+
+		bool IsEmpty() const { return m_Nodes.empty(); }
+		uint32_t GetNodeCount() const { return (uint32_t)m_Nodes.size(); }
+
+	private:
+		uint32_t BuildRecursive(uint32_t firstItem, uint32_t itemCount);
+
+	private:
+		// Nodes are stored depth first: the left child directly follows its parent, leaves hold exactly one item
+		// Every node covers a contiguous range of m_Items, so a fully visible subtree is accepted without visiting it
+		struct Node
+		{
+			AABB Bounds; // World space after Refit
+			uint32_t RightChild; // 0 for leaves
+			uint32_t FirstItem;
+			uint32_t ItemCount;
+		};
+
+		std::vector<Node> m_Nodes;
+		std::vector<uint32_t> m_Items;
+		std::vector<AABB> m_LocalBounds;
+	};
+
+}
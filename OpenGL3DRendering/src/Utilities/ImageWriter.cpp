@@ -0,0 +1,120 @@
+#include "oglpch.h"
+
+#include "ImageWriter.h"
+
+namespace OpenGLRendering {
+
+	static uint32_t Crc32(const uint8_t* data, size_t size, uint32_t crc = 0)
+	{
+		static uint32_t s_Table[256] = {};
+		if (!s_Table[1])
+		{
+			for (uint32_t i = 0; i < 256; i++)
+			{
+				uint32_t value = i;
+				for (int bit = 0; bit < 8; bit++)
+					value = value & 1 ? 0xEDB88320u ^ (value >> 1) : value >> 1;
+				s_Table[i] = value;
+			}
+		}
+
+		crc = ~crc;
+		for (size_t i = 0; i < size; i++)
+			crc = s_Table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+
+		return ~crc;
+	}
+
+	static void PushBigEndian(std::vector<uint8_t>& buffer, uint32_t value)
+	{
+		buffer.push_back((uint8_t)(value >> 24));
+		buffer.push_back((uint8_t)(value >> 16));
+		buffer.push_back((uint8_t)(value >> 8));
+		buffer.push_back((uint8_t)value);
+	}
+
+	static void WriteChunk(std::ofstream& stream, const char* type, const std::vector<uint8_t>& data)
+	{
+		std::vector<uint8_t> header;
+		PushBigEndian(header, (uint32_t)data.size());
+		header.insert(header.end(), type, type + 4);
+		stream.write((const char*)header.data(), header.size());
+		stream.write((const char*)data.data(), data.size());
+
+		// The CRC covers the chunk type and data
+		uint32_t crc = Crc32((const uint8_t*)type, 4);
+		crc = Crc32(data.data(), data.size(), crc);
+
+		std::vector<uint8_t> footer;
+		PushBigEndian(footer, crc);
+		stream.write((const char*)footer.data(), footer.size());
+	}
+
+	bool ImageWriter::WritePNG(const std::string& filePath, uint32_t width, uint32_t height, const uint8_t* pixels, bool flipVertically)
+	{
+		OGL_PROFILE_FUNCTION();
+
+		std::ofstream stream(filePath, std::ios::binary);
+		if (!stream)
+		{
+			OGL_WARN("Couldn't write image {0}", filePath);
+			return false;
+		}
+
+		static const uint8_t s_Signature[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+		stream.write((const char*)s_Signature, sizeof(s_Signature));
+
+		std::vector<uint8_t> header;
+		PushBigEndian(header, width);
+		PushBigEndian(header, height);
+		header.insert(header.end(), { 8, 6, 0, 0, 0 }); // 8 bit RGBA, deflate, adaptive filtering, no interlacing
+		WriteChunk(stream, "IHDR", header);
+
+		// Every row starts with its filter type (0, none)
+		size_t rowSize = (size_t)width * 4;
+		std::vector<uint8_t> rows;
+		rows.reserve((rowSize + 1) * height);
+		for (uint32_t y = 0; y < height; y++)
+		{
+			const uint8_t* row = pixels + (flipVertically ? height - 1 - y : y) * rowSize;
+			rows.push_back(0);
+			rows.insert(rows.end(), row, row + rowSize);
+		}
+
+		// zlib stream of stored deflate blocks (at most 65535 bytes each) followed by the Adler-32 of the rows
+		std::vector<uint8_t> data;
+		data.reserve(rows.size() + rows.size() / 65535 * 5 + 16);
+		data.push_back(0x78);
+		data.push_back(0x01);
+
+		size_t offset = 0;
+		do
+		{
+			uint16_t blockSize = (uint16_t)std::min(rows.size() - offset, (size_t)65535);
+			bool lastBlock = offset + blockSize == rows.size();
+
+			data.push_back(lastBlock ? 1 : 0);
+			data.push_back((uint8_t)blockSize);
+			data.push_back((uint8_t)(blockSize >> 8));
+			data.push_back((uint8_t)~blockSize);
+			data.push_back((uint8_t)(~blockSize >> 8));
+			data.insert(data.end(), rows.begin() + offset, rows.begin() + offset + blockSize);
+
+			offset += blockSize;
+		} while (offset < rows.size());
+
+		uint32_t a = 1, b = 0;
+		for (uint8_t value : rows)
+		{
+			a = (a + value) % 65521;
+			b = (b + a) % 65521;
+		}
+		PushBigEndian(data, (b << 16) | a);
+
+		WriteChunk(stream, "IDAT", data);
+		WriteChunk(stream, "IEND", {});
+
+		return (bool)stream;
+	}
+
+}
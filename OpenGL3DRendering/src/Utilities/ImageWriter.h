@@ -0,0 +1,18 @@
+#pragma once
+
+#include <string>
+#include <stdint.h>
+
+// Writes images to disk, used for offline rendering
+
+namespace OpenGLRendering {
+
+	class ImageWriter
+	{
+	public:
+		// RGBA8 pixels, flipVertically for images read back from OpenGL (bottom row first)
+		// The image data is stored uncompressed (deflate stored blocks), the files are large but cheap to write
+		static bool WritePNG(const std::string& filePath, uint32_t width, uint32_t height, const uint8_t* pixels, bool flipVertically);
+	};
+
+}
@@ -2,47 +2,63 @@
 
 #include "Mesh.h"
 #include "Renderer/RendererAPI.h"
+#include "Renderer/Renderer.h"
 
 namespace OpenGLRendering {
 
-	Mesh::Mesh(const std::string& name, const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, const Ref<Material>& material, const glm::vec3& boundingBoxCenter, uint32_t vertexCount, uint32_t faceCount)
-		: m_Name(name), m_BoundingBoxCenter(boundingBoxCenter), m_Render(true), m_VertexCount(vertexCount), m_FaceCount(faceCount)
+	template<typename T>
+	static AABB CalculateBoundingBox(const T* vertices, uint32_t count)
 	{
+		if (!count)
+			return {};
+
+		AABB box = { vertices[0].Position, vertices[0].Position };
+		for (uint32_t i = 1; i < count; i++)
+		{
+			box.Min = glm::min(box.Min, vertices[i].Position);
+			box.Max = glm::max(box.Max, vertices[i].Position);
+		}
+
+		return box;
+	}
+
+	// Sphere around the box center that is tighter than the one around the box itself
+	template<typename T>
+	static BoundingSphere CalculateBoundingSphere(const T* vertices, uint32_t count, const AABB& box)
+	{
+		BoundingSphere sphere = { box.GetCenter(), 0.0f };
+		for (uint32_t i = 0; i < count; i++)
+			sphere.Radius = std::max(sphere.Radius, glm::length(vertices[i].Position - sphere.Center));
+
+		return sphere;
+	}
+
+	Mesh::Mesh(const std::string& name, const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, const Ref<Material>& material, const AABB& boundingBox, uint32_t vertexCount, uint32_t faceCount)
+		: m_Name(name), m_BoundingBox(boundingBox), m_Render(true), m_VertexCount(vertexCount), m_FaceCount(faceCount)
+	{
+		m_BoundingSphere = CalculateBoundingSphere(vertices.data(), (uint32_t)vertices.size(), m_BoundingBox);
+
 		Init(vertices, indices, material);
 	}
 
 	Mesh::Mesh(const std::string& name, const std::vector<SimpleVertex>& vertices, const std::vector<uint32_t>& indices, const Ref<Material>& material, uint32_t vertexCount, uint32_t faceCount)
 		: m_Name(name), m_Render(true), m_VertexCount(vertexCount), m_FaceCount(faceCount), m_Material(material)
 	{
-		m_VertexArray = CreateRef<VertexArray>();
-		Ref<VertexBuffer> vertexBuffer = CreateRef<VertexBuffer>((float*)&(vertices[0]), vertices.size() * sizeof(SimpleVertex));
-		vertexBuffer->SetLayout(
-		{
-			{ ShaderDataType::Float3, "a_Position" },
-			{ ShaderDataType::Float3, "a_Normal" },
-		});
-
-		Ref<IndexBuffer> indexBuffer = CreateRef<IndexBuffer>(&indices[0], indices.size());
+		m_BoundingBox = CalculateBoundingBox(vertices.data(), (uint32_t)vertices.size());
+		m_BoundingSphere = CalculateBoundingSphere(vertices.data(), (uint32_t)vertices.size(), m_BoundingBox);
 
-		m_VertexArray->AddVertexBuffer(vertexBuffer);
-		m_VertexArray->SetIndexBuffer(indexBuffer);
+		m_Arena = Renderer::GetGeometryArena(GeometryFormat::Simple);
+		m_Geometry = m_Arena->Allocate(&vertices[0], (uint32_t)vertices.size(), &indices[0], (uint32_t)indices.size());
 	}
 
 	Mesh::Mesh(const std::string& name, SimpleVertex* vertices, uint32_t* indices, const Ref<Material>& material, uint32_t vertexCount, uint32_t faceCount)
 		: m_Name(name), m_Render(true), m_VertexCount(vertexCount), m_FaceCount(faceCount), m_Material(material)
 	{
-		m_VertexArray = CreateRef<VertexArray>();
-		Ref<VertexBuffer> vertexBuffer = CreateRef<VertexBuffer>((float*)vertices, vertexCount * sizeof(SimpleVertex));
-		vertexBuffer->SetLayout(
-			{
-				{ ShaderDataType::Float3, "a_Position" },
-				{ ShaderDataType::Float3, "a_Normal" },
-			});
-
-		Ref<IndexBuffer> indexBuffer = CreateRef<IndexBuffer>(indices, faceCount * 3);
-
-		m_VertexArray->AddVertexBuffer(vertexBuffer);
-		m_VertexArray->SetIndexBuffer(indexBuffer);
+		m_BoundingBox = CalculateBoundingBox(vertices, vertexCount);
+		m_BoundingSphere = CalculateBoundingSphere(vertices, vertexCount, m_BoundingBox);
+
+		m_Arena = Renderer::GetGeometryArena(GeometryFormat::Simple);
+		m_Geometry = m_Arena->Allocate(vertices, vertexCount, indices, faceCount * 3);
 	}
 
 	Mesh::~Mesh()
@@ -54,22 +70,8 @@ namespace OpenGLRendering {
 	{
 		m_Material = material;
 
-		m_VertexArray = CreateRef<VertexArray>();
-
-		Ref<VertexBuffer> vertexBuffer = CreateRef<VertexBuffer>((float*)&(vertices[0]), vertices.size() * sizeof(Vertex));
-		vertexBuffer->SetLayout(
-			{
-				{ ShaderDataType::Float3, "a_Position" },
-				{ ShaderDataType::Float3, "a_Normal" },
-				{ ShaderDataType::Float2, "a_TextureCoords" },
-				{ ShaderDataType::Float3, "a_Tangent" },
-				{ ShaderDataType::Float3, "a_Bitangent" }
-			});
-
-		Ref<IndexBuffer> indexBuffer = CreateRef<IndexBuffer>(&indices[0], indices.size());
-
-		m_VertexArray->AddVertexBuffer(vertexBuffer);
-		m_VertexArray->SetIndexBuffer(indexBuffer);
+		m_Arena = Renderer::GetGeometryArena(GeometryFormat::Textured);
+		m_Geometry = m_Arena->Allocate(&vertices[0], (uint32_t)vertices.size(), &indices[0], (uint32_t)indices.size());
 	}
 
 }
\ No newline at end of file
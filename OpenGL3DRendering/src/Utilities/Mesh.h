@@ -4,8 +4,10 @@
 
 #include "Renderer/Texture.h"
 #include "Renderer/VertexArray.h"
+#include "Renderer/GeometryArena.h"
 #include "Renderer/Shader.h"
 #include "Renderer/Material.h"
+#include "Utilities/BoundingVolume.h"
 
 #include "Core/Core.h"
 
@@ -29,15 +31,20 @@ namespace OpenGLRendering {
 	class Mesh
 	{
 	public:
-		Mesh(const std::string& name, const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, const Ref<Material>& material, const glm::vec3& boundingBoxCenter, uint32_t vertexCount = 0, uint32_t faceCount = 0);
+		Mesh(const std::string& name, const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, const Ref<Material>& material, const AABB& boundingBox, uint32_t vertexCount = 0, uint32_t faceCount = 0);
 		Mesh(const std::string& name, const std::vector<SimpleVertex>& vertices, const std::vector<uint32_t>& indices, const Ref<Material>& material, uint32_t vertexCount = 0, uint32_t faceCoount = 0);
 		Mesh(const std::string& name, SimpleVertex* vertices, uint32_t* indices, const Ref<Material>& material, uint32_t vertexCount, uint32_t faceCount);
 		~Mesh();
 
 		const std::string& GetName() const { return m_Name; }
 		const Ref<Material>& GetMaterial() const { return m_Material; }
-		const Ref<VertexArray>& GetVertexArray() const { return m_VertexArray; }
-		const glm::vec3& GetBoundingBoxCenter() const { return m_BoundingBoxCenter; }
+		const Ref<VertexArray>& GetVertexArray() const { return m_Arena->GetVertexArray(); }
+		const Ref<VertexArray>& GetPositionVertexArray() const { return m_Arena->GetPositionVertexArray(); } // Depth only passes
+		const GeometryRange& GetGeometry() const { return m_Geometry; }
+		GeometryFormat GetGeometryFormat() const { return m_Arena->GetFormat(); }
+		glm::vec3 GetBoundingBoxCenter() const { return m_BoundingBox.GetCenter(); }
+		const AABB& GetBoundingBox() const { return m_BoundingBox; } // Local space
+		const BoundingSphere& GetBoundingSphere() const { return m_BoundingSphere; } // Local space
 
 		bool& IsRendering() { return m_Render; }
 
@@ -50,9 +57,11 @@ namespace OpenGLRendering {
 		void Init(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, const Ref<Material>& material);
 	private:
 		std::string m_Name;
-		Ref<VertexArray> m_VertexArray;
+		Ref<GeometryArena> m_Arena; // Shared by all meshes with the same vertex format, owned by the renderer
+		GeometryRange m_Geometry;
 		Ref<Material> m_Material;
-		glm::vec3 m_BoundingBoxCenter;
+		AABB m_BoundingBox;
+		BoundingSphere m_BoundingSphere;
 		bool m_Render;
 
 		uint32_t m_VertexCount;
@@ -66,7 +66,7 @@ namespace OpenGLRendering {
 
 
 	Model::Model(const std::string& filePath, bool flipUVs)
-		: m_Orientation(0.0f, 0.0f, 0.0f, 1.0f)
+		: m_ModelMatrix(1.0f), m_Orientation(0.0f, 0.0f, 0.0f, 1.0f)
 	{
 		LoadModel(filePath, flipUVs);
 	}
@@ -75,6 +75,8 @@ namespace OpenGLRendering {
 
 	void Model::LoadModel(const std::string& filePath, bool flipUVs)
 	{
+		OGL_PROFILE_FUNCTION();
+
 		Assimp::Importer importer;
 
 		const aiScene* scene = importer.ReadFile(filePath.c_str(), flipUVs ? (aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_JoinIdenticalVertices | aiProcess_CalcTangentSpace | aiProcess_FlipUVs) : (aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_JoinIdenticalVertices | aiProcess_CalcTangentSpace));
@@ -85,21 +87,215 @@ namespace OpenGLRendering {
 			return;
 		}
 
-		ProcessNode(scene->mRootNode, scene);
+		std::vector<ImportedLod> meshLods;
+		ProcessNode(scene->mRootNode, scene, { "", 0 }, meshLods);
+		BuildLodGroups(meshLods);
+	}
+
+	// Splits names like "Barrel_LOD2" into "Barrel" and 2 (case insensitive)
+	static bool ParseLodSuffix(const std::string& name, std::string& base, uint32_t& level)
+	{
+		std::string lower = name;
+		std::transform(lower.begin(), lower.end(), lower.begin(), [](char c) { return (char)std::tolower((unsigned char)c); });
+
+		size_t position = lower.rfind("_lod");
+		if (position == std::string::npos)
+			return false;
+
+		size_t digits = position + 4;
+		size_t end = digits;
+		while (end < lower.size() && std::isdigit((unsigned char)lower[end]))
+			end++;
+
+		if (end == digits)
+			return false;
+
+		base = name.substr(0, position);
+		level = (uint32_t)std::stoul(name.substr(digits, end - digits));
+		return true;
+	}
+
+	static bool IsLodGroupNode(const std::string& name)
+	{
+		std::string lower = name;
+		std::transform(lower.begin(), lower.end(), lower.begin(), [](char c) { return (char)std::tolower((unsigned char)c); });
+
+		return lower.find("lodgroup") != std::string::npos || lower.find("lod_group") != std::string::npos;
 	}
 
-	void Model::ProcessNode(aiNode* node, const aiScene* scene)
+	void Model::ProcessNode(aiNode* node, const aiScene* scene, const ImportedLod& parentLod, std::vector<ImportedLod>& meshLods)
 	{
+		// An explicit _LODn suffix on the node wins over the level inherited from a LOD group node
+		ImportedLod lod = parentLod;
+		std::string base;
+		uint32_t level;
+		if (ParseLodSuffix(node->mName.C_Str(), base, level))
+			lod = { parentLod.Group.empty() ? base : parentLod.Group, level };
+
 		for (unsigned int i = 0; i < node->mNumMeshes; i++)
 		{
 			aiMesh* mesh = scene->mMeshes[node->mMeshes[i]];
 			m_Meshes.push_back(ProcessMesh(mesh, scene));
+
+			ImportedLod meshLod = lod;
+			if (meshLod.Group.empty() && ParseLodSuffix(mesh->mName.C_Str(), base, level))
+				meshLod = { base, level };
+
+			meshLods.push_back(meshLod);
 		}
 
+		// The children of a LOD group node (FBX LODGroup) are the levels in order
+		bool lodGroup = IsLodGroupNode(node->mName.C_Str());
+
 		for (unsigned int i = 0; i < node->mNumChildren; i++)
 		{
-			ProcessNode(node->mChildren[i], scene);
+			if (lodGroup)
+				ProcessNode(node->mChildren[i], scene, { node->mName.C_Str(), i }, meshLods);
+			else
+				ProcessNode(node->mChildren[i], scene, lod, meshLods);
+		}
+	}
+
+	void Model::BuildLodGroups(const std::vector<ImportedLod>& meshLods)
+	{
+		OGL_PROFILE_FUNCTION();
+
+		// Assign every mesh to a group, meshes without LOD get a group of their own
+		std::vector<uint32_t> meshGroups(m_Meshes.size());
+		std::unordered_map<std::string, uint32_t> groupIndices;
+		uint32_t groupCount = 0;
+
+		for (uint32_t i = 0; i < (uint32_t)m_Meshes.size(); i++)
+		{
+			if (meshLods[i].Group.empty())
+			{
+				meshGroups[i] = groupCount++;
+				continue;
+			}
+
+			auto it = groupIndices.find(meshLods[i].Group);
+			if (it == groupIndices.end())
+				it = groupIndices.insert({ meshLods[i].Group, groupCount++ }).first;
+
+			meshGroups[i] = it->second;
+		}
+
+		// Reorder the meshes so that every level of every group is contiguous, the import order is kept otherwise
+		std::vector<uint32_t> order(m_Meshes.size());
+		for (uint32_t i = 0; i < (uint32_t)order.size(); i++)
+			order[i] = i;
+
+		std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b)
+		{
+			if (meshGroups[a] != meshGroups[b])
+				return meshGroups[a] < meshGroups[b];
+
+			return meshLods[a].Level < meshLods[b].Level;
+		});
+
+		std::vector<Mesh> meshes;
+		meshes.reserve(m_Meshes.size());
+		m_LodGroups.clear();
+		m_LodGroups.resize(groupCount);
+
+		for (uint32_t index : order)
+		{
+			LodGroup& group = m_LodGroups[meshGroups[index]];
+			if (group.Levels.empty())
+				group.Name = meshLods[index].Group.empty() ? m_Meshes[index].GetName() : meshLods[index].Group;
+
+			// Missing levels in the source file are skipped, levels are renumbered consecutively
+			if (group.Levels.empty() || meshLods[index].Level != meshLods[order[group.Levels.back().FirstMesh]].Level)
+				group.Levels.push_back({ (uint32_t)meshes.size(), 0 });
+
+			group.Levels.back().MeshCount++;
+			meshes.push_back(m_Meshes[index]);
+		}
+
+		m_Meshes = std::move(meshes);
+
+		uint32_t lodGroupCount = 0;
+		for (const LodGroup& group : m_LodGroups)
+			lodGroupCount += group.Levels.size() > 1 ? 1 : 0;
+
+		if (lodGroupCount)
+			OGL_INFO("Model contains {0} LOD groups", lodGroupCount);
+
+		UpdateLodGroupBounds();
+	}
+
+	void Model::UpdateLodGroupBounds()
+	{
+		std::vector<AABB> bounds;
+		bounds.reserve(m_LodGroups.size());
+		m_SelectedMeshCount = 0;
+
+		for (LodGroup& group : m_LodGroups)
+		{
+			const LodLevel& first = group.Levels.front();
+			group.Bounds = m_Meshes[first.FirstMesh].GetBoundingBox();
+
+			for (const LodLevel& level : group.Levels)
+			{
+				for (uint32_t i = level.FirstMesh; i < level.FirstMesh + level.MeshCount; i++)
+					group.Bounds.Merge(m_Meshes[i].GetBoundingBox());
+			}
+
+			group.Sphere = { group.Bounds.GetCenter(), 0.0f };
+			for (const LodLevel& level : group.Levels)
+			{
+				for (uint32_t i = level.FirstMesh; i < level.FirstMesh + level.MeshCount; i++)
+				{
+					const BoundingSphere& sphere = m_Meshes[i].GetBoundingSphere();
+					group.Sphere.Radius = std::max(group.Sphere.Radius, glm::length(sphere.Center - group.Sphere.Center) + sphere.Radius);
+				}
+			}
+
+			group.CurrentLevel = 0;
+			m_SelectedMeshCount += first.MeshCount;
+			bounds.push_back(group.Bounds);
 		}
+
+		m_BoundingVolumeHierarchy.Build(bounds);
+		m_BoundingVolumeHierarchy.Refit(m_ModelMatrix);
+	}
+
+	bool Model::HasLodGroups() const
+	{
+		for (const LodGroup& group : m_LodGroups)
+		{
+			if (group.Levels.size() > 1)
+				return true;
+		}
+
+		return false;
+	}
+
+	void Model::SelectLodLevel(uint32_t group, uint32_t level)
+	{
+		LodGroup& lodGroup = m_LodGroups[group];
+		if (lodGroup.CurrentLevel == level)
+			return;
+
+		m_SelectedMeshCount -= lodGroup.Levels[lodGroup.CurrentLevel].MeshCount;
+		m_SelectedMeshCount += lodGroup.Levels[level].MeshCount;
+		lodGroup.CurrentLevel = level;
+	}
+
+	void Model::SetLodLevels(uint32_t meshesPerLevel)
+	{
+		OGL_ASSERT(meshesPerLevel, "A LOD level needs at least one mesh");
+
+		LodGroup group;
+		group.Name = "Model";
+		for (uint32_t first = 0; first < (uint32_t)m_Meshes.size(); first += meshesPerLevel)
+			group.Levels.push_back({ first, std::min(meshesPerLevel, (uint32_t)m_Meshes.size() - first) });
+
+		m_LodGroups.clear();
+		if (!group.Levels.empty())
+			m_LodGroups.push_back(group);
+
+		UpdateLodGroupBounds();
 	}
 
 	Mesh Model::ProcessMesh(aiMesh* mesh, const aiScene* scene)
@@ -108,7 +304,9 @@ namespace OpenGLRendering {
 		std::vector<uint32_t> indices;
 		// std::vector<Ref<Texture2D>> textures;
 
-		float xMin = 0.0f, xMax = 0.0f, yMin = 0.0f, yMax = 0.0f, zMin = 0.0f, zMax = 0.0f;
+		AABB boundingBox;
+		if (mesh->mNumVertices)
+			boundingBox = { { mesh->mVertices[0].x, mesh->mVertices[0].y, mesh->mVertices[0].z }, { mesh->mVertices[0].x, mesh->mVertices[0].y, mesh->mVertices[0].z } };
 
 		std::string meshName(mesh->mName.C_Str());
 
@@ -119,33 +317,9 @@ namespace OpenGLRendering {
 		{
 			Vertex vertex;
 
-			if (mesh->mVertices[i].x > xMax)
-			{
-				xMax = mesh->mVertices[i].x;
-			}
-			if (mesh->mVertices[i].x < xMin)
-			{
-				xMin = mesh->mVertices[i].x;
-			}
-			if (mesh->mVertices[i].y > yMax)
-			{
-				yMax = mesh->mVertices[i].y;
-			}
-			if (mesh->mVertices[i].y < yMin)
-			{
-				yMin = mesh->mVertices[i].y;
-			}
-			if (mesh->mVertices[i].z > zMax)
-			{
-				zMax = mesh->mVertices[i].z;
-			}
-			if (mesh->mVertices[i].z < zMin)
-			{
-				zMin = mesh->mVertices[i].z;
-			}
-
-
 			vertex.Position = { mesh->mVertices[i].x, mesh->mVertices[i].y, mesh->mVertices[i].z };
+			boundingBox.Min = glm::min(boundingBox.Min, vertex.Position);
+			boundingBox.Max = glm::max(boundingBox.Max, vertex.Position);
 			vertex.Normal = { mesh->mNormals[i].x, mesh->mNormals[i].y, mesh->mNormals[i].z };
 				
 			if (mesh->mTextureCoords[0])
@@ -196,9 +370,7 @@ namespace OpenGLRendering {
 		Ref<Material> mat = CreateRef<Material>();
 		mat->SetAlbedo(baseColor);
 
-		glm::vec3 boundingBoxCenter = { (xMin + xMax) / 2.0f, (yMin + yMax) / 2.0f, (zMin + zMax) / 2.0f };
-
-		return { meshName, vertices, indices, mat, boundingBoxCenter, (uint32_t)vertices.size(), (uint32_t)(indices.size() / 3) };
+		return { meshName, vertices, indices, mat, boundingBox, (uint32_t)vertices.size(), (uint32_t)(indices.size() / 3) };
 	}
 
 	std::vector<Ref<Texture2D>> Model::LoadMaterialTextures(aiMaterial* material, aiTextureType type, const aiScene* scene)
@@ -254,7 +426,12 @@ namespace OpenGLRendering {
 		glm::mat4 m_RotationMatrix = glm::toMat4(m_Orientation); // Parse quaternion to 4x4 matrix for building the model matrix.
 		glm::mat4 m_ScaleMatrix = glm::scale(glm::mat4(1.0f), m_Scale);
 
-		m_ModelMatrix = m_TranslationMatrix * m_RotationMatrix * m_ScaleMatrix;
+		glm::mat4 modelMatrix = m_TranslationMatrix * m_RotationMatrix * m_ScaleMatrix;
+		if (modelMatrix == m_ModelMatrix)
+			return;
+
+		m_ModelMatrix = modelMatrix;
+		m_BoundingVolumeHierarchy.Refit(m_ModelMatrix);
 	}
 
 }
\ No newline at end of file
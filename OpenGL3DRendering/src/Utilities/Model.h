@@ -7,6 +7,7 @@
 
 #include "Core/Core.h"
 #include "Mesh.h"
+#include "BoundingVolumeHierarchy.h"
 #include "Renderer/Shader.h"
 
 #include <glm/glm.hpp>
@@ -14,6 +15,25 @@
 
 namespace OpenGLRendering {
 
+	// Meshes of one level of detail, stored contiguously in the mesh list of the model
+	struct LodLevel
+	{
+		uint32_t FirstMesh;
+		uint32_t MeshCount;
+	};
+
+	// Alternative representations of one object, level 0 is the most detailed one
+	// Meshes that are not part of a LOD group in the source file form a group with a single level
+	struct LodGroup
+	{
+		std::string Name;
+		std::vector<LodLevel> Levels;
+		AABB Bounds; // Local space, covers all levels
+		BoundingSphere Sphere;
+
+		uint32_t CurrentLevel = 0; // Selection of the last frame, needed for hysteresis
+	};
+
 	class Model
 	{
 	public:
@@ -23,6 +43,15 @@ namespace OpenGLRendering {
 		const std::vector<Mesh>& GetMeshes() const { return m_Meshes; }
 		std::vector<Mesh>& GetMeshes() { return m_Meshes; }
 		const glm::mat4& GetModelMatrix() const { return m_ModelMatrix; }
+		const BoundingVolumeHierarchy& GetBoundingVolumeHierarchy() const { return m_BoundingVolumeHierarchy; } // World space, items are LOD groups
+
+		const std::vector<LodGroup>& GetLodGroups() const { return m_LodGroups; }
+		bool HasLodGroups() const; // True if any group has more than one level
+		uint32_t GetSelectedMeshCount() const { return m_SelectedMeshCount; } // Meshes of the currently selected levels
+		void SelectLodLevel(uint32_t group, uint32_t level);
+
+		// For files without LOD naming: treats the meshes as one group with consecutive blocks of meshesPerLevel meshes per level
+		void SetLodLevels(uint32_t meshesPerLevel);
 
 		void SetTranslation(const glm::vec3& translation);
 		void SetRotation(const glm::vec3& rotation);
@@ -30,8 +59,17 @@ namespace OpenGLRendering {
 		void CalculateModelMatrix();
 
 	private:
+		// LOD group and level of an imported mesh, an empty group means the mesh has no LOD
+		struct ImportedLod
+		{
+			std::string Group;
+			uint32_t Level;
+		};
+
 		void LoadModel(const std::string& filePath, bool flipUVs);
-		void ProcessNode(aiNode* node, const aiScene* scene);
+		void ProcessNode(aiNode* node, const aiScene* scene, const ImportedLod& parentLod, std::vector<ImportedLod>& meshLods);
+		void BuildLodGroups(const std::vector<ImportedLod>& meshLods);
+		void UpdateLodGroupBounds();
 		Mesh ProcessMesh(aiMesh* mesh, const aiScene* scene);
 		std::vector<Ref<Texture2D>> LoadMaterialTextures(aiMaterial* mat, aiTextureType type, const aiScene* scene);
 
@@ -39,6 +77,9 @@ namespace OpenGLRendering {
 
 	private:
 		std::vector<Mesh> m_Meshes;
+		BoundingVolumeHierarchy m_BoundingVolumeHierarchy;
+		std::vector<LodGroup> m_LodGroups;
+		uint32_t m_SelectedMeshCount = 0;
 
 		glm::mat4 m_ModelMatrix;
 
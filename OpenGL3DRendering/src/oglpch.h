@@ -17,4 +17,5 @@
 #include <unordered_set>
 
 #include "Core/Core.h"
-#include "Core/Log.h"
\ No newline at end of file
+#include "Core/Log.h"
+#include "Core/Profiler.h"
\ No newline at end of file
@@ -75,6 +75,14 @@ project "OpenGL3DRendering"
 	filter "system:windows"
 		systemversion "latest"
 
+	-- The configurations below link the prebuilt Windows libraries, the project is only configured for Windows
+	-- There Core/HeadlessContext uses its hidden GLFW window, the EGL path needs a Linux build with its own dependencies
+	filter "system:linux"
+		links
+		{
+			"EGL" -- Headless rendering (Core/HeadlessContext)
+		}
+
 	filter "configurations:Debug"
 		defines "OGL_DEBUG"
 		runtime "Debug"